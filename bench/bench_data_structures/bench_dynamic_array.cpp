@@ -0,0 +1,105 @@
+#include <cstdint>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "data_structures/dynamic_array.hpp"
+
+/*******************************************************************************
+Measures appending to, inserting into, removing from and iterating over a
+Dynamic_Array, with std::vector doing the same work as a reference point.
+*******************************************************************************/
+
+namespace {
+
+void BM_DynamicArrayPushBack(benchmark::State& state) {
+  for (auto _ : state) {
+    Dynamic_Array<uint64_t> array;
+    for (int64_t i = 0; i < state.range(0); i++) {
+      array.push_back(i);
+    }
+    benchmark::DoNotOptimize(array.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_VectorPushBack(benchmark::State& state) {
+  for (auto _ : state) {
+    std::vector<uint64_t> vector;
+    for (int64_t i = 0; i < state.range(0); i++) {
+      vector.push_back(i);
+    }
+    benchmark::DoNotOptimize(vector.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Every insert shifts the whole array, so the sizes are kept small.
+void BM_DynamicArrayInsertFront(benchmark::State& state) {
+  for (auto _ : state) {
+    Dynamic_Array<uint64_t> array;
+    for (int64_t i = 0; i < state.range(0); i++) {
+      array.insert(i, 0);
+    }
+    benchmark::DoNotOptimize(array.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_DynamicArrayRemoveFront(benchmark::State& state) {
+  Dynamic_Array<uint64_t> full;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    full.push_back(i);
+  }
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    Dynamic_Array<uint64_t> array(full);
+    state.ResumeTiming();
+    for (int64_t i = 0; i < state.range(0); i++) {
+      array.remove(0);
+    }
+    benchmark::DoNotOptimize(array.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_DynamicArrayIterate(benchmark::State& state) {
+  Dynamic_Array<uint64_t> array;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    array.push_back(i);
+  }
+
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (uint64_t value : array) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_DynamicArrayIndex(benchmark::State& state) {
+  Dynamic_Array<uint64_t> array;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    array.push_back(i);
+  }
+
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (int i = 0; i <= array.get_maximum_index(); i++) {
+      sum += array[i];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+BENCHMARK(BM_DynamicArrayPushBack)->Range(16, 1 << 20);
+BENCHMARK(BM_VectorPushBack)->Range(16, 1 << 20);
+BENCHMARK(BM_DynamicArrayInsertFront)->Range(16, 1 << 12);
+BENCHMARK(BM_DynamicArrayRemoveFront)->Range(16, 1 << 12);
+BENCHMARK(BM_DynamicArrayIterate)->Range(16, 1 << 20);
+BENCHMARK(BM_DynamicArrayIndex)->Range(16, 1 << 20);
@@ -0,0 +1,198 @@
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "bench_data_structures/chained_hash_table.hpp"
+#include "benchmark/benchmark.h"
+#include "data_structures/hash_table.hpp"
+
+/*******************************************************************************
+Compares the open-addressing Hash_Table against the chained design it replaced
+and std::unordered_map. The adapters below give the three tables a common
+interface.
+*******************************************************************************/
+
+namespace {
+
+template <typename K, typename V>
+void table_insert(Hash_Table<K, V>& table, const K& key, const V& value) {
+  table.insert(key, value);
+}
+
+template <typename K, typename V>
+bool table_contains(Hash_Table<K, V>& table, const K& key) {
+  return table.search(key) != nullptr;
+}
+
+template <typename K, typename V>
+void table_remove(Hash_Table<K, V>& table, const K& key) {
+  table.remove(key);
+}
+
+template <typename K, typename V>
+void table_insert(Chained_Hash_Table<K, V>& table, const K& key,
+                  const V& value) {
+  table.insert(key, value);
+}
+
+template <typename K, typename V>
+bool table_contains(Chained_Hash_Table<K, V>& table, const K& key) {
+  V* value = table.search(key);
+  delete value;
+  return value != nullptr;
+}
+
+template <typename K, typename V>
+void table_remove(Chained_Hash_Table<K, V>& table, const K& key) {
+  table.remove(key);
+}
+
+template <typename K, typename V>
+void table_insert(std::unordered_map<K, V>& table, const K& key,
+                  const V& value) {
+  table.emplace(key, value);
+}
+
+template <typename K, typename V>
+bool table_contains(std::unordered_map<K, V>& table, const K& key) {
+  return table.find(key) != table.end();
+}
+
+template <typename K, typename V>
+void table_remove(std::unordered_map<K, V>& table, const K& key) {
+  table.erase(key);
+}
+
+// Keys are generated from a fixed seed so every table sees the same input.
+template <typename K>
+K make_key(std::mt19937_64& rng);
+
+template <>
+uint64_t make_key<uint64_t>(std::mt19937_64& rng) {
+  return rng();
+}
+
+template <>
+std::string make_key<std::string>(std::mt19937_64& rng) {
+  // Identifier-like keys of 3 to 16 characters.
+  static const char ALPHABET[] =
+      "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789";
+  std::size_t length = 3 + (rng() % 14);
+  std::string key;
+  for (std::size_t i = 0; i < length; i++) {
+    key += ALPHABET[rng() % (sizeof(ALPHABET) - 1)];
+  }
+  return key;
+}
+
+template <typename K>
+std::vector<K> make_keys(std::size_t count, uint64_t seed) {
+  std::mt19937_64 rng(seed);
+  std::vector<K> keys;
+  keys.reserve(count);
+  for (std::size_t i = 0; i < count; i++) {
+    keys.push_back(make_key<K>(rng));
+  }
+  return keys;
+}
+
+template <typename Table, typename K>
+void BM_Insert(benchmark::State& state) {
+  std::vector<K> keys = make_keys<K>(state.range(0), 1);
+
+  for (auto _ : state) {
+    Table table;
+    for (const K& key : keys) {
+      table_insert(table, key, 1);
+    }
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Table, typename K>
+void BM_SearchHit(benchmark::State& state) {
+  std::vector<K> keys = make_keys<K>(state.range(0), 1);
+
+  Table table;
+  for (const K& key : keys) {
+    table_insert(table, key, 1);
+  }
+
+  for (auto _ : state) {
+    for (const K& key : keys) {
+      bool found = table_contains(table, key);
+      benchmark::DoNotOptimize(found);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Table, typename K>
+void BM_SearchMiss(benchmark::State& state) {
+  std::vector<K> keys = make_keys<K>(state.range(0), 1);
+  std::vector<K> missing_keys = make_keys<K>(state.range(0), 2);
+
+  Table table;
+  for (const K& key : keys) {
+    table_insert(table, key, 1);
+  }
+
+  for (auto _ : state) {
+    for (const K& key : missing_keys) {
+      bool found = table_contains(table, key);
+      benchmark::DoNotOptimize(found);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations() * missing_keys.size());
+}
+
+/* Removes every key and puts it straight back, so the table stays the same
+size from one iteration to the next and no untimed rebuild is needed. */
+template <typename Table, typename K>
+void BM_Remove(benchmark::State& state) {
+  std::vector<K> keys = make_keys<K>(state.range(0), 1);
+
+  Table table;
+  for (const K& key : keys) {
+    table_insert(table, key, 1);
+  }
+
+  for (auto _ : state) {
+    for (const K& key : keys) {
+      table_remove(table, key);
+      table_insert(table, key, 1);
+    }
+    benchmark::ClobberMemory();
+  }
+
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+}  // namespace
+
+#define HASH_TABLE_BENCHMARKS(K)                                           \
+  BENCHMARK(BM_Insert<Hash_Table<K, int>, K>)->Range(16, 1 << 16);         \
+  BENCHMARK(BM_Insert<Chained_Hash_Table<K, int>, K>)->Range(16, 1 << 16); \
+  BENCHMARK(BM_Insert<std::unordered_map<K, int>, K>)->Range(16, 1 << 16); \
+  BENCHMARK(BM_SearchHit<Hash_Table<K, int>, K>)->Range(16, 1 << 16);      \
+  BENCHMARK(BM_SearchHit<Chained_Hash_Table<K, int>, K>)                   \
+      ->Range(16, 1 << 16);                                                \
+  BENCHMARK(BM_SearchHit<std::unordered_map<K, int>, K>)                   \
+      ->Range(16, 1 << 16);                                                \
+  BENCHMARK(BM_SearchMiss<Hash_Table<K, int>, K>)->Range(16, 1 << 16);     \
+  BENCHMARK(BM_SearchMiss<Chained_Hash_Table<K, int>, K>)                  \
+      ->Range(16, 1 << 16);                                                \
+  BENCHMARK(BM_SearchMiss<std::unordered_map<K, int>, K>)                  \
+      ->Range(16, 1 << 16);                                                \
+  BENCHMARK(BM_Remove<Hash_Table<K, int>, K>)->Range(16, 1 << 16);         \
+  BENCHMARK(BM_Remove<Chained_Hash_Table<K, int>, K>)->Range(16, 1 << 16); \
+  BENCHMARK(BM_Remove<std::unordered_map<K, int>, K>)->Range(16, 1 << 16)
+
+HASH_TABLE_BENCHMARKS(uint64_t);
+HASH_TABLE_BENCHMARKS(std::string);
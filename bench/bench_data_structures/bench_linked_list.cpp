@@ -0,0 +1,90 @@
+#include <cstdint>
+#include <list>
+
+#include "benchmark/benchmark.h"
+#include "data_structures/linked_list.hpp"
+
+/*******************************************************************************
+Measures building and traversing a Linked_List, with std::list as a reference
+point. Traversal by index walks the list for every element and is only run on
+short lists, to show what iterating does instead.
+*******************************************************************************/
+
+namespace {
+
+Linked_List<uint64_t> make_list(int64_t length) {
+  Linked_List<uint64_t> list;
+  for (int64_t i = 0; i < length; i++) {
+    list.insert(i);
+  }
+  return list;
+}
+
+void BM_LinkedListInsert(benchmark::State& state) {
+  for (auto _ : state) {
+    Linked_List<uint64_t> list = make_list(state.range(0));
+    benchmark::DoNotOptimize(list.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_StdListInsert(benchmark::State& state) {
+  for (auto _ : state) {
+    std::list<uint64_t> list;
+    for (int64_t i = 0; i < state.range(0); i++) {
+      list.push_back(i);
+    }
+    benchmark::DoNotOptimize(list.begin());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_LinkedListTraverse(benchmark::State& state) {
+  Linked_List<uint64_t> list = make_list(state.range(0));
+
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (uint64_t value : list) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_LinkedListTraverseByIndex(benchmark::State& state) {
+  Linked_List<uint64_t> list = make_list(state.range(0));
+
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (std::size_t i = 0; i < list.get_size(); i++) {
+      sum += list[i];
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_StdListTraverse(benchmark::State& state) {
+  std::list<uint64_t> list;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    list.push_back(i);
+  }
+
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (uint64_t value : list) {
+      sum += value;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+BENCHMARK(BM_LinkedListInsert)->Range(16, 1 << 18);
+BENCHMARK(BM_StdListInsert)->Range(16, 1 << 18);
+BENCHMARK(BM_LinkedListTraverse)->Range(16, 1 << 18);
+BENCHMARK(BM_LinkedListTraverseByIndex)->Range(16, 1 << 10);
+BENCHMARK(BM_StdListTraverse)->Range(16, 1 << 18);
@@ -0,0 +1,49 @@
+#include <memory>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "memory/arena.hpp"
+
+/*******************************************************************************
+Compares allocating and freeing many small objects, the pattern of tree and
+list nodes, from an Arena against the global heap.
+*******************************************************************************/
+
+namespace {
+
+struct Node {
+  Node* left;
+  Node* right;
+  double value;
+};
+
+void BM_NodesHeap(benchmark::State& state) {
+  std::vector<Node*> nodes(state.range(0));
+  for (auto _ : state) {
+    for (Node*& node : nodes) {
+      node = new Node{nullptr, nullptr, 1.0};
+    }
+    benchmark::DoNotOptimize(nodes.data());
+    for (Node* node : nodes) {
+      delete node;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_NodesHeap)->Range(1 << 10, 1 << 18);
+
+void BM_NodesArena(benchmark::State& state) {
+  std::vector<Node*> nodes(state.range(0));
+  Arena arena;
+  for (auto _ : state) {
+    for (Node*& node : nodes) {
+      node = arena.create<Node>(nullptr, nullptr, 1.0);
+    }
+    benchmark::DoNotOptimize(nodes.data());
+    arena.reset();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_NodesArena)->Range(1 << 10, 1 << 18);
+
+}  // namespace
@@ -0,0 +1,75 @@
+#include <string>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "corpus/corpus_generator.hpp"
+#include "error_reporter/error_reporter.hpp"
+#include "memory/arena.hpp"
+#include "parser/parser.hpp"
+#include "source_file/source_file.hpp"
+
+/*******************************************************************************
+Parses generated programs of growing size, which includes scanning them, with
+the tree and the scanner's tables in a per-parse Arena as the interpreter does
+and on the default heap resource. An expression-heavy mix with long, deeply
+parenthesized expressions stresses the Pratt loop rather than the statements.
+*******************************************************************************/
+
+namespace {
+
+Source_File generated_source(std::size_t bytes) {
+  std::string text;
+  Corpus_Generator(1).generate(text, bytes);
+  return Source_File(std::move(text));
+}
+
+Source_File expression_heavy_source(std::size_t bytes) {
+  Corpus_Generator::Mix mix;
+  mix.control_flow = 0;
+  mix.functions = 0;
+  mix.comments = 0;
+  mix.max_operands = 16;
+  mix.max_depth = 12;
+
+  std::string text;
+  Corpus_Generator(1, mix).generate(text, bytes);
+  return Source_File(std::move(text));
+}
+
+void BM_Parse(benchmark::State& state,
+              Source_File (*make_source)(std::size_t)) {
+  Source_File source = make_source(state.range(0));
+  Error_Reporter e;
+  Arena arena;
+  for (auto _ : state) {
+    {
+      Monotonic_Resource resource(arena);
+      Parser parser(source, e, &resource);
+      benchmark::DoNotOptimize(&parser.parse());
+    }
+    arena.reset();
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          source.get_contents().length());
+}
+
+void BM_ParseHeap(benchmark::State& state) {
+  Source_File source = generated_source(state.range(0));
+  Error_Reporter e;
+  for (auto _ : state) {
+    Parser parser(source, e);
+    benchmark::DoNotOptimize(&parser.parse());
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          source.get_contents().length());
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_Parse, generated, generated_source)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 24);
+BENCHMARK_CAPTURE(BM_Parse, expressions, expression_heavy_source)
+    ->RangeMultiplier(16)
+    ->Range(1 << 12, 1 << 24);
+BENCHMARK(BM_ParseHeap)->RangeMultiplier(16)->Range(1 << 12, 1 << 24);
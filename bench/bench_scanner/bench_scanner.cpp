@@ -0,0 +1,158 @@
+#include <string>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "corpus/corpus_generator.hpp"
+#include "error_reporter/error_reporter.hpp"
+#include "scanner/byte_scan.hpp"
+#include "scanner/parallel_scanner.hpp"
+#include "scanner/scanner.hpp"
+#include "source_file/source_file.hpp"
+
+/*******************************************************************************
+Lexes a comment-heavy source with long strings, the case the vector kernels are
+for, with each set of kernels the CPU supports, and a source made of short
+tokens, which measures the per-token dispatch in Scanner::scan_token. The
+token-dense source is also lexed with Parallel_Scanner on a growing number of
+chunks. Sources dominated by identifiers, numbers, strings or comments show how
+each kind of token scans on its own, and a generated program how they scan
+mixed together.
+*******************************************************************************/
+
+namespace {
+
+Source_File comment_heavy_source(std::size_t lines) {
+  std::string text;
+  for (std::size_t i = 0; i < lines; i++) {
+    text += "    // Explains in some detail what the next statement does.\n";
+    text += "    var message_" + std::to_string(i) +
+            " = \"a string literal that is longer than a vector block\";\n";
+  }
+  return Source_File(std::move(text));
+}
+
+Source_File token_dense_source(std::size_t lines) {
+  std::string text;
+  for (std::size_t i = 0; i < lines; i++) {
+    text += "if(a<=b){c=!d;}else{e=(f!=g)==(h>=i)/2.5*j-k+l;print m>n<o;}\n";
+  }
+  return Source_File(std::move(text));
+}
+
+Source_File identifier_heavy_source(std::size_t lines) {
+  std::string text;
+  for (std::size_t i = 0; i < lines; i++) {
+    std::string n = std::to_string(i);
+    text += "var total_" + n + " = running_sum + next_value_" + n +
+            " and classify(total_" + n + ", bucket_count) or fallback;\n";
+  }
+  return Source_File(std::move(text));
+}
+
+Source_File number_heavy_source(std::size_t lines) {
+  std::string text;
+  for (std::size_t i = 0; i < lines; i++) {
+    std::string n = std::to_string(i);
+    text += "x = " + n + " + 3.14159 * " + n + ".5 - 271828 / 0.001 + 42 * " +
+            n + "0.25;\n";
+  }
+  return Source_File(std::move(text));
+}
+
+Source_File string_heavy_source(std::size_t lines) {
+  std::string text;
+  for (std::size_t i = 0; i < lines; i++) {
+    text += "print \"a short one\" + \"a string literal long enough to span "
+            "several vector blocks of the scanner\" + \"" +
+            std::to_string(i) + "\";\n";
+  }
+  return Source_File(std::move(text));
+}
+
+Source_File comment_only_source(std::size_t lines) {
+  std::string text;
+  for (std::size_t i = 0; i < lines; i++) {
+    text += "// Line " + std::to_string(i) +
+            " of a long block of commentary that the scanner skips whole.\n";
+  }
+  return Source_File(std::move(text));
+}
+
+// A generated program of about as many bytes as the sources above with the same
+// number of lines.
+Source_File generated_source(std::size_t lines) {
+  std::string text;
+  Corpus_Generator(1).generate(text, 64 * lines);
+  return Source_File(std::move(text));
+}
+
+void BM_Scan(benchmark::State& state, const lox_byte_scan::Kernels* kernels) {
+  if (kernels == nullptr) {
+    state.SkipWithError("Not supported by this CPU.");
+    return;
+  }
+
+  Source_File source = comment_heavy_source(state.range(0));
+  Error_Reporter e;
+  for (auto _ : state) {
+    Scanner s(source, e, *kernels);
+    benchmark::DoNotOptimize(&s.scan_tokens());
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          source.get_contents().length());
+}
+
+void BM_ScanTokenDense(benchmark::State& state) {
+  Source_File source = token_dense_source(state.range(0));
+  Error_Reporter e;
+  for (auto _ : state) {
+    Scanner s(source, e);
+    benchmark::DoNotOptimize(&s.scan_tokens());
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          source.get_contents().length());
+}
+
+void BM_ScanCorpus(benchmark::State& state,
+                   Source_File (*make_source)(std::size_t)) {
+  Source_File source = make_source(state.range(0));
+  Error_Reporter e;
+  for (auto _ : state) {
+    Scanner s(source, e);
+    benchmark::DoNotOptimize(&s.scan_tokens());
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          source.get_contents().length());
+}
+
+void BM_ScanParallel(benchmark::State& state) {
+  Source_File source = token_dense_source(state.range(0));
+  Error_Reporter e;
+  for (auto _ : state) {
+    Parallel_Scanner s(source, e, state.range(1));
+    benchmark::DoNotOptimize(&s.scan_tokens());
+  }
+  state.SetBytesProcessed(state.iterations() *
+                          source.get_contents().length());
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_Scan, scalar, &lox_byte_scan::scalar())
+    ->Range(64, 1 << 14);
+BENCHMARK_CAPTURE(BM_Scan, sse42, lox_byte_scan::sse42())->Range(64, 1 << 14);
+BENCHMARK_CAPTURE(BM_Scan, avx2, lox_byte_scan::avx2())->Range(64, 1 << 14);
+BENCHMARK(BM_ScanTokenDense)->Range(64, 1 << 16);
+BENCHMARK_CAPTURE(BM_ScanCorpus, identifiers, identifier_heavy_source)
+    ->Range(64, 1 << 14);
+BENCHMARK_CAPTURE(BM_ScanCorpus, numbers, number_heavy_source)
+    ->Range(64, 1 << 14);
+BENCHMARK_CAPTURE(BM_ScanCorpus, strings, string_heavy_source)
+    ->Range(64, 1 << 14);
+BENCHMARK_CAPTURE(BM_ScanCorpus, comments, comment_only_source)
+    ->Range(64, 1 << 14);
+BENCHMARK_CAPTURE(BM_ScanCorpus, generated, generated_source)
+    ->Range(64, 1 << 14);
+BENCHMARK(BM_ScanParallel)
+    ->ArgsProduct({{1 << 16}, {1, 2, 4, 8, 16}})
+    ->UseRealTime();
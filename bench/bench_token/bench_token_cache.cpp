@@ -0,0 +1,67 @@
+#include <unistd.h>
+
+#include <filesystem>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "corpus/corpus_generator.hpp"
+#include "error_reporter/error_reporter.hpp"
+#include "scanner/scanner.hpp"
+#include "source_file/source_file.hpp"
+#include "token/token_cache.hpp"
+
+/*******************************************************************************
+Gets the tokens of a generated program of the given size, once by scanning it
+and once by loading them from a token cache, which should take a small fraction
+of the scan.
+*******************************************************************************/
+
+namespace {
+
+Source_File cache_source(std::size_t size) {
+  std::string text;
+  Corpus_Generator(1).generate(text, size);
+  return Source_File(std::move(text));
+}
+
+void BM_CacheScan(benchmark::State& state) {
+  Source_File source = cache_source(state.range(0));
+  Error_Reporter e;
+
+  for (auto _ : state) {
+    Scanner s(source, e);
+    benchmark::DoNotOptimize(s.scan_tokens().get_maximum_index());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_CacheLoad(benchmark::State& state) {
+  Source_File source = cache_source(state.range(0));
+  std::string path = (std::filesystem::temp_directory_path() /
+                      ("jlox_in_cpp_bench_" + std::to_string(getpid()) +
+                       ".lxtc"))
+                         .string();
+  {
+    Error_Reporter e;
+    Scanner s(source, e);
+    Token_Cache::store(path, source, s.scan_tokens(), s.get_literals(),
+                       s.get_symbols());
+  }
+
+  for (auto _ : state) {
+    Token_Cache cache;
+    if (!cache.load(path, source)) {
+      state.SkipWithError("The cache missed.");
+      break;
+    }
+    benchmark::DoNotOptimize(cache.end() - cache.begin());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+
+  std::filesystem::remove(path);
+}
+
+}  // namespace
+
+BENCHMARK(BM_CacheScan)->Range(1 << 16, 1 << 24)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CacheLoad)->Range(1 << 16, 1 << 24)->Unit(benchmark::kMillisecond);
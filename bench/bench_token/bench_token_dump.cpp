@@ -0,0 +1,73 @@
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <string>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "data_structures/dynamic_array.hpp"
+#include "error_reporter/error_reporter.hpp"
+#include "scanner/scanner.hpp"
+#include "source_file/source_file.hpp"
+#include "token/token_dump.hpp"
+
+/*******************************************************************************
+Prints the tokens of a source to /dev/null, once with a stream and a flush per
+token as run() used to, and once with Token_Dump in each format.
+*******************************************************************************/
+
+namespace {
+
+Source_File dump_source(std::size_t lines) {
+  std::string text;
+  for (std::size_t i = 0; i < lines; i++) {
+    text += "var total_" + std::to_string(i) + " = (count + " +
+            std::to_string(i) + ".25) * \"label\";\n";
+  }
+  return Source_File(std::move(text));
+}
+
+void BM_DumpStream(benchmark::State& state) {
+  Source_File source = dump_source(state.range(0));
+  Error_Reporter e;
+  Scanner s(source, e);
+  Token_Array& tokens = s.scan_tokens();
+  std::ofstream null("/dev/null");
+
+  for (auto _ : state) {
+    for (const Token& token : tokens) {
+      null << token.to_string(source.get_contents()) << std::endl;
+    }
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          (tokens.get_maximum_index() + 1));
+}
+
+void BM_Dump(benchmark::State& state, Token_Dump::Format format) {
+  Source_File source = dump_source(state.range(0));
+  Error_Reporter e;
+  Scanner s(source, e);
+  Token_Array& tokens = s.scan_tokens();
+  int null = open("/dev/null", O_WRONLY | O_CLOEXEC);
+
+  for (auto _ : state) {
+    Token_Dump dump(null, format);
+    for (const Token& token : tokens) {
+      dump.write(token, source.get_contents(), s.get_literals());
+    }
+    dump.flush();
+  }
+  state.SetItemsProcessed(state.iterations() *
+                          (tokens.get_maximum_index() + 1));
+
+  close(null);
+}
+
+}  // namespace
+
+BENCHMARK(BM_DumpStream)->Range(64, 1 << 14);
+BENCHMARK_CAPTURE(BM_Dump, text, Token_Dump::Format::TEXT)
+    ->Range(64, 1 << 14);
+BENCHMARK_CAPTURE(BM_Dump, binary, Token_Dump::Format::BINARY)
+    ->Range(64, 1 << 14);
@@ -0,0 +1,73 @@
+#include <sstream>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "error_reporter/error_reporter.hpp"
+#include "source_file/source_file.hpp"
+#include "vm/vm.hpp"
+
+/*******************************************************************************
+Runs the book's benchmark programs on the VM: naive recursive fib, which is
+dominated by calls and returns, a counting loop that adds to a global, which is
+dominated by dispatch and arithmetic, and method calls on an instance, which go
+through OP_INVOKE. Each iteration compiles and runs the program on one VM.
+*******************************************************************************/
+
+namespace {
+
+void run_program(benchmark::State& state, const std::string& text) {
+  Source_File source(text);
+  std::ostringstream out;
+  VM vm(out);
+  Error_Reporter e;
+
+  for (auto _ : state) {
+    if (vm.interpret(source, e) != Interpret_Result::IR_OK) {
+      state.SkipWithError("The program failed.");
+      return;
+    }
+    out.str("");
+  }
+}
+
+void BM_Fib(benchmark::State& state) {
+  run_program(state,
+              "fun fib(n) { if (n < 2) return n;"
+              "  return fib(n - 2) + fib(n - 1); }"
+              "print fib(" +
+                  std::to_string(state.range(0)) + ");");
+}
+
+void BM_Loop(benchmark::State& state) {
+  run_program(state,
+              "var sum = 0;"
+              "for (var i = 0; i < " +
+                  std::to_string(state.range(0)) +
+                  "; i = i + 1) { sum = sum + i; }"
+                  "print sum;");
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Invoke(benchmark::State& state) {
+  run_program(state,
+              "class Counter { init() { this.count = 0; }"
+              "  add(n) { this.count = this.count + n; } }"
+              "var counter = Counter();"
+              "for (var i = 0; i < " +
+                  std::to_string(state.range(0)) +
+                  "; i = i + 1) { counter.add(i); }"
+                  "print counter.count;");
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+BENCHMARK(BM_Fib)->DenseRange(20, 30, 5)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Loop)
+    ->RangeMultiplier(100)
+    ->Range(10000, 1000000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Invoke)
+    ->RangeMultiplier(100)
+    ->Range(10000, 1000000)
+    ->Unit(benchmark::kMillisecond);
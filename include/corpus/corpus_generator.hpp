@@ -0,0 +1,112 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/*******************************************************************************
+Generates synthetic Lox programs for stress and throughput testing. The output
+depends only on the seed and the mix: the generator has its own random number
+generator instead of the <random> distributions, whose results differ between
+standard libraries, so a seed names the same corpus on every machine.
+
+A program is a sequence of top-level statements; declarations, prints,
+assignments and calls, control flow and functions and classes whose bodies nest
+up to Mix::max_depth deep, and comments. The Mix weighs how often each kind of
+statement and of operand appears. Every top-level statement is complete, so a
+corpus can be generated in pieces of any size, and the pieces concatenated are
+the corpus generated in one go. Programs are syntactically valid but aren't
+meant to be run; a name may be used where it isn't declared.
+
+The static functions make adversarial inputs that are the same for every seed:
+one huge string, long runs of one-character tokens and deep nesting.
+*******************************************************************************/
+
+class Corpus_Generator {
+ public:
+  // Relative weights; a weight of 0 leaves that kind out altogether.
+  struct Mix {
+    // Statements.
+    uint32_t declarations = 4;  // var x = ...;
+    uint32_t prints = 2;        // print ...;
+    uint32_t expressions = 4;   // Assignments and calls.
+    uint32_t control_flow = 2;  // if, while and for with nested bodies.
+    uint32_t functions = 1;     // fun and class with nested bodies.
+    uint32_t comments = 2;      // // ... lines.
+
+    // Operands of expressions.
+    uint32_t identifiers = 6;
+    uint32_t numbers = 3;
+    uint32_t strings = 2;
+    uint32_t multi_line_strings = 1;
+    uint32_t literals = 1;  // true, false and nil.
+
+    // The most operands in one expression.
+    uint32_t max_operands = 6;
+
+    // How deeply statements and parentheses nest at most.
+    uint32_t max_depth = 6;
+  };
+
+  // Generates the default mix.
+  explicit Corpus_Generator(uint64_t seed);
+
+  // Throws std::invalid_argument if the mix has no statements or no operands.
+  Corpus_Generator(uint64_t seed, const Mix& mix);
+
+  // Appends statements to out until at least bytes bytes were appended; the
+  // last statement is completed, so slightly more is appended.
+  void generate(std::string& out, std::size_t bytes);
+
+  // Writes about bytes bytes of statements to the file descriptor fd, in
+  // blocks, so corpora larger than memory can be generated. Throws
+  // std::system_error if writing fails.
+  void write(int fd, std::size_t bytes);
+
+  // A statement declaring a single string literal of length bytes.
+  static std::string long_string(std::size_t bytes);
+
+  // count one-character tokens that never combine into longer tokens, with a
+  // newline after every 64.
+  static std::string one_char_tokens(std::size_t count);
+
+  // Blocks nested depth deep around an expression with depth levels of
+  // parentheses.
+  static std::string deep_nesting(std::size_t depth);
+
+ private:
+  // The state of a xoshiro256** generator.
+  uint64_t state[4];
+
+  Mix mix;
+
+  // The total weight of the statements and of the operands in the mix.
+  uint32_t statement_weight;
+  uint32_t operand_weight;
+
+  // The number of names and classes declared so far, used to name new ones.
+  uint64_t names = 0;
+  uint32_t classes = 0;
+
+  // Returns the next 64 random bits.
+  uint64_t next();
+
+  // Returns a random number in [0, bound), bound > 0.
+  uint32_t below(uint32_t bound);
+
+  // Appends a random element of choices.
+  template <std::size_t N>
+  void pick(std::string& out, const std::string_view (&choices)[N]);
+
+  void statement(std::string& out, uint32_t depth, bool in_function);
+  void block(std::string& out, uint32_t depth, bool in_function);
+  void expression(std::string& out, uint32_t depth);
+  void operand(std::string& out, uint32_t depth);
+  void identifier(std::string& out);
+  void number(std::string& out);
+  void string_literal(std::string& out, bool multi_line);
+  void comment(std::string& out);
+  void indent(std::string& out, uint32_t depth);
+};
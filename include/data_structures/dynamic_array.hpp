@@ -1,32 +1,64 @@
 #pragma once
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <new>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
 
 /*******************************************************************************
 Template declarations and definitions must be kept in header only to avoid
 linking errors.
+
+The memory for the elements comes from the Allocator, which follows the
+standard allocator requirements; elements are constructed in that memory
+directly, so the allocator isn't passed on to them. An allocator is copied and
+moved along with the array only where its propagate_on_container_* traits say
+so, as in the standard containers: a std::pmr array keeps its memory resource
+for life, and moving between arrays on different resources moves the elements
+rather than the memory. lox_pmr::Dynamic_Array is the array on a
+std::pmr::memory_resource.
 *******************************************************************************/
 
+/* Types whose objects can be moved to a new address with memcpy and without
+running a constructor or destructor. Trivially copyable types always can;
+specialize this for other types known to be safe to relocate bitwise. */
 template <typename T>
+struct Trivially_Relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T, typename Allocator = std::allocator<T>>
 class Dynamic_Array {
  public:
+  using allocator_type = Allocator;
+
   /*************************************************************************
   CONSTRUCTORS
   *************************************************************************/
   // Default Constructor
   Dynamic_Array();
 
+  // Constructs an empty dynamic array whose memory comes from allocator.
+  explicit Dynamic_Array(const Allocator& allocator);
+
   // Overloaded default constructor to manually set the initial size of the
   // dynamic array
-  Dynamic_Array(std::size_t initial_size);
+  Dynamic_Array(std::size_t initial_size,
+                const Allocator& allocator = Allocator());
 
   // Copy Constructor = l-value reference argument (&)
   // Copies the values from the provided Dynamic Array into this Dynamic
   // Array
   Dynamic_Array(const Dynamic_Array& src);
 
+  // Copies the values from the provided Dynamic Array into memory from
+  // allocator.
+  Dynamic_Array(const Dynamic_Array& src, const Allocator& allocator);
+
   // Move Constructor = r-value reference argument (&&)
   // Moves the values from the provided Dynamic Array into this Dynamic
   // Array
@@ -47,13 +79,16 @@ class Dynamic_Array {
   GET FUNCTIONS FOR DATA STRUCTURE PROPERTIES
   *************************************************************************/
   // Returns the resize factor of the dynamic array.
-  int get_resize_factor();
+  int get_resize_factor() const;
 
   // Returns the current size of the dynamic array.
-  int get_size();
+  int get_size() const;
 
   // Returns the maximum index of the dynamic array.
-  int get_maximum_index();
+  int get_maximum_index() const;
+
+  // Returns the allocator the dynamic array's memory comes from.
+  Allocator get_allocator() const;
 
   /*****************************************************************************
   BEGIN AND END ITERATORS
@@ -68,6 +103,30 @@ class Dynamic_Array {
   // Inserts data of type T into the dynamic array (at the specified index).
   void insert(const T& data, int index);
 
+  // Moves data of type T into the dynamic array (at the specified index).
+  void insert(T&& data, int index);
+
+  // Appends data of type T one position after the maximum index.
+  void push_back(const T& data);
+
+  // Moves data of type T one position after the maximum index.
+  void push_back(T&& data);
+
+  // Constructs data of type T in place one position after the maximum index
+  // and returns a reference to it.
+  template <typename... Args>
+  T& emplace_back(Args&&... args);
+
+  // Grows the dynamic array so that it can hold at least the requested number
+  // of elements without being resized again.
+  void reserve(std::size_t requested_size);
+
+  // Appends count default-initialized elements, to be filled in place (e.g. by
+  // several threads at once), and returns a pointer to the first of them. The
+  // array grows by its resize factor as with push_back, so many small appends
+  // take amortized constant time per element.
+  T* append_for_overwrite(std::size_t count);
+
   // Replaces data of type T in the dynamic array at given index.
   void replace(const T& data, int index);
 
@@ -85,21 +144,22 @@ class Dynamic_Array {
 
   // Prints the current state of the dynamic array to standard output.
   // Overload of operator << must be a friend.
-  template <typename U>
+  template <typename U, typename A>
   friend std::ostream& operator<<(std::ostream& os,
-                                  const Dynamic_Array<U>& src);
+                                  const Dynamic_Array<U, A>& src);
 
   // Overloads the = operator to provide a method of copying.
   Dynamic_Array& operator=(const Dynamic_Array& src);
 
-  // Overloads the = operator to provide a method of moving.
-  Dynamic_Array& operator=(Dynamic_Array&& src) noexcept;
+  // Overloads the = operator to provide a method of moving. Only throws if
+  // the elements have to be moved into memory from this' allocator.
+  Dynamic_Array& operator=(Dynamic_Array&& src) noexcept(ALWAYS_TAKES_MEMORY);
 
   /*************************************************************************
   DATA STRUCTURE SEARCH ALGORITHMS
   *************************************************************************/
   // Performs a linear search for data in the dynamic array starting at the
-  // specified index.
+  // specified index. Returns -1 if the data is not found.
   int linear_search(T& data, int offset = 0);
 
   /*************************************************************************
@@ -109,11 +169,24 @@ class Dynamic_Array {
   std::string serialize(std::string (*TtoString)(T)) const;
 
   // Deserializes this data structure using a string of a given format.
-  Dynamic_Array<T>* deserialize(std::string serialized_da,
+  Dynamic_Array* deserialize(std::string serialized_da,
                                 T (*StringToT)(std::string)) const;
 
  private:
-  // A pointer to memory to be initialized to an array of T-typed data.
+  using allocator_traits = std::allocator_traits<Allocator>;
+
+  /* Whether a moved-to array can always take over the moved-from array's
+  memory, because the allocator moves with it or any of its allocators can
+  free the memory of any other. */
+  static constexpr bool ALWAYS_TAKES_MEMORY =
+      allocator_traits::propagate_on_container_move_assignment::value ||
+      allocator_traits::is_always_equal::value;
+
+  // Where the memory of the array comes from.
+  [[no_unique_address]] Allocator allocator;
+
+  /* A pointer to raw, suitably aligned memory for size T-typed elements. Only
+  the elements at indices 0 through maximum_index are constructed. */
   T* array;
 
   // Stores the size of the dynamic array.
@@ -126,75 +199,114 @@ class Dynamic_Array {
   // resized.
   std::size_t resize_factor;
 
+  // Returns the size the array grows to on its next resize.
+  std::size_t next_size() const;
+
   // Resizes the array dynamically.
   void resize();
+
+  // Reallocates the array to the given size, relocating the existing elements.
+  void reallocate(std::size_t new_size);
+
+  // Allocates uninitialized memory for the given number of elements.
+  T* allocate(std::size_t count);
+
+  // Deallocates memory obtained from allocate.
+  void deallocate(T* memory, std::size_t count);
+
+  /* Moves count constructed elements from src into the uninitialized memory at
+  dst, leaving src uninitialized. If an exception is thrown, src is left
+  untouched and dst uninitialized. */
+  static void relocate(T* src, std::size_t count, T* dst);
+
+  // Destroys the elements that contain data and releases the memory.
+  void release();
 };
 
 /*******************************************************************************
 CONSTRUCTORS
 *******************************************************************************/
-template <typename T>
-Dynamic_Array<T>::Dynamic_Array() {
+template <typename T, typename Allocator>
+Dynamic_Array<T, Allocator>::Dynamic_Array() : Dynamic_Array(Allocator()) {}
+
+template <typename T, typename Allocator>
+Dynamic_Array<T, Allocator>::Dynamic_Array(const Allocator& allocator)
+    : allocator(allocator) {
   this->size = 4;
   this->resize_factor = 2;
   this->maximum_index = -1;
 
-  array = new T[this->size];
+  array = allocate(this->size);
 }
 
-template <typename T>
-Dynamic_Array<T>::Dynamic_Array(std::size_t initial_size) {
+template <typename T, typename Allocator>
+Dynamic_Array<T, Allocator>::Dynamic_Array(std::size_t initial_size,
+                                           const Allocator& allocator)
+    : allocator(allocator) {
   this->size = initial_size;
   this->resize_factor = 2;
   this->maximum_index = -1;
 
-  array = new T[this->size];
+  array = allocate(this->size);
 }
 
-template <typename T>
-Dynamic_Array<T>::Dynamic_Array(const Dynamic_Array<T>& src) {
+template <typename T, typename Allocator>
+Dynamic_Array<T, Allocator>::Dynamic_Array(const Dynamic_Array& src)
+    : Dynamic_Array(
+          src, allocator_traits::select_on_container_copy_construction(
+                   src.allocator)) {}
+
+template <typename T, typename Allocator>
+Dynamic_Array<T, Allocator>::Dynamic_Array(const Dynamic_Array& src,
+                                           const Allocator& allocator)
+    : allocator(allocator) {
   // Obtain all member variables from the src Dynamic Array
   this->size = src.size;
-  this->maximum_index = src.maximum_index;
   this->resize_factor = src.resize_factor;
+  this->maximum_index = -1;
 
-  // Delete this' array and point to src's array.
-  delete[] this->array;
-  this->array = src.array;
+  // Copy-construct src's elements into memory owned by this Dynamic Array.
+  array = allocate(this->size);
+  try {
+    std::uninitialized_copy(src.array, src.array + (src.maximum_index + 1),
+                            array);
+  } catch (...) {
+    deallocate(array, this->size);
+    throw;
+  }
+
+  this->maximum_index = src.maximum_index;
 }
 
-template <typename T>
-Dynamic_Array<T>::Dynamic_Array(Dynamic_Array<T>&& src) noexcept {
+template <typename T, typename Allocator>
+Dynamic_Array<T, Allocator>::Dynamic_Array(Dynamic_Array&& src) noexcept
+    : allocator(std::move(src.allocator)) {
   // Obtain all member variables from the src Dynamic Array
   this->size = src.size;
   this->maximum_index = src.maximum_index;
   this->resize_factor = src.resize_factor;
-
-  // Delete this' array and point to the src Dynamic Array.
-  delete[] this->array;
   this->array = src.array;
 
-  // Return the src Dynamic Array into a newly created state.
-  src.size = 4;
+  /* Leave the src Dynamic Array empty and without memory; it allocates again
+  on its next insertion. */
+  src.size = 0;
   src.maximum_index = -1;
-  src.resize_factor = 2;
-  src.array = new T[src.size];
+  src.array = nullptr;
 }
 
 /*******************************************************************************
 DESTRUCTOR
 *******************************************************************************/
-template <typename T>
-Dynamic_Array<T>::~Dynamic_Array() {
-  // Deletes the only segment of heap-allocated memory in this data structure.
-  delete[] array;
+template <typename T, typename Allocator>
+Dynamic_Array<T, Allocator>::~Dynamic_Array() {
+  release();
 }
 
 /*******************************************************************************
 SET FUNCTIONS FOR DATA STRUCTURE PROPERTIES
 *******************************************************************************/
-template <typename T>
-void Dynamic_Array<T>::set_resize_factor(std::size_t resize_factor) {
+template <typename T, typename Allocator>
+void Dynamic_Array<T, Allocator>::set_resize_factor(std::size_t resize_factor) {
   // Sets this dynamic array's resize factor to the parameter's value.
   this->resize_factor = resize_factor;
 }
@@ -202,89 +314,174 @@ void Dynamic_Array<T>::set_resize_factor(std::size_t resize_factor) {
 /*******************************************************************************
 GET FUNCTIONS FOR DATA STRUCTURE PROPERTIES
 *******************************************************************************/
-template <typename T>
-int Dynamic_Array<T>::get_resize_factor() {
+template <typename T, typename Allocator>
+int Dynamic_Array<T, Allocator>::get_resize_factor() const {
   // Return this dynamic array's resize factor.
   return this->resize_factor;
 }
 
-template <typename T>
-int Dynamic_Array<T>::get_size() {
+template <typename T, typename Allocator>
+int Dynamic_Array<T, Allocator>::get_size() const {
   // Returns the size of this dynamic array.
   return this->size;
 }
 
-template <typename T>
-int Dynamic_Array<T>::get_maximum_index() {
+template <typename T, typename Allocator>
+int Dynamic_Array<T, Allocator>::get_maximum_index() const {
   // Returns the maximum index of this dynamic array.
   return this->maximum_index;
 }
 
+template <typename T, typename Allocator>
+Allocator Dynamic_Array<T, Allocator>::get_allocator() const {
+  return this->allocator;
+}
+
 /*******************************************************************************
 BEGIN AND END ITERATORS
 *******************************************************************************/
-template <typename T>
-T* Dynamic_Array<T>::begin() {
-  return &(this->array[0]);
+template <typename T, typename Allocator>
+T* Dynamic_Array<T, Allocator>::begin() {
+  return this->array;
 }
 
-template <typename T>
-T* Dynamic_Array<T>::end() {
-  return &(this->array[this->maximum_index]);
+template <typename T, typename Allocator>
+T* Dynamic_Array<T, Allocator>::end() {
+  // One position past the last element that contains data.
+  return this->array + (this->maximum_index + 1);
 }
 
 /*******************************************************************************
 DATA STRUCTURE OPERATIONS
 *******************************************************************************/
-template <typename T>
-void Dynamic_Array<T>::insert(const T& data, int index) {
-  // Check if the dynamic array's size needs to be resized for another
-  // element to be inserted.
-  if (((std::size_t)(this->maximum_index + 1)) >= this->size) {
-    resize();
+template <typename T, typename Allocator>
+void Dynamic_Array<T, Allocator>::insert(const T& data, int index) {
+  if (index > (this->maximum_index + 1)) {
+    throw std::out_of_range(
+        "Tried to insert data from an index higher than one position after "
+        "data was stored.");
   }
 
+  // Copy first in case data refers to an element of this dynamic array,
+  // which is moved around by the shift below.
+  T copy(data);
+  insert(std::move(copy), index);
+}
+
+template <typename T, typename Allocator>
+void Dynamic_Array<T, Allocator>::insert(T&& data, int index) {
   if (index > (this->maximum_index + 1)) {
     throw std::out_of_range(
         "Tried to insert data from an index higher than one position after "
         "data was stored.");
   }
 
-  // Instantiate a new array to copy the current elements to and insert the
-  // new element into.
-  T* new_array = new T[this->size];
+  // Appending at the end shifts nothing.
+  if (index == (this->maximum_index + 1)) {
+    emplace_back(std::move(data));
+    return;
+  }
 
-  int counter = 0;
+  // Check if the dynamic array's size needs to be resized for another
+  // element to be inserted.
+  if (((std::size_t)(this->maximum_index + 1)) >= this->size) {
+    resize();
+  }
 
-  // Copy elements from current state upto index that the new element is to
-  // be inserted.
-  while (counter < index) {
-    new_array[counter] = array[counter];
-    counter++;
+  if constexpr (Trivially_Relocatable<T>::value) {
+    // Shift the elements at and after the index one position to the right with
+    // a single memmove and construct the new element in the gap.
+    std::memmove(static_cast<void*>(array + index + 1),
+                 static_cast<const void*>(array + index),
+                 (this->maximum_index + 1 - index) * sizeof(T));
+    ::new (static_cast<void*>(array + index)) T(std::move(data));
+  } else {
+    /* The last element moves into uninitialized memory so it is constructed;
+    every other element moves into an already constructed one. Walk backwards
+    so that no element is overwritten before it has been moved. */
+    ::new (static_cast<void*>(array + this->maximum_index + 1))
+        T(std::move(array[this->maximum_index]));
+    for (int counter = this->maximum_index; counter > index; counter--) {
+      array[counter] = std::move(array[counter - 1]);
+    }
+    array[index] = std::move(data);
   }
 
-  // Insert new element at that index.
-  new_array[index] = data;
-  counter = index;
+  // Increase the maximum index because a new element was inserted.
+  maximum_index++;
+}
+
+template <typename T, typename Allocator>
+void Dynamic_Array<T, Allocator>::push_back(const T& data) {
+  emplace_back(data);
+}
 
-  // Finish copying elements.
-  while (counter <= this->maximum_index) {
-    new_array[counter + 1] = array[counter];
-    counter++;
-  }
+template <typename T, typename Allocator>
+void Dynamic_Array<T, Allocator>::push_back(T&& data) {
+  emplace_back(std::move(data));
+}
 
-  // Deallocate the memory associated with the old array.
-  delete[] array;
+template <typename T, typename Allocator>
+template <typename... Args>
+T& Dynamic_Array<T, Allocator>::emplace_back(Args&&... args) {
+  std::size_t count = this->maximum_index + 1;
+
+  if (count >= this->size) {
+    /* Construct the new element in the new memory before relocating the old
+    elements, because the arguments may refer to one of them. */
+    std::size_t new_size = next_size();
+    T* new_array = allocate(new_size);
+    try {
+      ::new (static_cast<void*>(new_array + count))
+          T(std::forward<Args>(args)...);
+    } catch (...) {
+      deallocate(new_array, new_size);
+      throw;
+    }
 
-  // Reassign the pointer to the newly created array.
-  array = new_array;
+    try {
+      relocate(array, count, new_array);
+    } catch (...) {
+      new_array[count].~T();
+      deallocate(new_array, new_size);
+      throw;
+    }
+
+    deallocate(array, this->size);
+    array = new_array;
+    this->size = new_size;
+  } else {
+    ::new (static_cast<void*>(array + count)) T(std::forward<Args>(args)...);
+  }
 
-  // Increase the maximum index because a new element was inserted.
   maximum_index++;
+  return array[maximum_index];
 }
 
-template <typename T>
-void Dynamic_Array<T>::replace(const T& data, int index) {
+template <typename T, typename Allocator>
+void Dynamic_Array<T, Allocator>::reserve(std::size_t requested_size) {
+  // Only ever grow; shrinking could drop elements that contain data.
+  if (requested_size > this->size) {
+    reallocate(requested_size);
+  }
+}
+
+template <typename T, typename Allocator>
+T* Dynamic_Array<T, Allocator>::append_for_overwrite(std::size_t count) {
+  std::size_t first = this->maximum_index + 1;
+  if ((first + count) > this->size) {
+    reallocate(std::max(first + count, next_size()));
+  }
+
+  // Default-initialization leaves trivial types such as numbers uninitialized,
+  // so this costs nothing for them.
+  std::uninitialized_default_construct_n(array + first, count);
+  maximum_index += count;
+  return array + first;
+}
+
+template <typename T, typename Allocator>
+void Dynamic_Array<T, Allocator>::replace(const T& data, int index) {
   // Check if the replacement takes place within the existing index range.
   // If not throw an exception.
   if (index > this->maximum_index) {
@@ -296,66 +493,58 @@ void Dynamic_Array<T>::replace(const T& data, int index) {
   }
 }
 
-template <typename T>
-void Dynamic_Array<T>::remove(int index) {
+template <typename T, typename Allocator>
+void Dynamic_Array<T, Allocator>::remove(int index) {
   // Check if the removal takes place within the existing index range.
   // If not throw an exception.
   if (index > this->maximum_index) {
     throw std::out_of_range(
         "Tried to remove data from an index higher than data was stored.");
-  } else {
-    // Instantiate a new array to copy the current elements except the element
-    // at the specified index.
-    T* new_array = new T[this->size];
-
-    int counter = 0;
+  } else if constexpr (Trivially_Relocatable<T>::value) {
+    // Destroy the element and close the gap with a single memmove.
+    array[index].~T();
+    std::memmove(static_cast<void*>(array + index),
+                 static_cast<const void*>(array + index + 1),
+                 (this->maximum_index - index) * sizeof(T));
 
-    // Copy elements from current state upto index that the new element is to
-    // be removed.
-    while (counter < index) {
-      new_array[counter] = array[counter];
-      counter++;
-    }
-
-    // Skip copying the element that is being removed.
-    counter = index + 1;
-
-    // Finish copying elements.
-    while (counter <= this->maximum_index) {
-      new_array[counter - 1] = array[counter];
-      counter++;
+    // Decrease the maximum index because an element was removed.
+    maximum_index--;
+  } else {
+    // Close the gap left by the removed element by shifting every element
+    // after it one position to the left.
+    for (int counter = index; counter < this->maximum_index; counter++) {
+      array[counter] = std::move(array[counter + 1]);
     }
 
-    // Deallocate the memory associated with the old array.
-    delete[] array;
-
-    // Reassign the pointer to the newly created array.
-    array = new_array;
+    // Only the elements upto the new maximum index remain constructed.
+    array[this->maximum_index].~T();
 
     // Decrease the maximum index because an element was removed.
     maximum_index--;
   }
 }
 
-template <typename T>
-void Dynamic_Array<T>::merge(Dynamic_Array& src) {
+template <typename T, typename Allocator>
+void Dynamic_Array<T, Allocator>::merge(Dynamic_Array& src) {
   // Insert all data from src into this Dynamic Array.
+  reserve((std::size_t)(this->maximum_index + src.maximum_index + 2));
   for (int counter = 0; counter <= src.maximum_index; counter++) {
-    insert(src[counter], counter);
+    insert(std::move(src.array[counter]), counter);
   }
 
   // Return the src Dynamic Array into a newly created state.
+  src.release();
   src.size = 4;
   src.maximum_index = -1;
   src.resize_factor = 2;
-  src.array = new T[src.size];
+  src.array = src.allocate(src.size);
 }
 
 /*******************************************************************************
 DATA STRUCTURE OPERATOR OVERLOADS
 *******************************************************************************/
-template <typename T>
-T& Dynamic_Array<T>::operator[](int index) const {
+template <typename T, typename Allocator>
+T& Dynamic_Array<T, Allocator>::operator[](int index) const {
   if (index > this->maximum_index) {
     throw std::out_of_range(
         "Tried to set data from an index higher than data was stored.");
@@ -365,8 +554,8 @@ T& Dynamic_Array<T>::operator[](int index) const {
   }
 }
 
-template <typename U>
-std::ostream& operator<<(std::ostream& os, const Dynamic_Array<U>& src) {
+template <typename U, typename A>
+std::ostream& operator<<(std::ostream& os, const Dynamic_Array<U, A>& src) {
   // Prints each element on a new line prefixed by its index number
   for (int counter = 0; counter <= src.maximum_index; counter++) {
     os << "Element " << counter << " : " << src[counter] << std::endl;
@@ -375,36 +564,79 @@ std::ostream& operator<<(std::ostream& os, const Dynamic_Array<U>& src) {
   return os;
 }
 
-template <typename T>
-Dynamic_Array<T>& Dynamic_Array<T>::operator=(const Dynamic_Array& src) {
-  // Obtain all member variables from the src Dynamic Array
-  this->size = src.size;
-  this->maximum_index = src.maximum_index;
-  this->resize_factor = src.resize_factor;
+template <typename T, typename Allocator>
+Dynamic_Array<T, Allocator>& Dynamic_Array<T, Allocator>::operator=(
+    const Dynamic_Array& src) {
+  if (this != &src) {
+    if constexpr (allocator_traits::propagate_on_container_copy_assignment::
+                      value) {
+      // This' memory must be freed by the allocator it came from before the
+      // allocator is replaced by src's.
+      if (this->allocator != src.allocator) {
+        release();
+      }
+      this->allocator = src.allocator;
+    }
 
-  // Delete this' array and point to src's array.
-  delete[] this->array;
-  this->array = src.array;
+    // Copy into a temporary first so that this Dynamic Array is unchanged if
+    // copying throws, then take over the temporary's memory, which came from
+    // the same allocator.
+    Dynamic_Array copy(src, this->allocator);
+    *this = std::move(copy);
+  }
 
   return *this;
 }
 
-template <typename T>
-Dynamic_Array<T>& Dynamic_Array<T>::operator=(Dynamic_Array&& src) noexcept {
-  // Obtain all member variables from the src Dynamic Array
+template <typename T, typename Allocator>
+Dynamic_Array<T, Allocator>& Dynamic_Array<T, Allocator>::operator=(
+    Dynamic_Array&& src) noexcept(ALWAYS_TAKES_MEMORY) {
+  if (this == &src) {
+    return *this;
+  }
+
+  if constexpr (!ALWAYS_TAKES_MEMORY) {
+    if (this->allocator != src.allocator) {
+      /* src's memory can't be freed by this' allocator, so move the elements
+      into memory from this' allocator instead. */
+      T* moved_array = allocate(src.size);
+      try {
+        relocate(src.array, src.maximum_index + 1, moved_array);
+      } catch (...) {
+        deallocate(moved_array, src.size);
+        throw;
+      }
+
+      release();
+      this->size = src.size;
+      this->maximum_index = src.maximum_index;
+      this->resize_factor = src.resize_factor;
+      this->array = moved_array;
+
+      src.deallocate(src.array, src.size);
+      src.size = 0;
+      src.maximum_index = -1;
+      src.array = nullptr;
+      return *this;
+    }
+  }
+
+  // Release this' elements and memory and point to the src Dynamic Array's.
+  release();
+  if constexpr (allocator_traits::propagate_on_container_move_assignment::
+                    value) {
+    this->allocator = std::move(src.allocator);
+  }
   this->size = src.size;
   this->maximum_index = src.maximum_index;
   this->resize_factor = src.resize_factor;
-
-  // Delete this' array and point to the src Dynamic Array.
-  delete[] this->array;
   this->array = src.array;
 
-  // Return the src Dynamic Array into a newly created state.
-  src.size = 4;
+  /* Leave the src Dynamic Array empty and without memory; it allocates again
+  on its next insertion. */
+  src.size = 0;
   src.maximum_index = -1;
-  src.resize_factor = 2;
-  src.array = new T[src.size];
+  src.array = nullptr;
 
   return *this;
 }
@@ -412,8 +644,8 @@ Dynamic_Array<T>& Dynamic_Array<T>::operator=(Dynamic_Array&& src) noexcept {
 /*******************************************************************************
 DATA STRUCTURE SEARCH ALGORITHMS
 *******************************************************************************/
-template <typename T>
-int Dynamic_Array<T>::linear_search(T& data, int offset) {
+template <typename T, typename Allocator>
+int Dynamic_Array<T, Allocator>::linear_search(T& data, int offset) {
   // Checks if the start of the search is in the valid range of data-filled
   // indices.
   if (offset > maximum_index) {
@@ -428,13 +660,17 @@ int Dynamic_Array<T>::linear_search(T& data, int offset) {
       return counter;
     }
   }
+
+  // The data was not found.
+  return -1;
 }
 
 /*******************************************************************************
 DATA STRUCTURE SERIALIZATION AND DESERIALIZATION
 *******************************************************************************/
-template <typename T>
-std::string Dynamic_Array<T>::serialize(std::string (*TtoString)(T)) const {
+template <typename T, typename Allocator>
+std::string Dynamic_Array<T, Allocator>::serialize(
+    std::string (*TtoString)(T)) const {
   // Empty string to store the serialized Dynamic Array
   std::string serialized_da = "";
 
@@ -455,11 +691,11 @@ std::string Dynamic_Array<T>::serialize(std::string (*TtoString)(T)) const {
   return serialized_da;
 }
 
-template <typename T>
-Dynamic_Array<T>* Dynamic_Array<T>::deserialize(
+template <typename T, typename Allocator>
+Dynamic_Array<T, Allocator>* Dynamic_Array<T, Allocator>::deserialize(
     std::string serialized_da, T (*StringToT)(std::string)) const {
   // Instantiates a Dynamic Array to store the deserialized elements of type T.
-  Dynamic_Array<T>* deserialized_da = new Dynamic_Array<T>();
+  Dynamic_Array* deserialized_da = new Dynamic_Array(this->allocator);
 
   std::string space = " ";
   std::size_t position = 0;
@@ -475,7 +711,7 @@ Dynamic_Array<T>* Dynamic_Array<T>::deserialize(
       // space to the position before the next space as an element of the
       // Dynamic Array. Then set the position to the end of the word.
       std::size_t substring_length = (search + 1) - position;
-      deserialized_da->insert(
+      deserialized_da->push_back(
           StringToT(serialized_da.substr(position, substring_length)));
       position = search + 1;
     } else {
@@ -485,7 +721,7 @@ Dynamic_Array<T>* Dynamic_Array<T>::deserialize(
       // into the Dynamic Array.
       std::size_t substring_length =
           (sizeof(serialized_da) - 2) - (position + 1);
-      deserialized_da->insert(
+      deserialized_da->push_back(
           StringToT(serialized_da.substr(position, substring_length)));
       position = std::string::npos;
     }
@@ -498,23 +734,94 @@ Dynamic_Array<T>* Dynamic_Array<T>::deserialize(
 /*******************************************************************************
 PRIVATE DECLARATIONS
 *******************************************************************************/
-template <typename T>
-void Dynamic_Array<T>::resize() {
-  // Update the size of the dynamic array
-  this->size *= this->resize_factor;
+template <typename T, typename Allocator>
+std::size_t Dynamic_Array<T, Allocator>::next_size() const {
+  // Grow by the resize factor, but always by at least one element so that a
+  // resize factor of one (or a size of zero) still makes progress.
+  std::size_t new_size = this->size * this->resize_factor;
+  if (new_size <= this->size) {
+    new_size = this->size + 1;
+  }
 
-  // Creates a new array on the heap of the new size - if stack allocated array
-  // would no longer exist after function call
-  T* newly_sized_array = new T[this->size];
+  return new_size;
+}
 
-  // Copy the members of the old array into the new array
-  for (int counter = 0; counter <= this->maximum_index; counter++)
-    newly_sized_array[counter] = array[counter];
+template <typename T, typename Allocator>
+void Dynamic_Array<T, Allocator>::resize() {
+  reallocate(next_size());
+}
+
+template <typename T, typename Allocator>
+void Dynamic_Array<T, Allocator>::reallocate(std::size_t new_size) {
+  // Allocate uninitialized memory of the new size; only the elements that
+  // contain data are ever constructed in it.
+  T* newly_sized_array = allocate(new_size);
+
+  // Relocate the members of the old array into the new array
+  try {
+    relocate(array, this->maximum_index + 1, newly_sized_array);
+  } catch (...) {
+    deallocate(newly_sized_array, new_size);
+    throw;
+  }
 
-  // Deletes the heap memory associated with the pointer to the array.
-  delete[] array;
+  // Release the old memory; its elements were already relocated.
+  deallocate(array, this->size);
 
-  // Assign the array pointer to the new heap memory allocated with the newly
-  // sized array
+  // Assign the array pointer to the newly sized memory.
   array = newly_sized_array;
+  this->size = new_size;
 }
+
+template <typename T, typename Allocator>
+T* Dynamic_Array<T, Allocator>::allocate(std::size_t count) {
+  return allocator_traits::allocate(this->allocator, count);
+}
+
+template <typename T, typename Allocator>
+void Dynamic_Array<T, Allocator>::deallocate(T* memory, std::size_t count) {
+  if (memory != nullptr) {
+    allocator_traits::deallocate(this->allocator, memory, count);
+  }
+}
+
+template <typename T, typename Allocator>
+void Dynamic_Array<T, Allocator>::relocate(T* src, std::size_t count, T* dst) {
+  if (count == 0) {
+    return;
+  }
+
+  if constexpr (Trivially_Relocatable<T>::value) {
+    // Bitwise relocation; no constructors or destructors run.
+    std::memcpy(static_cast<void*>(dst), static_cast<const void*>(src),
+                count * sizeof(T));
+  } else if constexpr (std::is_nothrow_move_constructible_v<T>) {
+    // Moving cannot fail part way, so move each element and destroy the
+    // moved-from original.
+    for (std::size_t counter = 0; counter < count; counter++) {
+      ::new (static_cast<void*>(dst + counter)) T(std::move(src[counter]));
+      src[counter].~T();
+    }
+  } else {
+    /* Moving could throw after src was partially modified, so copy instead;
+    uninitialized_copy destroys what it constructed if a copy throws. */
+    std::uninitialized_copy(src, src + count, dst);
+    std::destroy(src, src + count);
+  }
+}
+
+template <typename T, typename Allocator>
+void Dynamic_Array<T, Allocator>::release() {
+  std::destroy(array, array + (this->maximum_index + 1));
+  deallocate(array, this->size);
+  array = nullptr;
+  this->maximum_index = -1;
+}
+
+namespace lox_pmr {
+
+// A Dynamic_Array whose memory comes from a std::pmr::memory_resource.
+template <typename T>
+using Dynamic_Array = ::Dynamic_Array<T, std::pmr::polymorphic_allocator<T>>;
+
+}  // namespace lox_pmr
@@ -1,60 +1,166 @@
-#include <array>
-#include <cmath>
-#include <cstdint>
-#include <unordered_map>
+#pragma once
 
-#include "data_structures/dynamic_array.hpp"
-#include "data_structures/linked_list.hpp"
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 /*******************************************************************************
 Template declarations and definitions must be kept in header only to avoid
 linking errors.
 *******************************************************************************/
 
-template <typename K, typename V>
+/* The type keys are looked up by and how they are hashed. Tables keyed by
+std::string are looked up by std::string_view so that callers holding a view or
+a literal don't have to build a std::string; std::hash gives a std::string and a
+std::string_view with the same characters the same hash. A key type that
+carries its own precomputed hash can return it from a specialization, so that
+neither lookups nor rehashing hash the key again. */
+template <typename K>
+struct Hash_Table_Key {
+  using lookup_type = K;
+
+  static uint64_t hash(const lookup_type& key) {
+    return std::hash<lookup_type>{}(key);
+  }
+};
+
+template <>
+struct Hash_Table_Key<std::string> {
+  using lookup_type = std::string_view;
+
+  static uint64_t hash(const lookup_type& key) {
+    return std::hash<lookup_type>{}(key);
+  }
+};
+
+/*******************************************************************************
+Open-addressing hash table in the style of a Swiss table. Every slot has a
+one-byte control value that is either empty, deleted, or the low 7 bits of the
+hash (H2) of the key stored in the slot. The control bytes are kept in a
+separate contiguous array and probed a group of 16 at a time, so most lookups
+compare against a single candidate key and touch one cache line of control
+bytes. The remaining bits of the hash (H1) select the group probing starts at.
+Key-value pairs are stored inline in the slot array.
+
+Growing is incremental: the full table is kept as a draining table next to the
+newly allocated one, and every insertion or removal moves a bounded number of
+groups out of the draining table. Lookups check the new table and then the
+draining one, so no single operation pays for rehashing the whole table.
+Lookups never modify the table, so concurrent readers are safe as long as no
+thread is inserting or removing.
+
+The control bytes and slots are allocated with the Allocator, rebound to their
+types, and follow the same propagation rules as Dynamic_Array's memory.
+lox_pmr::Hash_Table is the table on a std::pmr::memory_resource.
+*******************************************************************************/
+
+template <typename K, typename V,
+          typename Allocator = std::allocator<std::pair<const K, V>>>
 class Hash_Table {
  public:
+  using lookup_key = typename Hash_Table_Key<K>::lookup_type;
+  using allocator_type = Allocator;
+
   /***********************************************************************
   CONSTRUCTORS
   ***********************************************************************/
   // Default Constructor
   Hash_Table();
 
+  // Constructs an empty hash table whose memory comes from allocator.
+  explicit Hash_Table(const Allocator& allocator);
+
   // Copy Constructor - l-value reference (&)
   // Copies the values from the provided Hash Table into this Hash Table
   Hash_Table(const Hash_Table& src);
 
+  // Copies the values from the provided Hash Table into memory from
+  // allocator.
+  Hash_Table(const Hash_Table& src, const Allocator& allocator);
+
   // Move Constructor - r-value reference (&&)
   // Moves the values from the provided Hash Table into this Hash Table
-  Hash_Table(Hash_Table&& src);
+  Hash_Table(Hash_Table&& src) noexcept;
 
   /***********************************************************************
   DESTRUCTOR
   ***********************************************************************/
   ~Hash_Table();
 
+  /***********************************************************************
+   GET FUNCTIONS FOR DATA STRUCTURE PROPERTIES
+  ***********************************************************************/
+  // Returns the number of key-value pairs in the hash table.
+  std::size_t get_size() const;
+
+  // Returns the number of slots in the hash table.
+  std::size_t get_capacity() const;
+
+  // Returns whether entries are still being moved out of a draining table.
+  bool is_rehashing() const;
+
+  // Returns the allocator the hash table's memory comes from.
+  Allocator get_allocator() const;
+
   /***********************************************************************
   DATA STRUCTURE OPERATIONS
   ***********************************************************************/
-  // Inserts key-value pair into the hash table.
+  // Inserts key-value pair into the hash table if the key doesn't exist.
   void insert(const K& key, const V& value);
 
+  /* Constructs the value from args and inserts it with the key if the key
+  doesn't exist. Returns a pointer to the value associated with the key and
+  whether it was inserted. */
+  template <typename... Args>
+  std::pair<V*, bool> try_emplace(const K& key, Args&&... args);
+
+  template <typename... Args>
+  std::pair<V*, bool> try_emplace(K&& key, Args&&... args);
+
   // Removes key from the table.
-  void remove(const K& key);
+  void remove(const lookup_key& key);
 
   // Replaces value associated with a given key with the given value.
   void replace(const K& key, const V& value);
 
   /* Search for a key in the hash table and returns a pointer to the value
-  associated with the key. */
-  V* search(const K& key);
+  associated with the key, or nullptr if the key doesn't exist. The value is
+  owned by the hash table; the pointer is valid until the next insertion or
+  removal. */
+  V* search(const lookup_key& key);
+  const V* search(const lookup_key& key) const;
+
+  /* Returns a reference to the value associated with the key; throws
+  std::out_of_range if the key doesn't exist. */
+  V& find(const lookup_key& key);
+  const V& find(const lookup_key& key) const;
+
+  // Returns whether the key exists in the hash table.
+  bool contains(const lookup_key& key) const;
+
+  /* Calls visit(key, value) for every key-value pair, in no particular order.
+  visit must not insert into or remove from the table. */
+  template <typename F>
+  void for_each(F&& visit) const;
 
   /***********************************************************************
   DATA STRUCTURE OPERATOR OVERLOADS
   ***********************************************************************/
   Hash_Table& operator=(const Hash_Table& src);
 
-  Hash_Table& operator=(Hash_Table&& src) noexcept;
+  Hash_Table& operator=(Hash_Table&& src) noexcept(ALWAYS_TAKES_MEMORY);
 
  private:
   struct cell {
@@ -62,252 +168,775 @@ class Hash_Table {
     V value;
   };
 
-  Dynamic_Array<Linked_List<cell*>*>* ht;
+  // Number of control bytes probed at once.
+  static constexpr std::size_t GROUP_WIDTH = 16;
+
+  // The unit control bytes are allocated in, which keeps groups aligned.
+  struct alignas(GROUP_WIDTH) control_block {
+    int8_t bytes[GROUP_WIDTH];
+  };
+
+  using control_allocator = typename std::allocator_traits<
+      Allocator>::template rebind_alloc<control_block>;
+  using cell_allocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<cell>;
+  using allocator_traits = std::allocator_traits<cell_allocator>;
+
+  // Whether a moved-to table can always take over the moved-from table's
+  // memory.
+  static constexpr bool ALWAYS_TAKES_MEMORY =
+      allocator_traits::propagate_on_container_move_assignment::value ||
+      allocator_traits::is_always_equal::value;
+
+  // Where the memory of the table comes from.
+  [[no_unique_address]] cell_allocator allocator;
+
+  /* Control byte values. Full slots hold H2 which is in [0, 127], so the sign
+  bit alone tells full slots apart from empty and deleted ones. */
+  static constexpr int8_t CONTROL_EMPTY = -128;
+  static constexpr int8_t CONTROL_DELETED = -2;
+
+  /* The table grows once 7/8 of the slots are either full or deleted so that
+  every probe sequence is guaranteed to reach an empty slot. */
+  static constexpr std::size_t MAX_LOAD_NUMERATOR = 7;
+  static constexpr std::size_t MAX_LOAD_DENOMINATOR = 8;
+
+  /* Number of groups moved out of the draining table per insertion or
+  removal. A doubled table has room for at least 7/16 of its slots in new
+  entries before it must grow again, while draining finishes after
+  (old capacity / (16 * 8)) operations, so draining always finishes first. */
+  static constexpr std::size_t GROUPS_MIGRATED_PER_OPERATION = 8;
+
+  static constexpr std::size_t NOT_FOUND = SIZE_MAX;
+
+  // A group of GROUP_WIDTH control bytes loaded for matching.
+  struct group {
+    explicit group(const int8_t* control);
+
+    // Bitmask of the slots in the group whose control byte equals h2.
+    uint32_t match(int8_t h2) const;
+
+    // Bitmask of the empty slots in the group.
+    uint32_t match_empty() const;
+
+    // Bitmask of the empty or deleted slots in the group.
+    uint32_t match_empty_or_deleted() const;
+
+#if defined(__SSE2__)
+    __m128i control_bytes;
+#else
+    int8_t control_bytes[GROUP_WIDTH];
+#endif
+  };
+
+  // A control byte array and the slot array it describes.
+  struct table {
+    // Control bytes, one per slot, aligned to GROUP_WIDTH.
+    int8_t* control = nullptr;
 
-  uint64_t hash_function(const K& key);
+    // Uninitialized storage for the slots; only full slots are constructed.
+    cell* slots = nullptr;
 
-  std::size_t original_num_of_buckets;
+    // Number of slots; zero or a power of two that is at least GROUP_WIDTH.
+    std::size_t capacity = 0;
 
+    // Number of empty slots that can still be filled before growing.
+    std::size_t growth_left = 0;
+  };
+
+  // The table new key-value pairs are inserted into.
+  table current;
+
+  // The table being moved into current; empty when not rehashing.
+  table draining;
+
+  // Index of the next group of the draining table to move.
+  std::size_t next_draining_group;
+
+  // Number of key-value pairs in both tables.
   std::size_t size;
 
-  const double MAX_LOAD_FACTOR = 3.0;
-  const std::size_t DYNAMIC_HASH_TABLE_RESIZE_FACTOR = 2;
+  uint64_t hash_function(const lookup_key& key) const;
+
+  // Splits a hash into the group probing starts at and the control byte.
+  static std::size_t h1(uint64_t hash);
+  static int8_t h2(uint64_t hash);
+
+  // Returns the slot index holding key in t or NOT_FOUND.
+  static std::size_t find_index(const table& t, const lookup_key& key,
+                                uint64_t hash);
+
+  // Returns the first empty or deleted slot on the probe sequence of hash.
+  static std::size_t find_insert_index(const table& t, uint64_t hash);
+
+  // Returns the cell holding key in either table or nullptr.
+  const cell* find_cell(const lookup_key& key) const;
+
+  /* Returns the slot index of current the key should be inserted into,
+  growing the table if needed. The key must not exist in the table. */
+  std::size_t prepare_insert(uint64_t hash);
+
+  // Shared implementation of both try_emplace overloads.
+  template <typename Key, typename... Args>
+  std::pair<V*, bool> emplace_unique(Key&& key, Args&&... args);
+
+  // Destroys the cell at index and marks its slot empty or deleted.
+  static void erase_at(table& t, std::size_t index);
+
+  /* Makes current a new table of new_capacity and starts draining the old
+  one into it. */
+  void start_rehash(std::size_t new_capacity);
+
+  // Moves up to group_count groups out of the draining table.
+  void migrate(std::size_t group_count);
+
+  // Moves a cell into a slot of current that is known to be free.
+  void move_into_current(cell& src, uint64_t hash);
+
+  // Allocates an empty table of the given capacity.
+  table allocate_table(std::size_t new_capacity);
+
+  // Destroys every key-value pair in t and releases its memory.
+  void release_table(table& t);
+
+  /* Inserts the entries of both of src's tables into a single new table, so
+  this starts out fully rehashed. The entries are moved if move_entries is
+  true and copied otherwise. This must be empty. */
+  void insert_all(const Hash_Table& src, bool move_entries);
+
+  // Releases both tables.
+  void release();
 };
 
 /*******************************************************************************
 CONSTRUCTORS
 *******************************************************************************/
-template <typename K, typename V>
-Hash_Table<K, V>::Hash_Table() {
-  this->ht = new Dynamic_Array<Linked_List<cell*>*>();
-  this->ht->set_resize_factor(DYNAMIC_HASH_TABLE_RESIZE_FACTOR);
-  this->original_num_of_buckets = this->ht->get_size();
+template <typename K, typename V, typename Allocator>
+Hash_Table<K, V, Allocator>::Hash_Table() : Hash_Table(Allocator()) {}
+
+template <typename K, typename V, typename Allocator>
+Hash_Table<K, V, Allocator>::Hash_Table(const Allocator& allocator)
+    : allocator(allocator) {
+  // No memory is allocated until the first insertion.
+  this->next_draining_group = 0;
   this->size = 0;
-
-  /* Insert nullptrs until maximum index reaches the size because we can only
-  access elements upto the maximum index. */
-  int next_maximum_index = ht->get_maximum_index() + 1;
-  for (int i = next_maximum_index; i < this->ht->get_size(); i++) {
-    this->ht->insert(nullptr, i);
-  }
 }
 
-template <typename K, typename V>
-Hash_Table<K, V>::Hash_Table(const Hash_Table& src) {
-  ~Hash_Table();
-
-  this->ht = src.ht;
-  this->original_num_of_buckets = src.original_num_of_buckets;
-  this->size = src.size;
+template <typename K, typename V, typename Allocator>
+Hash_Table<K, V, Allocator>::Hash_Table(const Hash_Table& src)
+    : Hash_Table(
+          src, std::allocator_traits<Allocator>::
+                   select_on_container_copy_construction(src.get_allocator())) {
 }
 
-template <typename K, typename V>
-Hash_Table<K, V>::Hash_Table(Hash_Table&& src) {
-  ~Hash_Table();
+template <typename K, typename V, typename Allocator>
+Hash_Table<K, V, Allocator>::Hash_Table(const Hash_Table& src,
+                                        const Allocator& allocator)
+    : Hash_Table(allocator) {
+  insert_all(src, false);
+}
 
-  this->ht = src.ht;
-  this->original_num_of_buckets = src.original_num_of_buckets;
+template <typename K, typename V, typename Allocator>
+Hash_Table<K, V, Allocator>::Hash_Table(Hash_Table&& src) noexcept
+    : allocator(std::move(src.allocator)) {
+  this->current = src.current;
+  this->draining = src.draining;
+  this->next_draining_group = src.next_draining_group;
   this->size = src.size;
 
-  src.ht = nullptr;
+  // Return the src Hash Table into a newly created state.
+  src.current = table();
+  src.draining = table();
+  src.next_draining_group = 0;
   src.size = 0;
 }
 
 /*******************************************************************************
 DESTRUCTOR
 *******************************************************************************/
-template <typename K, typename V>
-Hash_Table<K, V>::~Hash_Table() {
-  for (int da_i = 0; da_i <= this->ht->get_maximum_index(); da_i++) {
-    if ((*(this->ht))[da_i] != nullptr) {
-      for (std::size_t ll_i = 0; ll_i < (*(this->ht))[da_i]->get_size();
-           ll_i++) {
-        // Delete cells in linked list.
-        if ((*((*(this->ht))[da_i]))[ll_i] != nullptr) {
-          delete (*((*(this->ht))[da_i]))[ll_i];
-        }
+template <typename K, typename V, typename Allocator>
+Hash_Table<K, V, Allocator>::~Hash_Table() {
+  release();
+}
+
+/*******************************************************************************
+ GET FUNCTIONS FOR DATA STRUCTURE PROPERTIES
+*******************************************************************************/
+template <typename K, typename V, typename Allocator>
+std::size_t Hash_Table<K, V, Allocator>::get_size() const {
+  return this->size;
+}
+
+template <typename K, typename V, typename Allocator>
+std::size_t Hash_Table<K, V, Allocator>::get_capacity() const {
+  return this->current.capacity;
+}
+
+template <typename K, typename V, typename Allocator>
+bool Hash_Table<K, V, Allocator>::is_rehashing() const {
+  return this->draining.control != nullptr;
+}
+
+template <typename K, typename V, typename Allocator>
+Allocator Hash_Table<K, V, Allocator>::get_allocator() const {
+  return Allocator(this->allocator);
+}
+
+/*******************************************************************************
+DATA STRUCTURE OPERATIONS
+*******************************************************************************/
+template <typename K, typename V, typename Allocator>
+void Hash_Table<K, V, Allocator>::insert(const K& key, const V& value) {
+  // Place the value in the table only if key doesn't exist.
+  emplace_unique(key, value);
+}
+
+template <typename K, typename V, typename Allocator>
+template <typename... Args>
+std::pair<V*, bool> Hash_Table<K, V, Allocator>::try_emplace(
+    const K& key, Args&&... args) {
+  return emplace_unique(key, std::forward<Args>(args)...);
+}
+
+template <typename K, typename V, typename Allocator>
+template <typename... Args>
+std::pair<V*, bool> Hash_Table<K, V, Allocator>::try_emplace(K&& key,
+                                                              Args&&... args) {
+  return emplace_unique(std::move(key), std::forward<Args>(args)...);
+}
+
+template <typename K, typename V, typename Allocator>
+void Hash_Table<K, V, Allocator>::remove(const lookup_key& key) {
+  migrate(GROUPS_MIGRATED_PER_OPERATION);
+
+  uint64_t hash = hash_function(key);
+
+  std::size_t index = find_index(this->current, key, hash);
+  if (index != NOT_FOUND) {
+    erase_at(this->current, index);
+    this->size--;
+    return;
+  }
+
+  index = find_index(this->draining, key, hash);
+  if (index != NOT_FOUND) {
+    erase_at(this->draining, index);
+    this->size--;
+  }
+}
+
+template <typename K, typename V, typename Allocator>
+void Hash_Table<K, V, Allocator>::replace(const K& key, const V& value) {
+  remove(key);
+  insert(key, value);
+}
+
+template <typename K, typename V, typename Allocator>
+V* Hash_Table<K, V, Allocator>::search(const lookup_key& key) {
+  return const_cast<V*>(std::as_const(*this).search(key));
+}
+
+template <typename K, typename V, typename Allocator>
+const V* Hash_Table<K, V, Allocator>::search(const lookup_key& key) const {
+  const cell* c = find_cell(key);
+
+  if (c == nullptr) {
+    return nullptr;
+  }
+
+  return &(c->value);
+}
+
+template <typename K, typename V, typename Allocator>
+V& Hash_Table<K, V, Allocator>::find(const lookup_key& key) {
+  return const_cast<V&>(std::as_const(*this).find(key));
+}
+
+template <typename K, typename V, typename Allocator>
+const V& Hash_Table<K, V, Allocator>::find(const lookup_key& key) const {
+  const V* value = search(key);
+
+  if (value == nullptr) {
+    throw std::out_of_range("Tried to find a key that doesn't exist.");
+  }
+
+  return *value;
+}
+
+template <typename K, typename V, typename Allocator>
+bool Hash_Table<K, V, Allocator>::contains(const lookup_key& key) const {
+  return find_cell(key) != nullptr;
+}
+
+template <typename K, typename V, typename Allocator>
+template <typename F>
+void Hash_Table<K, V, Allocator>::for_each(F&& visit) const {
+  // Entries not yet moved out of the draining table are still live there.
+  for (const table* t : {&this->current, &this->draining}) {
+    for (std::size_t i = 0; i < t->capacity; i++) {
+      if (t->control[i] >= 0) {
+        visit(t->slots[i].key, t->slots[i].value);
       }
     }
+  }
+}
 
-    // Delete linked list in the dynamic array.
-    if ((*(this->ht))[da_i] != nullptr) {
-      delete (*(this->ht))[da_i];
+/*******************************************************************************
+DATA STRUCTURE OPERATOR OVERLOADS
+*******************************************************************************/
+template <typename K, typename V, typename Allocator>
+Hash_Table<K, V, Allocator>& Hash_Table<K, V, Allocator>::operator=(
+    const Hash_Table& src) {
+  if (this != &src) {
+    if constexpr (allocator_traits::propagate_on_container_copy_assignment::
+                      value) {
+      // This' memory must be freed by the allocator it came from before the
+      // allocator is replaced by src's.
+      if (this->allocator != src.allocator) {
+        release();
+      }
+      this->allocator = src.allocator;
     }
+
+    // Copy into a temporary first so that this Hash Table is unchanged if
+    // copying throws, then take over the temporary's tables, which came from
+    // the same allocator.
+    Hash_Table copy(src, get_allocator());
+    *this = std::move(copy);
   }
 
-  // Delete the dynamic array.
-  if (ht != nullptr) {
-    delete ht;
+  return *this;
+}
+
+template <typename K, typename V, typename Allocator>
+Hash_Table<K, V, Allocator>& Hash_Table<K, V, Allocator>::operator=(
+    Hash_Table&& src) noexcept(ALWAYS_TAKES_MEMORY) {
+  if (this == &src) {
+    return *this;
   }
+
+  release();
+
+  if constexpr (!ALWAYS_TAKES_MEMORY) {
+    // src's memory can't be freed by this' allocator, so move the entries
+    // into memory from this' allocator instead.
+    if (this->allocator != src.allocator) {
+      insert_all(src, true);
+      src.release();
+      return *this;
+    }
+  }
+
+  if constexpr (allocator_traits::propagate_on_container_move_assignment::
+                    value) {
+    this->allocator = std::move(src.allocator);
+  }
+
+  this->current = src.current;
+  this->draining = src.draining;
+  this->next_draining_group = src.next_draining_group;
+  this->size = src.size;
+
+  // Return the src Hash Table into a newly created state.
+  src.current = table();
+  src.draining = table();
+  src.next_draining_group = 0;
+  src.size = 0;
+
+  return *this;
 }
 
 /*******************************************************************************
-DATA STRUCTURE OPERATIONS
+GROUP MATCHING
 *******************************************************************************/
-template <typename K, typename V>
-void Hash_Table<K, V>::insert(const K& key, const V& value) {
-  /* Check the load factor which is the number of entries (size of the hash
-  table) / number of buckets (length of dynamic array). If it is higher than
-  the maximum load factor, increase the length of the dynamic array. */
-  double load_factor = ((double)(this->size + 1)) / ((double)ht->get_size());
-
-  if (load_factor > MAX_LOAD_FACTOR) {
-    /* Insert nullptrs until maximum index reaches the next size because we
-    can only access elements upto the maximum index and we want to grow the
-    array because the load factor is higher than the maximum. */
-    int next_maximum_index = this->ht->get_maximum_index() + 1;
-    int next_size = this->ht->get_size() * DYNAMIC_HASH_TABLE_RESIZE_FACTOR;
-    for (int i = next_maximum_index; i < next_size; i++) {
-      this->ht->insert(nullptr, i);
+#if defined(__SSE2__)
+
+template <typename K, typename V, typename Allocator>
+Hash_Table<K, V, Allocator>::group::group(const int8_t* control) {
+  // Groups always start at a multiple of GROUP_WIDTH so the load is aligned.
+  control_bytes = _mm_load_si128(reinterpret_cast<const __m128i*>(control));
+}
+
+template <typename K, typename V, typename Allocator>
+uint32_t Hash_Table<K, V, Allocator>::group::match(int8_t h2) const {
+  return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), control_bytes));
+}
+
+template <typename K, typename V, typename Allocator>
+uint32_t Hash_Table<K, V, Allocator>::group::match_empty() const {
+  return _mm_movemask_epi8(
+      _mm_cmpeq_epi8(_mm_set1_epi8(CONTROL_EMPTY), control_bytes));
+}
+
+template <typename K, typename V, typename Allocator>
+uint32_t Hash_Table<K, V, Allocator>::group::match_empty_or_deleted() const {
+  // Empty and deleted slots are exactly those with the sign bit set.
+  return _mm_movemask_epi8(control_bytes);
+}
+
+#else
+
+template <typename K, typename V, typename Allocator>
+Hash_Table<K, V, Allocator>::group::group(const int8_t* control) {
+  std::memcpy(control_bytes, control, GROUP_WIDTH);
+}
+
+template <typename K, typename V, typename Allocator>
+uint32_t Hash_Table<K, V, Allocator>::group::match(int8_t h2) const {
+  uint32_t mask = 0;
+  for (std::size_t i = 0; i < GROUP_WIDTH; i++) {
+    mask |= ((uint32_t)(control_bytes[i] == h2)) << i;
+  }
+  return mask;
+}
+
+template <typename K, typename V, typename Allocator>
+uint32_t Hash_Table<K, V, Allocator>::group::match_empty() const {
+  return match(CONTROL_EMPTY);
+}
+
+template <typename K, typename V, typename Allocator>
+uint32_t Hash_Table<K, V, Allocator>::group::match_empty_or_deleted() const {
+  uint32_t mask = 0;
+  for (std::size_t i = 0; i < GROUP_WIDTH; i++) {
+    mask |= ((uint32_t)(control_bytes[i] < 0)) << i;
+  }
+  return mask;
+}
+
+#endif
+
+/*******************************************************************************
+HASH FUNCTION
+*******************************************************************************/
+template <typename K, typename V, typename Allocator>
+uint64_t Hash_Table<K, V, Allocator>::hash_function(
+    const lookup_key& key) const {
+  /* std::hash is the identity for integers on common implementations, so mix
+  the bits; both H1 and H2 need well-distributed bits. The mixing is a
+  bijection, so it never adds collisions to an already good hash. */
+  uint64_t hash = Hash_Table_Key<K>::hash(key);
+  hash *= 0x9E3779B97F4A7C15ULL;
+  return hash ^ (hash >> 32);
+}
+
+template <typename K, typename V, typename Allocator>
+std::size_t Hash_Table<K, V, Allocator>::h1(uint64_t hash) {
+  return (std::size_t)(hash >> 7);
+}
+
+template <typename K, typename V, typename Allocator>
+int8_t Hash_Table<K, V, Allocator>::h2(uint64_t hash) {
+  return (int8_t)(hash & 0x7F);
+}
+
+/*******************************************************************************
+PRIVATE DECLARATIONS
+*******************************************************************************/
+template <typename K, typename V, typename Allocator>
+std::size_t Hash_Table<K, V, Allocator>::find_index(const table& t,
+                                                    const lookup_key& key,
+                                                    uint64_t hash) {
+  if (t.capacity == 0) {
+    return NOT_FOUND;
+  }
+
+  /* Probe whole groups with a triangular sequence (+1, +2, +3, ... groups),
+  which visits every group when the number of groups is a power of two. */
+  std::size_t group_mask = (t.capacity / GROUP_WIDTH) - 1;
+  std::size_t group_index = h1(hash) & group_mask;
+  int8_t control_h2 = h2(hash);
+
+  for (std::size_t step = 1;; step++) {
+    std::size_t group_start = group_index * GROUP_WIDTH;
+    group g(t.control + group_start);
+
+    for (uint32_t mask = g.match(control_h2); mask != 0; mask &= (mask - 1)) {
+      std::size_t index = group_start + std::countr_zero(mask);
+      if (t.slots[index].key == key) {
+        return index;
+      }
+    }
+
+    // The key would have been placed in this group's empty slot.
+    if (g.match_empty() != 0) {
+      return NOT_FOUND;
     }
+
+    group_index = (group_index + step) & group_mask;
   }
+}
 
-  /* Hash the key then take the modulo to determine the bucket the key-value
-  pair belongs to. */
-  uint64_t bucket_index = hash_function(key) % ht->get_size();
+template <typename K, typename V, typename Allocator>
+std::size_t Hash_Table<K, V, Allocator>::find_insert_index(const table& t,
+                                                           uint64_t hash) {
+  if (t.capacity == 0) {
+    return NOT_FOUND;
+  }
 
-  // Place the value in the bucket only if key doesn't exist.
-  if (this->search(key) == nullptr) {
-    if ((*(this->ht))[bucket_index] == nullptr) {
-      (*(this->ht))[bucket_index] = new Linked_List<cell*>;
+  std::size_t group_mask = (t.capacity / GROUP_WIDTH) - 1;
+  std::size_t group_index = h1(hash) & group_mask;
+
+  for (std::size_t step = 1;; step++) {
+    std::size_t group_start = group_index * GROUP_WIDTH;
+    uint32_t mask = group(t.control + group_start).match_empty_or_deleted();
+
+    if (mask != 0) {
+      return group_start + std::countr_zero(mask);
     }
 
-    cell* cell_to_be_inserted = new cell;
-    cell_to_be_inserted->key = key;
-    cell_to_be_inserted->value = value;
-    (*(this->ht))[bucket_index]->insert(cell_to_be_inserted);
+    group_index = (group_index + step) & group_mask;
   }
+}
 
-  this->size++;
+template <typename K, typename V, typename Allocator>
+const typename Hash_Table<K, V, Allocator>::cell*
+Hash_Table<K, V, Allocator>::find_cell(const lookup_key& key) const {
+  uint64_t hash = hash_function(key);
+
+  std::size_t index = find_index(this->current, key, hash);
+  if (index != NOT_FOUND) {
+    return &(this->current.slots[index]);
+  }
+
+  // Entries that haven't been moved yet are still in the draining table.
+  index = find_index(this->draining, key, hash);
+  if (index != NOT_FOUND) {
+    return &(this->draining.slots[index]);
+  }
+
+  return nullptr;
 }
 
-template <typename K, typename V>
-void Hash_Table<K, V>::remove(const K& key) {
-  uint64_t size_divisor_power = 0;
-
-  while (true) {
-    /* Hash the key then take the modulo to determine the bucket the key-
-    value pair belongs to. */
-    uint64_t divided_size =
-        (ht->get_size() /
-         pow(DYNAMIC_HASH_TABLE_RESIZE_FACTOR, size_divisor_power));
-    uint64_t bucket_index = hash_function(key) % divided_size;
-
-    // Look thru linked list at index for the key.
-    if (((*(this->ht))[bucket_index]) != nullptr) {
-      for (int i = 0; i < (*((*(this->ht))[bucket_index])).get_size(); i++) {
-        if ((*((*(this->ht))[bucket_index]))[i]->key == key) {
-          delete (*((*(this->ht))[bucket_index]))[i];
-          (*((*(this->ht))[bucket_index])).remove(i);
-          this->size--;
-          return;
-        }
-      }
+template <typename K, typename V, typename Allocator>
+std::size_t Hash_Table<K, V, Allocator>::prepare_insert(uint64_t hash) {
+  std::size_t index = find_insert_index(this->current, hash);
+
+  /* Filling a deleted slot doesn't lengthen any probe sequence, but filling an
+  empty one does; grow (or clean out deleted slots) once no more empty slots
+  may be filled. */
+  if ((this->current.capacity == 0) ||
+      ((this->current.control[index] == CONTROL_EMPTY) &&
+       (this->current.growth_left == 0))) {
+    // Only one table is ever draining at a time.
+    migrate(SIZE_MAX);
+
+    std::size_t max_load =
+        (this->current.capacity * MAX_LOAD_NUMERATOR) / MAX_LOAD_DENOMINATOR;
+
+    if (this->current.capacity == 0) {
+      this->current = allocate_table(GROUP_WIDTH);
+    } else if (this->size < (max_load / 2)) {
+      // Mostly deleted slots; rehashing at the same capacity reclaims them.
+      start_rehash(this->current.capacity);
+    } else {
+      start_rehash(this->current.capacity * 2);
     }
 
-    // Stop if the size we reached was the original size of the hash table.
-    if (divided_size == this->original_num_of_buckets) {
-      break;
-    }
+    index = find_insert_index(this->current, hash);
+  }
 
-    // We must cycle thru different sizes because we are doing lazy hashing.
-    size_divisor_power++;
+  return index;
+}
+
+template <typename K, typename V, typename Allocator>
+template <typename Key, typename... Args>
+std::pair<V*, bool> Hash_Table<K, V, Allocator>::emplace_unique(
+    Key&& key, Args&&... args) {
+  migrate(GROUPS_MIGRATED_PER_OPERATION);
+
+  uint64_t hash = hash_function(key);
+
+  const cell* existing = find_cell(key);
+  if (existing != nullptr) {
+    return {const_cast<V*>(&(existing->value)), false};
+  }
+
+  std::size_t index = prepare_insert(hash);
+
+  ::new (static_cast<void*>(this->current.slots + index))
+      cell{K(std::forward<Key>(key)), V(std::forward<Args>(args)...)};
+
+  if (this->current.control[index] == CONTROL_EMPTY) {
+    this->current.growth_left--;
   }
+  this->current.control[index] = h2(hash);
+  this->size++;
 
-  return;
+  return {&(this->current.slots[index].value), true};
 }
 
-template <typename K, typename V>
-void Hash_Table<K, V>::replace(const K& key, const V& value) {
-  remove(key);
-  insert(key, value);
+template <typename K, typename V, typename Allocator>
+void Hash_Table<K, V, Allocator>::erase_at(table& t, std::size_t index) {
+  t.slots[index].~cell();
+
+  /* A probe sequence only continues past a group that has no empty slots. If
+  this slot's group already has an empty slot, no probe sequence passes
+  through it, so the slot can become empty again. Otherwise it must become
+  a deleted slot so that lookups keep probing past it. */
+  std::size_t group_start = index & ~(GROUP_WIDTH - 1);
+  if (group(t.control + group_start).match_empty() != 0) {
+    t.control[index] = CONTROL_EMPTY;
+    t.growth_left++;
+  } else {
+    t.control[index] = CONTROL_DELETED;
+  }
 }
 
-template <typename K, typename V>
-V* Hash_Table<K, V>::search(const K& key) {
-  uint64_t size_divisor_power = 0;
-
-  while (true) {
-    /* Hash the key then take the modulo to determine the bucket the key-
-    value pair belongs to. */
-    uint64_t divided_size =
-        (ht->get_size() /
-         pow(DYNAMIC_HASH_TABLE_RESIZE_FACTOR, size_divisor_power));
-    uint64_t bucket_index = hash_function(key) % divided_size;
-
-    /* The expected bucket index is the index we expect the key-value pair
-    to be in based on the current number of buckets. */
-    uint64_t expected_bucket_index = (hash_function(key) % ht->get_size());
-
-    // Look thru linked list at index for the key.
-    if (((*(this->ht))[bucket_index]) != nullptr) {
-      for (int i = 0; i < (*((*(this->ht))[bucket_index])).get_size(); i++) {
-        if ((*((*(this->ht))[bucket_index]))[i]->key == key) {
-          V value = (*((*(this->ht))[bucket_index]))[i]->value;
-
-          // Get a heap-allocated pointer to the value to return.
-          V* return_val = new V;
-          *return_val = value;
-
-          /* Lazy rehashing - move the key-value pair to the expected
-          bucket index. We only move the key-value pairs being searched
-          for instead of having to do a huge copy on growth of the hash
-          table. */
-          if (expected_bucket_index != bucket_index) {
-            if ((*(this->ht))[expected_bucket_index] == nullptr) {
-              (*(this->ht))[expected_bucket_index] = new Linked_List<cell*>;
-            }
-
-            (*(this->ht))[expected_bucket_index]->insert(
-                (*((*(this->ht))[bucket_index]))[i]);
-            (*((*(this->ht))[bucket_index])).remove(i);
-          }
+template <typename K, typename V, typename Allocator>
+void Hash_Table<K, V, Allocator>::start_rehash(std::size_t new_capacity) {
+  this->draining = this->current;
+  this->next_draining_group = 0;
+
+  try {
+    this->current = allocate_table(new_capacity);
+  } catch (...) {
+    this->current = this->draining;
+    this->draining = table();
+    throw;
+  }
+}
 
-          return return_val;
-        }
+template <typename K, typename V, typename Allocator>
+void Hash_Table<K, V, Allocator>::migrate(std::size_t group_count) {
+  if (this->draining.control == nullptr) {
+    return;
+  }
+
+  std::size_t group_total = this->draining.capacity / GROUP_WIDTH;
+
+  for (; (group_count > 0) && (this->next_draining_group < group_total);
+       group_count--, this->next_draining_group++) {
+    std::size_t group_start = this->next_draining_group * GROUP_WIDTH;
+
+    for (std::size_t i = group_start; i < (group_start + GROUP_WIDTH); i++) {
+      if (this->draining.control[i] >= 0) {
+        move_into_current(this->draining.slots[i],
+                          hash_function(this->draining.slots[i].key));
+
+        /* Moved slots become deleted rather than empty so that lookups of
+        entries further along the same probe sequence in the draining table
+        keep probing past them. */
+        this->draining.slots[i].~cell();
+        this->draining.control[i] = CONTROL_DELETED;
       }
     }
+  }
 
-    // Stop if the size we reached was the original size of the hash table.
-    if (divided_size == this->original_num_of_buckets) {
-      break;
-    }
+  // Every entry has been moved; the draining table's memory can be released.
+  if (this->next_draining_group == group_total) {
+    release_table(this->draining);
+    this->next_draining_group = 0;
+  }
+}
+
+template <typename K, typename V, typename Allocator>
+void Hash_Table<K, V, Allocator>::move_into_current(cell& src, uint64_t hash) {
+  std::size_t index = find_insert_index(this->current, hash);
 
-    // We must cycle thru different sizes because we are doing lazy hashing.
-    size_divisor_power++;
+  ::new (static_cast<void*>(this->current.slots + index))
+      cell{std::move(src.key), std::move(src.value)};
+
+  if (this->current.control[index] == CONTROL_EMPTY) {
+    this->current.growth_left--;
   }
+  this->current.control[index] = h2(hash);
+}
 
-  return nullptr;
+template <typename K, typename V, typename Allocator>
+typename Hash_Table<K, V, Allocator>::table
+Hash_Table<K, V, Allocator>::allocate_table(std::size_t new_capacity) {
+  table t;
+
+  control_allocator controls(this->allocator);
+  t.control = reinterpret_cast<int8_t*>(
+      std::allocator_traits<control_allocator>::allocate(
+          controls, new_capacity / GROUP_WIDTH));
+  try {
+    t.slots = allocator_traits::allocate(this->allocator, new_capacity);
+  } catch (...) {
+    std::allocator_traits<control_allocator>::deallocate(
+        controls, reinterpret_cast<control_block*>(t.control),
+        new_capacity / GROUP_WIDTH);
+    throw;
+  }
+
+  std::memset(t.control, CONTROL_EMPTY, new_capacity);
+  t.capacity = new_capacity;
+  t.growth_left = (new_capacity * MAX_LOAD_NUMERATOR) / MAX_LOAD_DENOMINATOR;
+
+  return t;
 }
 
-/*******************************************************************************
-DATA STRUCTURE OPERATOR OVERLOADS
-*******************************************************************************/
-template <typename K, typename V>
-Hash_Table<K, V>& Hash_Table<K, V>::operator=(const Hash_Table& src) {
-  ~Hash_Table();
+template <typename K, typename V, typename Allocator>
+void Hash_Table<K, V, Allocator>::release_table(table& t) {
+  if (t.control == nullptr) {
+    return;
+  }
 
-  this->ht = src.ht;
-  this->original_num_of_buckets = src.original_num_of_buckets;
-  this->size = src.size;
+  for (std::size_t i = 0; i < t.capacity; i++) {
+    if (t.control[i] >= 0) {
+      t.slots[i].~cell();
+    }
+  }
+
+  control_allocator controls(this->allocator);
+  std::allocator_traits<control_allocator>::deallocate(
+      controls, reinterpret_cast<control_block*>(t.control),
+      t.capacity / GROUP_WIDTH);
+  allocator_traits::deallocate(this->allocator, t.slots, t.capacity);
+
+  t = table();
 }
 
-template <typename K, typename V>
-Hash_Table<K, V>& Hash_Table<K, V>::operator=(Hash_Table&& src) noexcept {
-  ~Hash_Table();
+template <typename K, typename V, typename Allocator>
+void Hash_Table<K, V, Allocator>::insert_all(const Hash_Table& src,
+                                             bool move_entries) {
+  if (src.size == 0) {
+    return;
+  }
 
-  this->ht = src.ht;
-  this->original_num_of_buckets = src.original_num_of_buckets;
-  this->size = src.size;
+  this->current = allocate_table(src.current.capacity);
+
+  try {
+    for (const table* t : {&src.current, &src.draining}) {
+      for (std::size_t i = 0; i < t->capacity; i++) {
+        if (t->control[i] >= 0) {
+          std::size_t index = find_insert_index(
+              this->current, hash_function(t->slots[i].key));
+          cell& entry = const_cast<cell&>(t->slots[i]);
+          if (move_entries) {
+            ::new (static_cast<void*>(this->current.slots + index))
+                cell{std::move(entry.key), std::move(entry.value)};
+          } else {
+            ::new (static_cast<void*>(this->current.slots + index))
+                cell(entry);
+          }
+          this->current.control[index] = t->control[i];
+          this->current.growth_left--;
+          this->size++;
+        }
+      }
+    }
+  } catch (...) {
+    release();
+    throw;
+  }
+}
 
-  src.ht = nullptr;
-  src.size = 0;
+template <typename K, typename V, typename Allocator>
+void Hash_Table<K, V, Allocator>::release() {
+  release_table(this->current);
+  release_table(this->draining);
+  this->next_draining_group = 0;
+  this->size = 0;
 }
 
-/*******************************************************************************
-HASH FUNCTION
-*******************************************************************************/
+namespace lox_pmr {
+
+// A Hash_Table whose memory comes from a std::pmr::memory_resource.
 template <typename K, typename V>
-std::size_t Hash_Table<K, V>::hash_function(const K& key) {
-  return std::hash<K>{}(key);
-}
+using Hash_Table =
+    ::Hash_Table<K, V, std::pmr::polymorphic_allocator<std::pair<const K, V>>>;
+
+}  // namespace lox_pmr
@@ -1,28 +1,63 @@
+#pragma once
+
 #include <stddef.h>
 
+#include <iterator>
+#include <memory>
+#include <memory_resource>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 /*******************************************************************************
 Template declarations and definitions must be kept in header only to avoid
 linking errors.
+
+Nodes come from a pool owned by the list: they are carved out of slabs of
+several nodes each, allocated with the Allocator rebound to the node type, and
+removed nodes go on a free list to be reused by the next insertion, so the
+allocator is only called once per slab. Slabs are returned to the allocator
+when the list is destroyed. The allocator follows the same propagation rules
+as Dynamic_Array's. lox_pmr::Linked_List is the list on a
+std::pmr::memory_resource.
+
+Traversals should use the bidirectional iterators, which step from node to
+node; indexing walks from the nearer end of the list.
 *******************************************************************************/
 
-template <typename T>
+template <typename T, typename Allocator = std::allocator<T>>
 class Linked_List {
+  struct cell;
+
  public:
+  using allocator_type = Allocator;
+
+  template <bool CONSTANT>
+  class basic_iterator;
+
+  using iterator = basic_iterator<false>;
+  using const_iterator = basic_iterator<true>;
+
   /***********************************************************************
   CONSTRUCTORS
   ***********************************************************************/
   // Default Constructor
   Linked_List();
 
+  // Constructs an empty linked list whose nodes come from allocator.
+  explicit Linked_List(const Allocator& allocator);
+
   // Copy Constructor - l-value reference (&)
   // Copies the values from the provided Linked List into this Linked List
   Linked_List(const Linked_List& src);
 
+  // Copies the values from the provided Linked List into nodes from
+  // allocator.
+  Linked_List(const Linked_List& src, const Allocator& allocator);
+
   // Move Constructor - r-value reference (&&)
   // Moves the values from the provided Linked List into this Linked List
-  Linked_List(Linked_List&& src);
+  Linked_List(Linked_List&& src) noexcept;
 
   /***********************************************************************
   DESTRUCTOR
@@ -33,7 +68,18 @@ class Linked_List {
    GET FUNCTIONS FOR DATA STRUCTURE PROPERTIES
   ***********************************************************************/
   // Returns the current size of the linked list.
-  std::size_t get_size();
+  std::size_t get_size() const;
+
+  // Returns the allocator the linked list's nodes come from.
+  Allocator get_allocator() const;
+
+  /***********************************************************************
+  BEGIN AND END ITERATORS
+  ***********************************************************************/
+  iterator begin();
+  iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
 
   /***********************************************************************
   DATA STRUCTURE OPERATIONS
@@ -44,15 +90,36 @@ class Linked_List {
   // Inserts data of type T into the linked list (at the specified index).
   void insert(const T& data, std::size_t index);
 
+  // Inserts data of type T before position and returns an iterator to it.
+  iterator insert(const_iterator position, const T& data);
+
   // Remove node at the end of the linked list.
   void remove();
 
   // Removes data at the specified index
   void remove(std::size_t index);
 
+  // Removes the node at position and returns an iterator to the node after
+  // it.
+  iterator erase(const_iterator position);
+
+  /* Moves all of other's nodes before position, leaving other empty. The
+  nodes are relinked rather than copied and other's slabs become this
+  list's. If the lists' allocators differ, the values are moved instead. */
+  void splice(const_iterator position, Linked_List& other);
+
+  /* Moves the node at element of other before position. Within one list the
+  node is relinked; from another list its value is moved into a node of this
+  list. */
+  void splice(const_iterator position, Linked_List& other,
+              const_iterator element);
+
   // Replaces data of type T in the linked list at given index.
   void replace(T& data, std::size_t index);
 
+  // Removes every node; the nodes are kept to be reused.
+  void clear();
+
   /***********************************************************************
   DATA STRUCTURE OPERATOR OVERLOADS
   ***********************************************************************/
@@ -60,7 +127,7 @@ class Linked_List {
 
   Linked_List& operator=(const Linked_List& src);
 
-  Linked_List& operator=(Linked_List&& src) noexcept;
+  Linked_List& operator=(Linked_List&& src) noexcept(ALWAYS_TAKES_NODES);
 
  private:
   struct cell {
@@ -69,291 +136,630 @@ class Linked_List {
     cell* right;
   };
 
+  // What an unused node holds while it is on the free list.
+  struct free_cell {
+    free_cell* next;
+  };
+
+  // A block of nodes allocated at once.
+  struct slab {
+    cell* cells;
+    std::size_t count;
+    slab* next;
+  };
+
+  // The number of nodes in the first slab; each slab after it doubles in
+  // size up to MAX_SLAB_CELLS.
+  static constexpr std::size_t FIRST_SLAB_CELLS = 4;
+  static constexpr std::size_t MAX_SLAB_CELLS = 256;
+
+  using cell_allocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<cell>;
+  using cell_allocator_traits = std::allocator_traits<cell_allocator>;
+  using slab_allocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<slab>;
+
+  // Whether a moved-to list can always take over the moved-from list's nodes.
+  static constexpr bool ALWAYS_TAKES_NODES =
+      cell_allocator_traits::propagate_on_container_move_assignment::value ||
+      cell_allocator_traits::is_always_equal::value;
+
+  // Where the nodes of the list come from.
+  [[no_unique_address]] cell_allocator allocator;
+
   std::size_t size;
 
   cell* polar_left;
 
   cell* polar_right;
+
+  // Nodes that are allocated but not in the list.
+  free_cell* free_cells;
+
+  // Every slab the nodes were carved out of.
+  slab* slabs;
+
+  std::size_t next_slab_cells;
+
+  // Takes a node from the pool and constructs its data from args.
+  template <typename... Args>
+  cell* create_cell(Args&&... args);
+
+  // Destroys a node's data and returns the node to the pool.
+  void destroy_cell(cell* c);
+
+  // Allocates a slab and puts its nodes on the free list.
+  void add_slab();
+
+  // Returns every slab to the allocator; the list must be empty.
+  void release_slabs();
+
+  // Links the unlinked node c in before position, or at the end if position
+  // is nullptr.
+  void link_before(cell* position, cell* c);
+
+  // Unlinks c from the list without destroying it.
+  void unlink(cell* c);
+
+  // Returns the node at index, walking from the nearer end.
+  cell* cell_at(std::size_t index) const;
+
+  // Appends copies of src's values.
+  void append_all(const Linked_List& src);
+
+  // Takes over src's nodes and pool; this must have neither.
+  void take_nodes(Linked_List& src);
+};
+
+/*******************************************************************************
+ITERATORS
+*******************************************************************************/
+template <typename T, typename Allocator>
+template <bool CONSTANT>
+class Linked_List<T, Allocator>::basic_iterator {
+ public:
+  using iterator_category = std::bidirectional_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = std::conditional_t<CONSTANT, const T*, T*>;
+  using reference = std::conditional_t<CONSTANT, const T&, T&>;
+
+  basic_iterator() = default;
+
+  // A const_iterator can be made from an iterator.
+  template <bool OTHER>
+    requires(CONSTANT && !OTHER)
+  basic_iterator(const basic_iterator<OTHER>& other)
+      : list(other.list), current(other.current) {}
+
+  reference operator*() const { return this->current->data; }
+  pointer operator->() const { return &(this->current->data); }
+
+  basic_iterator& operator++() {
+    this->current = this->current->right;
+    return *this;
+  }
+
+  basic_iterator operator++(int) {
+    basic_iterator previous = *this;
+    ++*this;
+    return previous;
+  }
+
+  basic_iterator& operator--() {
+    // The end iterator steps back to the last node.
+    this->current = (this->current == nullptr) ? this->list->polar_right
+                                               : this->current->left;
+    return *this;
+  }
+
+  basic_iterator operator--(int) {
+    basic_iterator previous = *this;
+    --*this;
+    return previous;
+  }
+
+  bool operator==(const basic_iterator& other) const {
+    return this->current == other.current;
+  }
+
+ private:
+  friend class Linked_List;
+  template <bool>
+  friend class basic_iterator;
+
+  basic_iterator(const Linked_List* list, cell* current)
+      : list(list), current(current) {}
+
+  const Linked_List* list = nullptr;
+
+  // The node the iterator is at; nullptr at the end.
+  cell* current = nullptr;
 };
 
 /*******************************************************************************
 CONSTRUCTORS
 *******************************************************************************/
-template <typename T>
-Linked_List<T>::Linked_List() {
+template <typename T, typename Allocator>
+Linked_List<T, Allocator>::Linked_List() : Linked_List(Allocator()) {}
+
+template <typename T, typename Allocator>
+Linked_List<T, Allocator>::Linked_List(const Allocator& allocator)
+    : allocator(allocator) {
   this->size = 0;
   this->polar_left = nullptr;
   this->polar_right = nullptr;
+  this->free_cells = nullptr;
+  this->slabs = nullptr;
+  this->next_slab_cells = FIRST_SLAB_CELLS;
 }
 
-template <typename T>
-Linked_List<T>::Linked_List(const Linked_List& src) {
-  ~Linked_List();
-
-  // Copy src's pointers.
-  this->size = src.size;
-  this->polar_left = src.polar_left;
-  this->polar_right = src.polar_right;
+template <typename T, typename Allocator>
+Linked_List<T, Allocator>::Linked_List(const Linked_List& src)
+    : Linked_List(
+          src, std::allocator_traits<Allocator>::
+                   select_on_container_copy_construction(src.get_allocator())) {
 }
 
-template <typename T>
-Linked_List<T>::Linked_List(Linked_List&& src) {
-  ~Linked_List();
-
-  // Copy src's pointers.
-  this->size = src.size;
-  this->polar_left = src.polar_left;
-  this->polar_right = src.polar_right;
+template <typename T, typename Allocator>
+Linked_List<T, Allocator>::Linked_List(const Linked_List& src,
+                                       const Allocator& allocator)
+    : Linked_List(allocator) {
+  // Copy src's values into nodes of this Linked List.
+  try {
+    append_all(src);
+  } catch (...) {
+    clear();
+    release_slabs();
+    throw;
+  }
+}
 
-  // Return the src Linked List into a newly created state.
-  src.size = 0;
-  src.polar_left = nullptr;
-  src.polar_right = nullptr;
+template <typename T, typename Allocator>
+Linked_List<T, Allocator>::Linked_List(Linked_List&& src) noexcept
+    : Linked_List(Allocator(src.allocator)) {
+  take_nodes(src);
 }
 
 /*******************************************************************************
 DESTRUCTOR
 *******************************************************************************/
-template <typename T>
-Linked_List<T>::~Linked_List() {
-  // Keep removing the last element until the linked list is empty.
-  while (this->size != 0) {
-    remove();
-  }
+template <typename T, typename Allocator>
+Linked_List<T, Allocator>::~Linked_List() {
+  clear();
+  release_slabs();
 }
 
 /*******************************************************************************
  GET FUNCTIONS FOR DATA STRUCTURE PROPERTIES
 *******************************************************************************/
-template <typename T>
-std::size_t Linked_List<T>::get_size() {
+template <typename T, typename Allocator>
+std::size_t Linked_List<T, Allocator>::get_size() const {
   return this->size;
 }
 
+template <typename T, typename Allocator>
+Allocator Linked_List<T, Allocator>::get_allocator() const {
+  return Allocator(this->allocator);
+}
+
 /*******************************************************************************
-DATA STRUCTURE OPERATIONS
+BEGIN AND END ITERATORS
 *******************************************************************************/
-template <typename T>
-void Linked_List<T>::insert(const T& data) {
-  cell* to_be_inserted = new cell;
-  to_be_inserted->data = data;
-  to_be_inserted->left = nullptr;
-  to_be_inserted->right = nullptr;
-
-  /* If polar left and polar right is null then this is the first element
-  being inserted and is now both polar left and polar right. */
-  if ((this->polar_left == nullptr) && (this->polar_right == nullptr)) {
-    polar_left = to_be_inserted;
-    polar_right = to_be_inserted;
+template <typename T, typename Allocator>
+typename Linked_List<T, Allocator>::iterator
+Linked_List<T, Allocator>::begin() {
+  return iterator(this, this->polar_left);
+}
 
-  } else {
-    // Just append to the end of the linked list (polar right).
-    cell* prev_polar_right = polar_right;
-    to_be_inserted->left = prev_polar_right;
-    prev_polar_right->right = to_be_inserted;
-    polar_right = to_be_inserted;
-  }
+template <typename T, typename Allocator>
+typename Linked_List<T, Allocator>::iterator
+Linked_List<T, Allocator>::end() {
+  return iterator(this, nullptr);
+}
 
-  this->size++;
+template <typename T, typename Allocator>
+typename Linked_List<T, Allocator>::const_iterator
+Linked_List<T, Allocator>::begin() const {
+  return const_iterator(this, this->polar_left);
 }
 
-template <typename T>
-void Linked_List<T>::insert(const T& data, std::size_t index) {
-  cell* to_be_inserted = new cell;
-  to_be_inserted->data = data;
-  to_be_inserted->left = nullptr;
-  to_be_inserted->right = nullptr;
-
-  // Insert the first node.
-  if (((this->polar_left == nullptr) && (this->polar_right == nullptr)) &&
-      (index == 0)) {
-    polar_left = to_be_inserted;
-    polar_right = to_be_inserted;
-
-    // Insert a new polar left.
-  } else if (index == 0) {
-    cell* prev_polar_left = polar_left;
-    to_be_inserted->right = prev_polar_left;
-    prev_polar_left->left = to_be_inserted;
-    polar_left = to_be_inserted;
-
-    // Insert a new polar right.
-  } else if (index == this->size) {
-    this->insert(data);
-    return;  // Return to not increase size twice.
-
-    // Inserting at some arbritary index.
-  } else if (index < this->size) {
-    std::size_t current_index = 0;
-    cell* current_cell = polar_left;
-
-    // Keep going to the right until we reach the index.
-    while (current_index != index) {
-      current_cell = current_cell->right;
-      current_index++;
-    }
+template <typename T, typename Allocator>
+typename Linked_List<T, Allocator>::const_iterator
+Linked_List<T, Allocator>::end() const {
+  return const_iterator(this, nullptr);
+}
 
-    /* Insert the to_be_inserted cell at the index, current cell is
-    currently at that index.
+/*******************************************************************************
+DATA STRUCTURE OPERATIONS
+*******************************************************************************/
+template <typename T, typename Allocator>
+void Linked_List<T, Allocator>::insert(const T& data) {
+  // Just append to the end of the linked list (polar right).
+  link_before(nullptr, create_cell(data));
+}
 
-        current_cell_left <---> current_cell <---> current_cell_right
-                            ^ insert to_be_inserted
+template <typename T, typename Allocator>
+void Linked_List<T, Allocator>::insert(const T& data, std::size_t index) {
+  if (index > this->size) {
+    return;  // Should never get here.
+  }
 
-    */
-    to_be_inserted->left = current_cell->left;
-    to_be_inserted->right = current_cell;
-    current_cell->left->right = to_be_inserted;
-    current_cell->left = to_be_inserted;
+  // Inserting at the size appends a new polar right.
+  cell* position = (index == this->size) ? nullptr : cell_at(index);
+  link_before(position, create_cell(data));
+}
 
-  } else {
+template <typename T, typename Allocator>
+typename Linked_List<T, Allocator>::iterator Linked_List<T, Allocator>::insert(
+    const_iterator position, const T& data) {
+  cell* to_be_inserted = create_cell(data);
+  link_before(position.current, to_be_inserted);
+  return iterator(this, to_be_inserted);
+}
+
+template <typename T, typename Allocator>
+void Linked_List<T, Allocator>::remove() {
+  cell* old_polar_right = this->polar_right;
+  unlink(old_polar_right);
+  destroy_cell(old_polar_right);
+}
+
+template <typename T, typename Allocator>
+void Linked_List<T, Allocator>::remove(std::size_t index) {
+  if (index >= this->size) {
     return;  // Should never get here.
   }
 
-  this->size++;
+  cell* current_cell = cell_at(index);
+  unlink(current_cell);
+  destroy_cell(current_cell);
 }
 
-template <typename T>
-void Linked_List<T>::remove() {
-  if (polar_right->left != nullptr) {
-    /* Null the right pointer of the node immediate to the left of polar
-    right (this node is the new polar right). Delete polar right. */
-    cell* old_polar_right = polar_right;
-    polar_right->left->right = nullptr;
-    polar_right = polar_right->left;
-    delete old_polar_right;
-
-    /* There is no node to the left of polar right. Polar right is the only
-    node. */
-  } else {
-    delete polar_right;
-    polar_right = nullptr;
-    polar_left = nullptr;
+template <typename T, typename Allocator>
+typename Linked_List<T, Allocator>::iterator Linked_List<T, Allocator>::erase(
+    const_iterator position) {
+  cell* current_cell = position.current;
+  cell* next = current_cell->right;
+  unlink(current_cell);
+  destroy_cell(current_cell);
+  return iterator(this, next);
+}
+
+template <typename T, typename Allocator>
+void Linked_List<T, Allocator>::splice(const_iterator position,
+                                       Linked_List& other) {
+  if ((&other == this) || (other.size == 0)) {
+    return;
   }
 
-  this->size--;
-}
+  if constexpr (!ALWAYS_TAKES_NODES) {
+    // other's nodes can't be freed by this' allocator, so move its values.
+    if (this->allocator != other.allocator) {
+      for (T& data : other) {
+        link_before(position.current, create_cell(std::move(data)));
+      }
+      other.clear();
+      return;
+    }
+  }
 
-template <typename T>
-void Linked_List<T>::remove(std::size_t index) {
-  if (index == 0) {
-    if (polar_left->right != nullptr) {
-      /* Null the left pointer of the node immediate to the right of polar
-      left (this node is the new polar left). Delete polar left. */
-      cell* old_polar_left = polar_left;
-      polar_left->right->left = nullptr;
-      polar_left = polar_left->right;
-      delete old_polar_left;
-
-      /* There is no node to the right of polar left. Polar left is the only
-      node. */
-    } else {
-      delete polar_left;
-      polar_left = nullptr;
-      polar_right = nullptr;
+  // Link other's chain of nodes in between position and the node before it.
+  cell* before = (position.current == nullptr) ? this->polar_right
+                                               : position.current->left;
+  other.polar_left->left = before;
+  other.polar_right->right = position.current;
+  if (before == nullptr) {
+    this->polar_left = other.polar_left;
+  } else {
+    before->right = other.polar_left;
+  }
+  if (position.current == nullptr) {
+    this->polar_right = other.polar_right;
+  } else {
+    position.current->left = other.polar_right;
+  }
+  this->size += other.size;
+
+  // The nodes now belong to this list, so their slabs and other's unused
+  // nodes, which share the slabs, do too.
+  if (other.slabs != nullptr) {
+    slab* last = other.slabs;
+    while (last->next != nullptr) {
+      last = last->next;
     }
+    last->next = this->slabs;
+    this->slabs = other.slabs;
+  }
+  while (other.free_cells != nullptr) {
+    free_cell* f = other.free_cells;
+    other.free_cells = f->next;
+    f->next = this->free_cells;
+    this->free_cells = f;
+  }
 
-  } else if (index == (this->size - 1)) {
-    this->remove();
-    return;  // Return to not decrease size twice.
+  other.size = 0;
+  other.polar_left = nullptr;
+  other.polar_right = nullptr;
+  other.slabs = nullptr;
+  other.next_slab_cells = FIRST_SLAB_CELLS;
+}
 
-  } else if (index < (this->size - 1)) {
-    std::size_t current_index = 0;
-    cell* current_cell = polar_left;
+template <typename T, typename Allocator>
+void Linked_List<T, Allocator>::splice(const_iterator position,
+                                       Linked_List& other,
+                                       const_iterator element) {
+  cell* moved = element.current;
 
-    // Keep going to the right until we reach the index.
-    while (current_index != index) {
-      current_cell = current_cell->right;
-      current_index++;
+  if (&other == this) {
+    // Moving a node before itself or its successor changes nothing.
+    if ((position.current == moved) || (position.current == moved->right)) {
+      return;
     }
+    unlink(moved);
+    link_before(position.current, moved);
+    return;
+  }
 
-    /* We are guaranteed to be between two nodes just do pointer
-    manipulation. */
-    current_cell->left->right = current_cell->right;
-    current_cell->right->left = current_cell->left;
-    delete current_cell;
+  link_before(position.current, create_cell(std::move(moved->data)));
+  other.erase(element);
+}
 
-  } else {
+template <typename T, typename Allocator>
+void Linked_List<T, Allocator>::replace(T& data, std::size_t index) {
+  if (index >= this->size) {
     return;  // Should never get here.
   }
 
-  this->size--;
+  cell_at(index)->data = data;
 }
 
-template <typename T>
-void Linked_List<T>::replace(T& data, std::size_t index) {
-  if (index == 0) {
-    polar_left->data = data;
-  } else if (index == (this->size - 1)) {
-    polar_right->data = data;
-  } else if (index < (this->size - 1)) {
-    std::size_t current_index = 0;
-    cell* current_cell = polar_left;
-
-    // Keep going to the right until we reach the index.
-    while (current_index != index) {
-      current_cell = current_cell->right;
-      current_index++;
+template <typename T, typename Allocator>
+void Linked_List<T, Allocator>::clear() {
+  // Return every node to the pool from left to right.
+  cell* current_cell = this->polar_left;
+  while (current_cell != nullptr) {
+    cell* next = current_cell->right;
+    destroy_cell(current_cell);
+    current_cell = next;
+  }
+
+  this->size = 0;
+  this->polar_left = nullptr;
+  this->polar_right = nullptr;
+}
+
+/*******************************************************************************
+DATA STRUCTURE OPERATOR OVERLOADS
+*******************************************************************************/
+template <typename T, typename Allocator>
+T& Linked_List<T, Allocator>::operator[](std::size_t index) const {
+  if (index >= this->size) {
+    throw std::out_of_range(
+        "Tried to access data from an index higher than data was stored.");
+  }
+
+  return cell_at(index)->data;
+}
+
+template <typename T, typename Allocator>
+Linked_List<T, Allocator>& Linked_List<T, Allocator>::operator=(
+    const Linked_List& src) {
+  if (this != &src) {
+    clear();
+    if constexpr (cell_allocator_traits::
+                      propagate_on_container_copy_assignment::value) {
+      // The slabs must be freed by the allocator they came from before the
+      // allocator is replaced by src's.
+      if (this->allocator != src.allocator) {
+        release_slabs();
+      }
+      this->allocator = src.allocator;
     }
+    append_all(src);
+  }
 
-    current_cell->data = data;
+  return *this;
+}
 
-  } else {
-    return;  // Should never get here.
+template <typename T, typename Allocator>
+Linked_List<T, Allocator>& Linked_List<T, Allocator>::operator=(
+    Linked_List&& src) noexcept(ALWAYS_TAKES_NODES) {
+  if (this == &src) {
+    return *this;
   }
+
+  clear();
+
+  if constexpr (!ALWAYS_TAKES_NODES) {
+    // src's nodes can't be freed by this' allocator, so move its values.
+    if (this->allocator != src.allocator) {
+      for (T& data : src) {
+        link_before(nullptr, create_cell(std::move(data)));
+      }
+      src.clear();
+      return *this;
+    }
+  }
+
+  release_slabs();
+  if constexpr (cell_allocator_traits::propagate_on_container_move_assignment::
+                    value) {
+    this->allocator = std::move(src.allocator);
+  }
+  take_nodes(src);
+
+  return *this;
 }
 
 /*******************************************************************************
-DATA STRUCTURE OPERATOR OVERLOADS
+PRIVATE DECLARATIONS
 *******************************************************************************/
-template <typename T>
-T& Linked_List<T>::operator[](std::size_t index) const {
-  if (index == 0) {
-    return polar_left->data;
-  } else if (index == (this->size - 1)) {
-    return polar_right->data;
-  } else if (index < (this->size - 1)) {
-    std::size_t current_index = 0;
-    cell* current_cell = polar_left;
-
-    // Keep going to the right until we reach the index.
-    while (current_index != index) {
-      current_cell = current_cell->right;
-      current_index++;
-    }
+template <typename T, typename Allocator>
+template <typename... Args>
+typename Linked_List<T, Allocator>::cell*
+Linked_List<T, Allocator>::create_cell(Args&&... args) {
+  if (this->free_cells == nullptr) {
+    add_slab();
+  }
 
-    return current_cell->data;
+  free_cell* f = this->free_cells;
+  this->free_cells = f->next;
+
+  cell* c = reinterpret_cast<cell*>(f);
+  try {
+    ::new (static_cast<void*>(c))
+        cell{T(std::forward<Args>(args)...), nullptr, nullptr};
+  } catch (...) {
+    // Put the node back on the free list.
+    this->free_cells =
+        ::new (static_cast<void*>(c)) free_cell{this->free_cells};
+    throw;
+  }
 
+  return c;
+}
+
+template <typename T, typename Allocator>
+void Linked_List<T, Allocator>::destroy_cell(cell* c) {
+  c->~cell();
+  this->free_cells = ::new (static_cast<void*>(c)) free_cell{this->free_cells};
+}
+
+template <typename T, typename Allocator>
+void Linked_List<T, Allocator>::add_slab() {
+  slab_allocator slab_records(this->allocator);
+  slab* s = std::allocator_traits<slab_allocator>::allocate(slab_records, 1);
+  try {
+    s->cells =
+        cell_allocator_traits::allocate(this->allocator, this->next_slab_cells);
+  } catch (...) {
+    std::allocator_traits<slab_allocator>::deallocate(slab_records, s, 1);
+    throw;
+  }
+  s->count = this->next_slab_cells;
+  s->next = this->slabs;
+  this->slabs = s;
+
+  // Push the nodes in reverse so that they are handed out in address order.
+  for (std::size_t i = s->count; i > 0; i--) {
+    this->free_cells = ::new (static_cast<void*>(s->cells + (i - 1)))
+        free_cell{this->free_cells};
+  }
+
+  if (this->next_slab_cells < MAX_SLAB_CELLS) {
+    this->next_slab_cells *= 2;
+  }
+}
+
+template <typename T, typename Allocator>
+void Linked_List<T, Allocator>::release_slabs() {
+  slab_allocator slab_records(this->allocator);
+  while (this->slabs != nullptr) {
+    slab* s = this->slabs;
+    this->slabs = s->next;
+    cell_allocator_traits::deallocate(this->allocator, s->cells, s->count);
+    std::allocator_traits<slab_allocator>::deallocate(slab_records, s, 1);
+  }
+
+  this->free_cells = nullptr;
+  this->next_slab_cells = FIRST_SLAB_CELLS;
+}
+
+template <typename T, typename Allocator>
+void Linked_List<T, Allocator>::link_before(cell* position, cell* c) {
+  /* Insert c in between position and the node to its left.
+
+      left <---> position
+            ^ insert c
+
+  */
+  cell* left = (position == nullptr) ? this->polar_right : position->left;
+  c->left = left;
+  c->right = position;
+
+  if (left == nullptr) {
+    this->polar_left = c;
   } else {
-    throw std::out_of_range(
-        "Tried to access data from an index higher than data was stored.");
+    left->right = c;
   }
+
+  if (position == nullptr) {
+    this->polar_right = c;
+  } else {
+    position->left = c;
+  }
+
+  this->size++;
 }
 
-template <typename T>
-Linked_List<T>& Linked_List<T>::operator=(const Linked_List<T>& src) {
-  ~Linked_List();
+template <typename T, typename Allocator>
+void Linked_List<T, Allocator>::unlink(cell* c) {
+  if (c->left == nullptr) {
+    this->polar_left = c->right;
+  } else {
+    c->left->right = c->right;
+  }
 
-  // Copy src's pointers.
-  this->size = src.size;
-  this->polar_left = src.polar_left;
-  this->polar_right = src.polar_right;
+  if (c->right == nullptr) {
+    this->polar_right = c->left;
+  } else {
+    c->right->left = c->left;
+  }
 
-  return *this;
+  this->size--;
 }
 
-template <typename T>
-Linked_List<T>& Linked_List<T>::operator=(Linked_List<T>&& src) noexcept {
-  ~Linked_List();
+template <typename T, typename Allocator>
+typename Linked_List<T, Allocator>::cell* Linked_List<T, Allocator>::cell_at(
+    std::size_t index) const {
+  cell* current_cell;
 
-  // Copy src's pointers.
+  // Walk from whichever end is nearer; the ends themselves take no steps.
+  if (index < (this->size / 2)) {
+    current_cell = this->polar_left;
+    for (std::size_t i = 0; i < index; i++) {
+      current_cell = current_cell->right;
+    }
+  } else {
+    current_cell = this->polar_right;
+    for (std::size_t i = this->size - 1; i > index; i--) {
+      current_cell = current_cell->left;
+    }
+  }
+
+  return current_cell;
+}
+
+template <typename T, typename Allocator>
+void Linked_List<T, Allocator>::append_all(const Linked_List& src) {
+  for (const T& data : src) {
+    insert(data);
+  }
+}
+
+template <typename T, typename Allocator>
+void Linked_List<T, Allocator>::take_nodes(Linked_List& src) {
   this->size = src.size;
   this->polar_left = src.polar_left;
   this->polar_right = src.polar_right;
+  this->free_cells = src.free_cells;
+  this->slabs = src.slabs;
+  this->next_slab_cells = src.next_slab_cells;
 
   // Return the src Linked List into a newly created state.
   src.size = 0;
   src.polar_left = nullptr;
   src.polar_right = nullptr;
-
-  return *this;
+  src.free_cells = nullptr;
+  src.slabs = nullptr;
+  src.next_slab_cells = FIRST_SLAB_CELLS;
 }
+
+namespace lox_pmr {
+
+// A Linked_List whose nodes come from a std::pmr::memory_resource.
+template <typename T>
+using Linked_List = ::Linked_List<T, std::pmr::polymorphic_allocator<T>>;
+
+}  // namespace lox_pmr
@@ -7,8 +7,27 @@
 class Error_Reporter {
  public:
   bool had_error = false;
+  bool had_runtime_error = false;
+
+  // When set, errors are held back instead of being printed, so that errors
+  // found out of order (e.g. on several threads) can be printed in order with
+  // report_held.
+  bool hold_errors = false;
 
   void error(const uint64_t line, const std::string& message);
 
+  // Reports an error at a place on the line, e.g. " at 'x'" or " at end".
+  void error(const uint64_t line, const std::string& where,
+             const std::string& message);
+
+  // Reports an error raised while running, followed by trace, the lines of
+  // the stack trace, e.g. "[line 2] in f()\n[line 5] in script\n".
+  void runtime_error(const std::string& message, const std::string& trace);
+
+  // Reports the errors held back by src, in the order they were reported.
+  void report_held(const Error_Reporter& src);
+
  private:
+  // The text of the errors held back.
+  std::string held;
 };
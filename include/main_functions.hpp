@@ -3,7 +3,38 @@
 #include <string>
 
 #include "error_reporter/error_reporter.hpp"
+#include "source_file/source_file.hpp"
+#include "token/token_dump.hpp"
+#include "vm/vm.hpp"
 
-uint64_t run_file(const std::string& file_path, Error_Reporter& e);
-void run_prompt(Error_Reporter& e);
-void run(const std::string& source, Error_Reporter& e);
+// Options from the command line.
+struct Run_Options {
+  // Whether run prints the tokens instead of running the source.
+  bool dump_tokens = false;
+
+  // The format run prints the tokens in.
+  Token_Dump::Format token_format = Token_Dump::Format::TEXT;
+
+  // Whether the tokens of a script file are cached on disk and reused while
+  // the file doesn't change.
+  bool token_cache = false;
+
+  // Where the token cache files go; next to the script files if empty.
+  std::string token_cache_directory;
+
+  // Whether run parses the source and prints its syntax tree instead of
+  // running it.
+  bool dump_ast = false;
+
+  // Whether run compiles the source and prints its bytecode instead of running
+  // it.
+  bool disassemble = false;
+};
+
+uint64_t run_file(const std::string& file_path, Error_Reporter& e,
+                  const Run_Options& options = Run_Options());
+void run_prompt(Error_Reporter& e, const Run_Options& options = Run_Options());
+
+// Runs source on vm, or prints its tokens, tree or bytecode as options say.
+void run(const Source_File& source, Error_Reporter& e, VM& vm,
+         const Run_Options& options = Run_Options());
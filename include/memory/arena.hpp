@@ -0,0 +1,167 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*******************************************************************************
+A bump-pointer allocator for data that is freed all at once, such as the data
+of one compilation. Memory is handed out from large blocks by moving a pointer
+forward, so an allocation costs a few instructions and freeing a single object
+costs nothing; the whole arena is released in one shot by reset or by its
+destructor. Each block is twice as large as the one before it, up to
+MAX_BLOCK_SIZE, and allocations too large for a block get a block of their own.
+
+Objects made with create have their destructors run when the arena is reset or
+destroyed, in the reverse order of their creation; trivially destructible
+objects cost nothing extra. An Arena is not thread-safe; give each thread its
+own.
+*******************************************************************************/
+
+class Arena {
+ public:
+  static constexpr std::size_t DEFAULT_BLOCK_SIZE = 1 << 12;
+  static constexpr std::size_t MAX_BLOCK_SIZE = 1 << 20;
+
+  // The first block is allocated on the first allocation, so an unused arena
+  // costs nothing.
+  explicit Arena(std::size_t first_block_size = DEFAULT_BLOCK_SIZE);
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  ~Arena();
+
+  // Returns uninitialized memory for bytes bytes aligned to alignment, which
+  // must be a power of two. Throws std::bad_alloc if it can't be allocated.
+  void* allocate(std::size_t bytes,
+                 std::size_t alignment = alignof(std::max_align_t));
+
+  // Returns uninitialized memory for count objects of type T.
+  template <typename T>
+  T* allocate_array(std::size_t count);
+
+  // Constructs a T in the arena; it is destroyed when the arena is reset.
+  template <typename T, typename... Args>
+  T* create(Args&&... args);
+
+  // Destroys the created objects and frees everything allocated, keeping the
+  // largest block to be reused by the next allocations.
+  void reset();
+
+  // Returns the number of bytes handed out since the last reset.
+  std::size_t get_bytes_used() const;
+
+  // Returns the number of bytes held in blocks, used or not.
+  std::size_t get_bytes_reserved() const;
+
+ private:
+  // A block of memory; its usable bytes follow the header.
+  struct block {
+    block* previous;
+    std::size_t size;
+  };
+
+  // A created object whose destructor still has to run.
+  struct finalizer {
+    void (*destroy)(void* object);
+    void* object;
+    finalizer* previous;
+  };
+
+  // The block being allocated from, and its unused bytes.
+  block* current;
+  char* position;
+  char* limit;
+
+  std::size_t next_block_size;
+
+  std::size_t bytes_used;
+  std::size_t bytes_reserved;
+
+  finalizer* finalizers;
+
+  // Allocates from a new block when the current one is too small.
+  void* allocate_slow(std::size_t bytes, std::size_t alignment);
+
+  // Destroys the created objects, most recently created first.
+  void run_finalizers();
+
+  // Frees the blocks from first through the oldest one.
+  static void free_blocks(block* first);
+};
+
+/*******************************************************************************
+A std::pmr::memory_resource that allocates from an Arena, so that standard
+containers and others written against memory_resource can use one.
+Deallocation does nothing; memory is reclaimed when the arena is reset.
+*******************************************************************************/
+
+class Monotonic_Resource : public std::pmr::memory_resource {
+ public:
+  // Allocates from arena, which must outlive this resource.
+  explicit Monotonic_Resource(Arena& arena);
+
+  Arena& get_arena() const;
+
+ private:
+  Arena& arena;
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void* memory, std::size_t bytes,
+                     std::size_t alignment) override;
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override;
+};
+
+/*******************************************************************************
+Template and inline definitions; the fast paths are kept in the header so that
+they are inlined into the callers.
+*******************************************************************************/
+inline void* Arena::allocate(std::size_t bytes, std::size_t alignment) {
+  // Round the position up to the alignment.
+  char* aligned = (char*)(((uintptr_t)this->position + (alignment - 1)) &
+                          ~(uintptr_t)(alignment - 1));
+  if ((aligned > this->limit) ||
+      (bytes > (std::size_t)(this->limit - aligned))) {
+    return allocate_slow(bytes, alignment);
+  }
+
+  this->position = aligned + bytes;
+  this->bytes_used += bytes;
+  return aligned;
+}
+
+template <typename T>
+T* Arena::allocate_array(std::size_t count) {
+  if (count > (SIZE_MAX / sizeof(T))) {
+    throw std::bad_alloc();
+  }
+
+  return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+}
+
+template <typename T, typename... Args>
+T* Arena::create(Args&&... args) {
+  if constexpr (std::is_trivially_destructible_v<T>) {
+    return ::new (allocate(sizeof(T), alignof(T)))
+        T(std::forward<Args>(args)...);
+  } else {
+    // Allocate the finalizer first so that a failure leaves no object that
+    // wouldn't be destroyed.
+    finalizer* f = ::new (allocate(sizeof(finalizer), alignof(finalizer)))
+        finalizer{nullptr, nullptr, nullptr};
+    T* object =
+        ::new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+
+    f->destroy = [](void* o) { static_cast<T*>(o)->~T(); };
+    f->object = object;
+    f->previous = this->finalizers;
+    this->finalizers = f;
+    return object;
+  }
+}
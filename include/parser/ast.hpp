@@ -0,0 +1,121 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <type_traits>
+
+#include "data_structures/dynamic_array.hpp"
+#include "token/token.hpp"
+
+/*******************************************************************************
+The syntax tree of a Lox program, stored flat: every node is a fixed-size
+record in one array and refers to its children by their 32-bit index (Node_Id)
+in that array rather than by pointer. Children that come in lists of any
+length, such as the statements of a block or the arguments of a call, are
+stored contiguously in a second array, prefixed by their count, and a node
+refers to a list by the index of the count. The tree is built bottom-up, so a
+node's children always come before it.
+
+Both arrays come from the tree's memory resource; with a Monotonic_Resource
+over a compilation's Arena the whole tree is freed in one shot with the arena.
+*******************************************************************************/
+
+using Node_Id = uint32_t;
+
+/* The kinds of nodes and what their fields hold. Names and strings are symbols
+in the scanner's String_Interner and numbers are indices into its
+Literal_Table; "list" is a list index and "node" a Node_Id, which is NO_NODE
+where a child is optional. */
+enum class Node_Kind : uint8_t {
+  // Expressions.
+  NK_NUMBER,    // a: literal index.
+  NK_STRING,    // a: symbol of the value.
+  NK_TRUE,      //
+  NK_FALSE,     //
+  NK_NIL,       //
+  NK_VARIABLE,  // a: symbol of the name.
+  NK_ASSIGN,    // a: symbol of the name, b: value node.
+  NK_UNARY,     // op, a: operand node.
+  NK_BINARY,    // op, a: left node, b: right node.
+  NK_LOGICAL,   // op (TT_AND or TT_OR), a: left node, b: right node.
+  NK_GROUPING,  // a: expression node.
+  NK_CALL,      // a: callee node, b: list of argument nodes.
+  NK_GET,       // a: object node, b: symbol of the property.
+  NK_SET,       // a: object node, b: symbol of the property, c: value node.
+  NK_THIS,      //
+  NK_SUPER,     // a: symbol of the method.
+
+  // Statements.
+  NK_EXPRESSION,  // a: expression node.
+  NK_PRINT,       // a: expression node.
+  NK_VAR,         // a: symbol of the name, b: initializer node or NO_NODE.
+  NK_BLOCK,       // a: list of statement nodes.
+  NK_IF,          // a: condition node, b: then node, c: else node or NO_NODE.
+  NK_WHILE,       // a: condition node, b: body node.
+  NK_FUNCTION,    // a: symbol of the name, b: list of parameter symbols,
+                  // c: list of body statement nodes.
+  NK_RETURN,      // a: value node or NO_NODE.
+  NK_CLASS,       // a: symbol of the name, b: superclass NK_VARIABLE node or
+                  // NO_NODE, c: list of NK_FUNCTION method nodes.
+  NK_PROGRAM,     // a: list of the top-level statement nodes.
+};
+
+/* A node is 20 bytes of plain data. offset is the offset of the node's main
+token in the source (its operator, name or keyword) and locates the node for
+error messages. */
+struct Ast_Node {
+  Node_Kind kind;
+  Token_Type op;
+  uint32_t offset;
+  uint32_t a;
+  uint32_t b;
+  uint32_t c;
+};
+
+static_assert(sizeof(Ast_Node) == 20, "Ast nodes should stay 20 bytes.");
+static_assert(std::is_trivially_copyable_v<Ast_Node>,
+              "Ast nodes should be copyable with memcpy.");
+
+class Ast {
+ public:
+  // The Node_Id of a missing optional child.
+  static constexpr Node_Id NO_NODE = UINT32_MAX;
+
+  // The nodes and lists are allocated from resource.
+  explicit Ast(
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+  // Appends a node and returns its id.
+  Node_Id add(Node_Kind kind, uint32_t offset, uint32_t a = 0, uint32_t b = 0,
+              uint32_t c = 0, Token_Type op = Token_Type::TT_EOF);
+
+  // Stores count items as a list and returns the list's index.
+  uint32_t add_list(const uint32_t* items, std::size_t count);
+
+  // Returns the node with the given id.
+  const Ast_Node& get(Node_Id node) const;
+
+  // Returns the items of the list at index list.
+  std::span<const uint32_t> get_list(uint32_t list) const;
+
+  // Returns the NK_PROGRAM node, or NO_NODE if nothing was parsed yet.
+  Node_Id get_root() const;
+  void set_root(Node_Id node);
+
+  // Returns the number of nodes.
+  std::size_t get_size() const;
+
+  // Removes every node and list.
+  void clear();
+
+ private:
+  lox_pmr::Dynamic_Array<Ast_Node> nodes;
+
+  // Every list's count followed by its items.
+  lox_pmr::Dynamic_Array<uint32_t> lists;
+
+  Node_Id root;
+};
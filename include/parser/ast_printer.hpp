@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+
+#include "parser/ast.hpp"
+#include "token/literal_table.hpp"
+#include "token/symbol_table.hpp"
+
+/*******************************************************************************
+Prints an Ast as S-expressions, e.g. "(print (+ 1 (* 2 x)))", with every
+top-level statement of a program on its own line. Names print as they are and
+strings in quotes; numbers print in their shortest round-trip form.
+
+  (; expression)         (print expression)     (var name) (var name value)
+  (block statement...)   (if condition then)    (if condition then else)
+  (while condition body) (return) (return value)
+  (fun name (parameter...) statement...)
+  (class name method...) (class name < superclass method...)
+  (= name value)         (call callee argument...)
+  (get object name)      (set object name value)
+  (group expression)     (super method)         this
+*******************************************************************************/
+
+class Ast_Printer {
+ public:
+  // literals and symbols are those of the Parser that built ast.
+  Ast_Printer(const Ast& ast, const Literal_Table& literals,
+              const Symbol_Table& symbols);
+
+  // Appends node and its children to out.
+  void print(Node_Id node, std::string& out) const;
+
+  // Returns node and its children printed.
+  std::string print(Node_Id node) const;
+
+ private:
+  const Ast& ast;
+  const Literal_Table& literals;
+  const Symbol_Table& symbols;
+
+  // Appends " " and every item of the list, printed as nodes.
+  void print_list(uint32_t list, std::string& out) const;
+};
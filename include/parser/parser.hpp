@@ -0,0 +1,181 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+#include <span>
+#include <string_view>
+
+#include "data_structures/dynamic_array.hpp"
+#include "error_reporter/error_reporter.hpp"
+#include "parser/ast.hpp"
+#include "scanner/scanner.hpp"
+#include "scanner/token_stream.hpp"
+#include "source_file/source_file.hpp"
+#include "token/literal_table.hpp"
+#include "token/symbol_table.hpp"
+#include "token/token.hpp"
+
+/*******************************************************************************
+Parses the full Lox grammar into an Ast. Statements are parsed by recursive
+descent and expressions by precedence climbing (Pratt parsing): every token type
+has a rule with the function that parses an expression starting with it, the
+function that parses an expression it continues, and its precedence as an infix
+operator. The parser pulls tokens from its own Scanner through a Token_Stream
+as it goes, so the tokens are never collected into an array; tokens that were
+scanned before, e.g. loaded from a Token_Cache, are parsed from their array
+instead. for loops are desugared into while loops, as in the book.
+
+A syntax error is reported and the parser skips ahead to the start of the next
+statement, so that one run reports as many errors as possible; the statement
+with the error is left out of the tree. Expressions and statements together
+nest at most MAX_DEPTH deep, where every operand of a chain such as a + b + c
+or a.b().c is one level deeper than the last, so that the tree is at most that
+deep and walking it can't overflow the stack.
+
+The tree, tokens and literals are allocated from resource, e.g. a
+Monotonic_Resource so that they are freed with the rest of a compilation's
+Arena.
+*******************************************************************************/
+
+class Parser {
+ public:
+  static constexpr uint32_t MAX_DEPTH = 4096;
+
+  // The most arguments of a call and parameters of a function.
+  static constexpr std::size_t MAX_ARGUMENTS = 255;
+
+  Parser(const Source_File& source, Error_Reporter& e,
+         std::pmr::memory_resource* resource =
+             std::pmr::get_default_resource());
+
+  // Parses tokens already scanned from source, ending with TT_EOF, whose
+  // literals and symbols are in literals and symbols; these must outlive the
+  // parser.
+  Parser(const Source_File& source, std::span<const Token> tokens,
+         const Literal_Table& literals, const Symbol_Table& symbols,
+         Error_Reporter& e,
+         std::pmr::memory_resource* resource =
+             std::pmr::get_default_resource());
+
+  // Parses the whole source and returns the tree, whose root is the
+  // NK_PROGRAM node.
+  Ast& parse();
+
+  // Returns the values of the number literals the tree's nodes index into.
+  const Literal_Table& get_literals() const;
+
+  // Returns the names and string values the tree's symbols refer to.
+  const Symbol_Table& get_symbols() const;
+
+ private:
+  // Binding powers of the infix operators, from loosest to tightest.
+  enum class Precedence : uint8_t {
+    NONE,
+    ASSIGNMENT,  // =
+    OR,          // or
+    AND,         // and
+    EQUALITY,    // == !=
+    COMPARISON,  // < > <= >=
+    TERM,        // + -
+    FACTOR,      // * /
+    UNARY,       // ! -
+    CALL,        // . ()
+    PRIMARY
+  };
+
+  using Prefix_Function = Node_Id (Parser::*)(bool can_assign);
+  using Infix_Function = Node_Id (Parser::*)(Node_Id left, bool can_assign);
+
+  struct Parse_Rule {
+    Prefix_Function prefix;
+    Infix_Function infix;
+    Precedence precedence;
+  };
+
+  // Thrown to unwind to the enclosing statement after a syntax error.
+  struct Parse_Error {};
+
+  static const std::array<Parse_Rule, (std::size_t)Token_Type::TT_EOF + 1>
+      RULES;
+
+  Source_File source;
+
+  // Scans the source, unless the tokens are parsed from an array.
+  Scanner scanner;
+  Token_Stream<> tokens;
+  Error_Reporter& error_reporting;
+
+  // The scanner's tables, or those of the tokens parsed from an array.
+  const Literal_Table& literals;
+  const Symbol_Table& symbols;
+
+  Ast ast;
+
+  // The token consumed last.
+  Token previous;
+
+  // Children of the lists being parsed, e.g. of nested blocks; a finished
+  // list is moved into the tree and popped.
+  lox_pmr::Dynamic_Array<uint32_t> scratch;
+
+  // How deeply the expression or statement being parsed is nested.
+  uint32_t depth;
+
+  // Statements.
+  Node_Id declaration();
+  Node_Id class_declaration();
+  Node_Id function(const char* kind);
+  Node_Id var_declaration();
+  Node_Id statement();
+  Node_Id for_statement();
+  Node_Id if_statement();
+  Node_Id print_statement();
+  Node_Id return_statement();
+  Node_Id while_statement();
+  Node_Id expression_statement();
+
+  // Parses declarations up to the closing brace and returns them as a list.
+  uint32_t block();
+
+  // Expressions.
+  Node_Id expression();
+  Node_Id parse_precedence(Precedence precedence);
+  Node_Id grouping(bool can_assign);
+  Node_Id number(bool can_assign);
+  Node_Id string(bool can_assign);
+  Node_Id literal(bool can_assign);
+  Node_Id variable(bool can_assign);
+  Node_Id this_(bool can_assign);
+  Node_Id super_(bool can_assign);
+  Node_Id unary(bool can_assign);
+  Node_Id binary(Node_Id left, bool can_assign);
+  Node_Id logical(Node_Id left, bool can_assign);
+  Node_Id call(Node_Id left, bool can_assign);
+  Node_Id dot(Node_Id left, bool can_assign);
+
+  // Moves the scratch items from mark on into a list and returns the list.
+  uint32_t finish_list(int mark);
+
+  // Pops the scratch items from mark on.
+  void truncate_scratch(int mark);
+
+  // Counts one more level of nesting; throws Parse_Error past MAX_DEPTH.
+  void enter();
+
+  const Token& peek();
+  bool check(Token_Type type);
+  bool match(Token_Type type);
+  const Token& advance();
+
+  // Consumes a token of the given type or throws Parse_Error with message.
+  const Token& consume(Token_Type type, std::string_view message);
+
+  // Reports an error at token.
+  void error(const Token& token, std::string_view message);
+
+  // Skips to the start of the next statement after a syntax error.
+  void synchronize();
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <cstddef>
+
+/*******************************************************************************
+Kernels the scanner uses to skip over runs of bytes that don't end a token:
+whitespace, comment bodies, string bodies and identifiers. Each kernel is
+implemented with AVX2, with SSE4.2 and in plain C++; the fastest one the CPU
+supports is picked once at run time. All implementations return the same
+results, and none of them reads past text + length.
+*******************************************************************************/
+
+namespace lox_byte_scan {
+
+struct Kernels {
+  // Name of the instruction set, e.g. "avx2".
+  const char* name;
+
+  // Returns the index of the first byte that isn't ' ', '\t', '\r' or '\n',
+  // and adds the number of '\n' bytes before it to newlines.
+  std::size_t (*skip_whitespace)(const char* text, std::size_t length,
+                                 uint64_t& newlines);
+
+  // Returns the index of the first '\n'.
+  std::size_t (*find_newline)(const char* text, std::size_t length);
+
+  // Returns the index of the first '"', and adds the number of '\n' bytes
+  // before it to newlines.
+  std::size_t (*find_quote)(const char* text, std::size_t length,
+                            uint64_t& newlines);
+
+  // Returns the index of the first byte that can't continue an identifier,
+  // i.e. that isn't a letter, a digit or '_'.
+  std::size_t (*skip_identifier)(const char* text, std::size_t length);
+};
+
+// The kernels in plain C++; always available.
+const Kernels& scalar();
+
+// The SSE4.2 and AVX2 kernels; nullptr if the CPU doesn't support them.
+const Kernels* sse42();
+const Kernels* avx2();
+
+// The fastest kernels the CPU supports.
+const Kernels& best();
+
+}  // namespace lox_byte_scan
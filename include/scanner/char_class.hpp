@@ -0,0 +1,100 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <utility>
+
+#include "token/token.hpp"
+
+/*******************************************************************************
+Compile-time table classifying every byte value for the scanner, so that the
+scanner looks each byte up once instead of comparing it against ranges and
+case labels. For the operators that can be followed by '=' the table also
+holds both token types, which gives maximal munch without a match() call.
+*******************************************************************************/
+
+namespace lox_char_class {
+
+enum class Char_Class : uint8_t {
+  INVALID,     // Not part of any token.
+  WHITESPACE,  // ' ', '\t', '\r' or '\n'.
+  DIGIT,       // '0' to '9'.
+  ALPHA,       // A letter or '_'; starts an identifier or keyword.
+  QUOTE,       // '"'; starts a string.
+  SLASH,       // '/'; a division or the start of a comment.
+  SINGLE,      // A token of one character.
+  OPERATOR     // A token of one character, or of two if followed by '='.
+};
+
+struct Char_Info {
+  Char_Class char_class;
+
+  // The token of the character alone (SINGLE and OPERATOR).
+  Token_Type single;
+
+  // The token of the character followed by '=' (OPERATOR).
+  Token_Type with_equal;
+};
+
+constexpr std::array<Char_Info, 256> build_table() {
+  std::array<Char_Info, 256> table{};
+  for (Char_Info& info : table) {
+    info = Char_Info{Char_Class::INVALID, Token_Type::TT_EOF,
+                     Token_Type::TT_EOF};
+  }
+
+  for (unsigned char c : {' ', '\t', '\r', '\n'}) {
+    table[c].char_class = Char_Class::WHITESPACE;
+  }
+  for (unsigned char c = '0'; c <= '9'; c++) {
+    table[c].char_class = Char_Class::DIGIT;
+  }
+  for (unsigned char c = 'a'; c <= 'z'; c++) {
+    table[c].char_class = Char_Class::ALPHA;
+    table[c - 'a' + 'A'].char_class = Char_Class::ALPHA;
+  }
+  table['_'].char_class = Char_Class::ALPHA;
+  table['"'].char_class = Char_Class::QUOTE;
+  table['/'] = Char_Info{Char_Class::SLASH, Token_Type::TT_SLASH,
+                         Token_Type::TT_SLASH};
+
+  const std::pair<unsigned char, Token_Type> singles[] = {
+      {'(', Token_Type::TT_LEFT_PAREN}, {')', Token_Type::TT_RIGHT_PAREN},
+      {'{', Token_Type::TT_LEFT_BRACE}, {'}', Token_Type::TT_RIGHT_BRACE},
+      {',', Token_Type::TT_COMMA},      {'.', Token_Type::TT_DOT},
+      {'-', Token_Type::TT_MINUS},      {'+', Token_Type::TT_PLUS},
+      {';', Token_Type::TT_SEMICOLON},  {'*', Token_Type::TT_STAR}};
+  for (const auto& [c, type] : singles) {
+    table[c] = Char_Info{Char_Class::SINGLE, type, type};
+  }
+
+  table['!'] = Char_Info{Char_Class::OPERATOR, Token_Type::TT_BANG,
+                         Token_Type::TT_BANG_EQUAL};
+  table['='] = Char_Info{Char_Class::OPERATOR, Token_Type::TT_EQUAL,
+                         Token_Type::TT_EQUAL_EQUAL};
+  table['<'] = Char_Info{Char_Class::OPERATOR, Token_Type::TT_LESS,
+                         Token_Type::TT_LESS_EQUAL};
+  table['>'] = Char_Info{Char_Class::OPERATOR, Token_Type::TT_GREATER,
+                         Token_Type::TT_GREATER_EQUAL};
+
+  return table;
+}
+
+inline constexpr std::array<Char_Info, 256> TABLE = build_table();
+
+constexpr const Char_Info& info(char c) {
+  return TABLE[static_cast<unsigned char>(c)];
+}
+
+constexpr bool is_digit(char c) {
+  return info(c).char_class == Char_Class::DIGIT;
+}
+
+// True for the characters that can continue an identifier.
+constexpr bool is_alpha_numeric(char c) {
+  Char_Class char_class = info(c).char_class;
+  return (char_class == Char_Class::ALPHA) || (char_class == Char_Class::DIGIT);
+}
+
+}  // namespace lox_char_class
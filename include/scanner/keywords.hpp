@@ -0,0 +1,101 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <array>
+#include <string_view>
+
+#include "token/token.hpp"
+
+/*******************************************************************************
+Compile-time perfect hash over the Lox keywords. The keyword list comes from
+LOX_TOKEN_TYPES, and the hash parameters are searched for at compile time, so a
+keyword added to the token list is recognized without any other change and a
+keyword set the hash can't separate fails to compile.
+*******************************************************************************/
+
+namespace lox_keywords {
+
+struct Keyword {
+  std::string_view spelling;
+  Token_Type type;
+};
+
+#define TOKEN(name)
+#define KEYWORD(name, spelling) Keyword{spelling, Token_Type::name},
+inline constexpr Keyword KEYWORDS[] = {LOX_TOKEN_TYPES(TOKEN, KEYWORD)};
+#undef KEYWORD
+#undef TOKEN
+
+// Number of slots in the hash table; a power of two.
+inline constexpr std::size_t TABLE_SIZE = 32;
+
+/* The hash combines the length, first character and last character of a
+lexeme, all of which are already in cache when an identifier ends. */
+struct Hash_Parameters {
+  uint32_t length_multiplier;
+  uint32_t last_multiplier;
+};
+
+constexpr std::size_t hash(std::string_view text, Hash_Parameters p) {
+  return ((text.length() * p.length_multiplier) +
+          (unsigned char)text.front() +
+          ((unsigned char)text.back() * p.last_multiplier)) &
+         (TABLE_SIZE - 1);
+}
+
+// Finds parameters for which no two keywords share a slot.
+constexpr Hash_Parameters find_hash_parameters() {
+  for (uint32_t length_multiplier = 1; length_multiplier < 64;
+       length_multiplier++) {
+    for (uint32_t last_multiplier = 0; last_multiplier < 64;
+         last_multiplier++) {
+      Hash_Parameters p{length_multiplier, last_multiplier};
+      std::array<bool, TABLE_SIZE> used{};
+      bool collision = false;
+
+      for (const Keyword& keyword : KEYWORDS) {
+        std::size_t slot = hash(keyword.spelling, p);
+        collision = collision || used[slot];
+        used[slot] = true;
+      }
+
+      if (!collision) {
+        return p;
+      }
+    }
+  }
+
+  return Hash_Parameters{0, 0};
+}
+
+inline constexpr Hash_Parameters HASH_PARAMETERS = find_hash_parameters();
+
+static_assert(HASH_PARAMETERS.length_multiplier != 0,
+              "No perfect hash separates the keywords; grow TABLE_SIZE.");
+
+// Keyword slots; unused slots have an empty spelling and never match.
+constexpr std::array<Keyword, TABLE_SIZE> build_table() {
+  std::array<Keyword, TABLE_SIZE> table{};
+  for (Keyword& slot : table) {
+    slot = Keyword{"", Token_Type::TT_IDENTIFIER};
+  }
+  for (const Keyword& keyword : KEYWORDS) {
+    table[hash(keyword.spelling, HASH_PARAMETERS)] = keyword;
+  }
+  return table;
+}
+
+inline constexpr std::array<Keyword, TABLE_SIZE> TABLE = build_table();
+
+}  // namespace lox_keywords
+
+/* Returns the keyword's token type if the lexeme is a keyword and
+TT_IDENTIFIER otherwise. The lexeme must not be empty. */
+constexpr Token_Type keyword_or_identifier(std::string_view lexeme) {
+  const lox_keywords::Keyword& candidate =
+      lox_keywords::TABLE[lox_keywords::hash(lexeme,
+                                             lox_keywords::HASH_PARAMETERS)];
+  return (candidate.spelling == lexeme) ? candidate.type
+                                        : Token_Type::TT_IDENTIFIER;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+
+#include "data_structures/dynamic_array.hpp"
+#include "error_reporter/error_reporter.hpp"
+#include "scanner/byte_scan.hpp"
+#include "source_file/source_file.hpp"
+#include "token/literal_table.hpp"
+#include "token/string_interner.hpp"
+#include "token/token.hpp"
+
+/*******************************************************************************
+Scans a large source on several threads. The source is split into chunks at the
+starts of lines, where the scanner is either between tokens or inside a
+multi-line string (comments end at the newline). A pre-pass over each chunk,
+run in parallel, works out for both cases whether the chunk ends inside a
+string, which tells each chunk whether it starts inside one. Each chunk is then
+scanned on its own thread: a string that continues past the end of a chunk is
+scanned to its end by that chunk and skipped by the next one. The chunks'
+tokens, literals, symbols and errors are finally joined in order, so the result
+is the same as Scanner's, including the errors, their lines and the numbering of
+the symbols.
+*******************************************************************************/
+
+class Parallel_Scanner {
+ public:
+  // A chunk count of 0 picks one chunk per hardware thread, but no more than
+  // one per MIN_CHUNK_BYTES of source.
+  Parallel_Scanner(
+      const Source_File& source_file, Error_Reporter& e,
+      std::size_t chunks = 0,
+      const lox_byte_scan::Kernels& kernels = lox_byte_scan::best());
+
+  Token_Array& scan_tokens();
+
+  // Returns the values of the literals the scanned tokens index into.
+  const Literal_Table& get_literals() const;
+
+  // Returns the names and string values the scanned tokens' symbols refer to.
+  const String_Interner& get_symbols() const;
+
+ private:
+  // Sources smaller than this per thread aren't worth splitting.
+  static constexpr std::size_t MIN_CHUNK_BYTES = 1 << 20;
+
+  // The state of a chunk and what scanning it produced.
+  struct Chunk {
+    std::size_t begin;
+    std::size_t end;
+
+    // Whether the chunk ends inside a string if it starts between tokens and
+    // if it starts inside a string.
+    bool ends_in_string[2];
+
+    uint64_t newlines;
+
+    bool starts_in_string;
+    uint64_t line;
+
+    // Where the chunk's tokens and literals go in the joined ones.
+    std::size_t first_token;
+    uint32_t literal_base;
+
+    Token_Array tokens;
+    Literal_Table literals;
+    String_Interner symbols;
+    Error_Reporter errors;
+
+    // The joined symbol of each of the chunk's symbols.
+    Dynamic_Array<uint32_t> symbol_map;
+  };
+
+  Source_File source_file;
+
+  Token_Array tokens;
+
+  Literal_Table literals;
+
+  String_Interner symbols;
+
+  Error_Reporter& error_reporting;
+
+  std::size_t chunk_count;
+
+  const lox_byte_scan::Kernels& kernels;
+
+  // Finds whether the chunk ends inside a string and counts its lines.
+  void survey(Chunk& chunk) const;
+
+  // Scans the tokens that start in the chunk into tokens, literals and
+  // symbols.
+  void scan(Chunk& chunk, Token_Array& tokens, Literal_Table& literals,
+            String_Interner& symbols) const;
+};
@@ -1,38 +1,166 @@
+#pragma once
+
+#include <iterator>
+#include <memory_resource>
 #include <string>
+#include <string_view>
 
 #include "data_structures/dynamic_array.hpp"
-#include "data_structures/hash_table.hpp"
 #include "error_reporter/error_reporter.hpp"
+#include "scanner/byte_scan.hpp"
+#include "source_file/source_file.hpp"
+#include "token/literal_table.hpp"
+#include "token/string_interner.hpp"
 #include "token/token.hpp"
 
+/*******************************************************************************
+Turns Lox source text into tokens. The scanner is pull-based: next_token scans
+one token at a time on demand, iterating a Scanner yields its tokens, and
+scan_tokens collects all of them into an array.
+
+A scanner constructed without a source is in chunked mode: the text is fed to it
+in pieces with feed and the end of the text is marked with finish. A token cut
+off by the end of a piece is scanned again from its start once the next piece
+arrives, so only the unfinished token is carried over and any amount of input
+is scanned in memory proportional to the piece size. In chunked mode the
+tokens' offsets and literals refer to the text returned by get_text and the
+literal table, which are only valid until the next call to feed.
+
+The names of identifiers and the values of strings are interned as they are
+scanned, and their tokens' literal holds their symbol. Symbols are numbered in
+the order the texts first appear and, in chunked mode, stay valid across
+pieces.
+*******************************************************************************/
+
 class Scanner {
+  friend class Parallel_Scanner;
+
  public:
-  Scanner(const std::string& source, Error_Reporter& e);
-  Dynamic_Array<Token>& scan_tokens();
+  class Iterator;
+
+  /* The kernels default to the fastest ones the CPU supports; the choice
+  doesn't change the tokens. The token array and literals are allocated from
+  resource, e.g. a Monotonic_Resource so that they are freed with the rest of
+  a compilation's Arena. */
+  Scanner(const Source_File& source_file, Error_Reporter& e,
+          const lox_byte_scan::Kernels& kernels = lox_byte_scan::best(),
+          std::pmr::memory_resource* resource =
+              std::pmr::get_default_resource());
+
+  // Constructs a scanner in chunked mode.
+  explicit Scanner(
+      Error_Reporter& e,
+      const lox_byte_scan::Kernels& kernels = lox_byte_scan::best(),
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+  // Scans all the remaining tokens.
+  Token_Array& scan_tokens();
+
+  /* Scans the next token into token and returns true, ending with TT_EOF.
+  Returns false after TT_EOF, and in chunked mode when the next token needs
+  more input. */
+  bool next_token(Token& token);
+
+  // Appends a piece of the text in chunked mode.
+  void feed(std::string_view chunk);
+
+  // Marks the end of the text in chunked mode.
+  void finish();
+
+  // Iterates over the tokens next_token returns.
+  Iterator begin();
+  std::default_sentinel_t end() const;
+
+  // Returns the text the tokens' offsets refer to.
+  std::string_view get_text() const;
+
+  // Returns the values of the literals the scanned tokens index into.
+  const Literal_Table& get_literals() const;
+
+  // Returns the names and string values the scanned tokens' symbols refer to.
+  const String_Interner& get_symbols() const;
 
  private:
-  std::string source;
-  Dynamic_Array<Token>* tokens;
-  Hash_Table<std::string, Token_Type>* lox_keywords;
+  // Rough average number of source bytes per token (including whitespace),
+  // used to pre-size the token array.
+  static constexpr std::size_t ESTIMATED_BYTES_PER_TOKEN = 6;
+
+  // Every integer up to 2^53 is exactly representable as a double.
+  static constexpr uint64_t MAX_EXACT_INTEGER = uint64_t(1) << 53;
+
+  // Keeps the buffer the tokens' lexemes refer to alive.
+  Source_File source_file;
+
+  // The text of source_file, or the unscanned text in chunked mode.
+  std::string_view source;
+
+  // In chunked mode, the unfinished token of the last piece followed by the
+  // current piece.
+  std::string window;
+
+  // True in chunked mode until finish is called.
+  bool more_input;
+
+  // True once TT_EOF has been returned.
+  bool ended;
+
+  // True while the next token is cut off by the end of the window.
+  bool cut_off;
+
+  // The token scan_token produced.
+  Token token;
+
+  Token_Array tokens;
+
+  Literal_Table literals;
+
+  String_Interner symbols;
 
   uint64_t start;
   uint64_t current;
   uint64_t line;
 
-  Error_Reporter error_reporting;
+  Error_Reporter& error_reporting;
+
+  // Used to skip over whitespace, comments, strings and identifiers.
+  const lox_byte_scan::Kernels& kernels;
 
   bool is_at_end() const;
+  bool reaches_end(uint64_t index) const;
   char advance();
-  void add_token(Token_Type type);
-  void add_token(Token_Type type, const std::any& literal);
-  void scan_token();
-  void lox_identifier();
-  void lox_number();
-  void lox_string();
-  bool match(char expected);
+  bool add_token(Token_Type type, uint32_t literal = 0);
+  bool scan_token();
+  void skip_whitespace();
+  void skip_comment();
+  bool lox_identifier();
+  bool lox_number();
+  static double parse_number(std::string_view lexeme);
+  uint32_t symbol(std::string_view text);
+  bool lox_string();
   char peek();
   char peek_next();
-  bool is_alpha(char c);
-  bool is_alpha_numeric(char c);
-  bool is_digit(char c);
+};
+
+// An input iterator over the tokens of a Scanner.
+class Scanner::Iterator {
+ public:
+  using iterator_category = std::input_iterator_tag;
+  using value_type = Token;
+  using difference_type = std::ptrdiff_t;
+  using pointer = const Token*;
+  using reference = const Token&;
+
+  explicit Iterator(Scanner& scanner);
+
+  const Token& operator*() const;
+  const Token* operator->() const;
+  Iterator& operator++();
+  void operator++(int);
+
+  bool operator==(std::default_sentinel_t) const;
+
+ private:
+  Scanner* scanner;
+  Token token;
+  bool valid;
 };
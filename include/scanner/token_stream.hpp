@@ -0,0 +1,146 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+
+#include "scanner/scanner.hpp"
+#include "token/token.hpp"
+
+/*******************************************************************************
+Pulls tokens from a Scanner on demand with a fixed amount of lookahead, for a
+recursive-descent parser: peek looks up to LOOKAHEAD tokens ahead without
+consuming them and advance consumes one. The lookahead is a ring buffer, so no
+more than LOOKAHEAD tokens are ever held at once. After the end of the source,
+peek and advance keep returning the TT_EOF token. The scanner must be scanning a
+whole source, or be in chunked mode with its input finished.
+
+A stream can also read tokens that were scanned before, e.g. loaded from a
+Token_Cache, from an array that ends with TT_EOF.
+
+Template declarations and definitions must be kept in header only to avoid
+linking errors.
+*******************************************************************************/
+
+template <std::size_t LOOKAHEAD = 4>
+class Token_Stream {
+  static_assert((LOOKAHEAD != 0) && ((LOOKAHEAD & (LOOKAHEAD - 1)) == 0),
+                "The lookahead must be a power of two.");
+
+ public:
+  explicit Token_Stream(Scanner& scanner);
+
+  // Reads tokens from the array instead of scanning them.
+  explicit Token_Stream(std::span<const Token> tokens);
+
+  // Returns the token distance tokens ahead of the next one without consuming
+  // it. Throws std::out_of_range if distance isn't less than LOOKAHEAD.
+  const Token& peek(std::size_t distance = 0);
+
+  // Consumes and returns the next token.
+  Token advance();
+
+  // Returns true if the next token is of the given type.
+  bool check(Token_Type type);
+
+  // Consumes the next token and returns true if it is of the given type.
+  bool match(Token_Type type);
+
+ private:
+  static constexpr std::size_t MASK = LOOKAHEAD - 1;
+
+  // Null when reading from an array.
+  Scanner* scanner;
+
+  // The array's tokens not read into the ring yet.
+  const Token* next;
+  const Token* last;
+
+  // Tokens scanned but not consumed yet, starting at head.
+  std::array<Token, LOOKAHEAD> ring;
+  std::size_t head;
+  std::size_t count;
+
+  // The TT_EOF token, repeated once the scanner has no more tokens.
+  Token eof;
+
+  // Scans tokens until the ring holds at least count tokens.
+  void fill(std::size_t count);
+};
+
+template <std::size_t LOOKAHEAD>
+Token_Stream<LOOKAHEAD>::Token_Stream(Scanner& scanner) : scanner(&scanner) {
+  this->next = nullptr;
+  this->last = nullptr;
+  this->head = 0;
+  this->count = 0;
+  this->eof = Token(Token_Type::TT_EOF, 0u, 0u);
+}
+
+template <std::size_t LOOKAHEAD>
+Token_Stream<LOOKAHEAD>::Token_Stream(std::span<const Token> tokens)
+    : scanner(nullptr) {
+  this->next = tokens.data();
+  this->last = tokens.data() + tokens.size();
+  this->head = 0;
+  this->count = 0;
+  this->eof = Token(Token_Type::TT_EOF, 0u, 0u);
+}
+
+template <std::size_t LOOKAHEAD>
+const Token& Token_Stream<LOOKAHEAD>::peek(std::size_t distance) {
+  if (distance >= LOOKAHEAD) {
+    throw std::out_of_range("Tried to peek further than the lookahead.");
+  }
+
+  fill(distance + 1);
+  return this->ring[(this->head + distance) & MASK];
+}
+
+template <std::size_t LOOKAHEAD>
+Token Token_Stream<LOOKAHEAD>::advance() {
+  fill(1);
+  Token next = this->ring[this->head];
+  this->head = (this->head + 1) & MASK;
+  this->count--;
+  return next;
+}
+
+template <std::size_t LOOKAHEAD>
+bool Token_Stream<LOOKAHEAD>::check(Token_Type type) {
+  return (peek().get_type() == type);
+}
+
+template <std::size_t LOOKAHEAD>
+bool Token_Stream<LOOKAHEAD>::match(Token_Type type) {
+  if (!check(type)) {
+    return false;
+  }
+
+  advance();
+  return true;
+}
+
+template <std::size_t LOOKAHEAD>
+void Token_Stream<LOOKAHEAD>::fill(std::size_t count) {
+  while (this->count < count) {
+    Token& slot = this->ring[(this->head + this->count) & MASK];
+    bool read;
+    if (this->scanner == nullptr) {
+      read = this->next != this->last;
+      if (read) {
+        slot = *this->next++;
+      }
+    } else {
+      read = this->scanner->next_token(slot);
+    }
+
+    if (!read) {
+      slot = this->eof;
+    } else if (slot.get_type() == Token_Type::TT_EOF) {
+      this->eof = slot;
+    }
+    this->count++;
+  }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/*******************************************************************************
+An immutable, reference-counted buffer holding the text of a Lox source. Copies
+of a Source_File share the same buffer, so tokens can refer to their lexemes
+with views into it instead of owning copies; the views stay valid for as long
+as any copy of the Source_File is alive. Offsets into a source are 32-bit, so a
+source is limited to 4 GiB.
+
+A source read from a regular file is memory-mapped rather than copied into the
+heap; other files such as pipes are read into a single buffer.
+*******************************************************************************/
+
+class Source_File {
+ public:
+  // Takes ownership of the contents; moving the string in avoids a copy.
+  // Throws std::length_error if the contents are larger than 4 GiB.
+  Source_File(std::string contents, std::string name = "");
+
+  // Maps or reads the file at path. Throws std::system_error if the file can't
+  // be opened or read and std::length_error if it is larger than 4 GiB.
+  static Source_File open(const std::string& path);
+
+  // Returns the text of the source.
+  std::string_view get_contents() const;
+
+  // Returns the name of the source, e.g. its file path.
+  const std::string& get_name() const;
+
+  // Returns the 1-based line number of the byte at offset. The table of line
+  // starts is built on the first call and shared by all copies.
+  uint64_t get_line(uint32_t offset) const;
+
+ private:
+  struct buffer {
+    std::string name;
+
+    // The text; a view into owned or into mapping.
+    std::string_view contents;
+
+    std::string owned;
+
+    // The memory mapping of the file, if it was mapped.
+    void* mapping = nullptr;
+    std::size_t mapping_length = 0;
+
+    buffer() = default;
+    buffer(const buffer&) = delete;
+    buffer& operator=(const buffer&) = delete;
+    ~buffer();
+
+    // Offsets of the first byte of every line, built lazily by get_line.
+    mutable std::once_flag line_starts_built;
+    mutable std::vector<uint32_t> line_starts;
+  };
+
+  explicit Source_File(std::shared_ptr<const buffer> data);
+
+  std::shared_ptr<const buffer> data;
+};
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <memory_resource>
+
+#include "data_structures/dynamic_array.hpp"
+#include "vm/value.hpp"
+
+/*******************************************************************************
+Holds the literal values of the tokens scanned from a source, so that tokens
+themselves only carry a 32-bit index. Literals are stored as the VM's values, so
+the compiler copies them into constant pools as they are.
+*******************************************************************************/
+
+class Literal_Table {
+ public:
+  // The literals' memory comes from resource.
+  explicit Literal_Table(
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+  // Stores a number literal and returns the index to put in its token.
+  uint32_t add_number(double value);
+
+  // Returns the number literal at the index returned by add_number.
+  double get_number(uint32_t index) const;
+
+  // Returns the literal at index as a value.
+  Value get(uint32_t index) const;
+
+  // Returns the number of stored literals.
+  std::size_t get_size() const;
+
+  // Removes all literals.
+  void clear();
+
+ private:
+  lox_pmr::Dynamic_Array<Value> values;
+};
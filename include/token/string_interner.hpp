@@ -0,0 +1,109 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <memory_resource>
+#include <string_view>
+
+#include "data_structures/dynamic_array.hpp"
+#include "data_structures/hash_table.hpp"
+#include "token/symbol_table.hpp"
+
+/*******************************************************************************
+Interns the names and string values of the tokens scanned from a source: each
+distinct text is stored once and given a 32-bit symbol, numbered in the order
+the texts are first interned, so two names are equal exactly when their
+symbols are and symbol tables can be keyed by symbols instead of strings.
+The hash of every symbol's text is computed once, when it is interned, and
+kept next to it. The symbols are read through the Symbol_Table interface.
+
+The texts are copied into blocks that are never moved, so the views returned
+by get_string stay valid for as long as the interner is alive, including after
+it is moved. All of the interner's memory comes from its memory resource.
+*******************************************************************************/
+
+// A text with its hash, the key of String_Interner's table of symbols.
+struct Interned_Text {
+  std::string_view text;
+  uint64_t hash;
+
+  bool operator==(const Interned_Text& other) const {
+    return (this->hash == other.hash) && (this->text == other.text);
+  }
+};
+
+// Interned texts carry their hash, so the table doesn't hash them again.
+template <>
+struct Hash_Table_Key<Interned_Text> {
+  using lookup_type = Interned_Text;
+
+  static uint64_t hash(const lookup_type& key) { return key.hash; }
+};
+
+class String_Interner final : public Symbol_Table {
+ public:
+  explicit String_Interner(
+      std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+  // Copying interns src's texts again, so the copy's views point into its own
+  // blocks; the symbols stay the same.
+  String_Interner(const String_Interner& src);
+  String_Interner(String_Interner&& src) noexcept;
+
+  ~String_Interner();
+
+  String_Interner& operator=(const String_Interner& src);
+  String_Interner& operator=(String_Interner&& src);
+
+  // Returns the hash interning text computes, e.g. to intern it later with
+  // the hash or to look it up in a table of symbols' hashes.
+  static uint64_t hash(std::string_view text);
+
+  // Returns the symbol of text, interning it if it is new.
+  uint32_t intern(std::string_view text);
+
+  // The same with text's hash already computed by hash or get_hash.
+  uint32_t intern(std::string_view text, uint64_t hash);
+
+  std::string_view get_string(uint32_t symbol) const override;
+  uint64_t get_hash(uint32_t symbol) const override;
+  std::size_t get_size() const override;
+
+  // Removes every symbol, keeping the memory resource.
+  void clear();
+
+ private:
+  // Texts are copied into blocks of this many bytes, or of their own length if
+  // they are longer.
+  static constexpr std::size_t BLOCK_SIZE = 1 << 14;
+
+  struct text_block {
+    char* bytes;
+    std::size_t size;
+  };
+
+  std::pmr::polymorphic_allocator<char> allocator;
+
+  // The text and hash of every symbol, indexed by symbol.
+  lox_pmr::Dynamic_Array<Interned_Text> symbols;
+
+  // Maps texts to their symbols.
+  lox_pmr::Hash_Table<Interned_Text, uint32_t> ids;
+
+  lox_pmr::Dynamic_Array<text_block> blocks;
+
+  // The unused bytes of the newest block.
+  char* position;
+  std::size_t remaining;
+
+  // Copies text into a block and returns the copy.
+  std::string_view store(std::string_view text);
+
+  // Interns src's symbols in order, so they keep their numbers if this is
+  // empty.
+  void intern_all(const String_Interner& src);
+
+  // Frees the blocks.
+  void release_blocks();
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <string_view>
+
+/*******************************************************************************
+A read-only view of the symbols the tokens of a source refer to: the text and
+hash of every name and string value, numbered as the scanner numbered them.
+A scanner's String_Interner and a loaded Token_Cache both implement it, so the
+parser, compiler and tree printer work the same whether the tokens were just
+scanned or came from a cache file.
+*******************************************************************************/
+
+class Symbol_Table {
+ public:
+  // Returns the text of symbol.
+  virtual std::string_view get_string(uint32_t symbol) const = 0;
+
+  // Returns the String_Interner::hash of the text of symbol.
+  virtual uint64_t get_hash(uint32_t symbol) const = 0;
+
+  // Returns the number of symbols.
+  virtual std::size_t get_size() const = 0;
+
+ protected:
+  // Tables aren't owned or destroyed through the view.
+  ~Symbol_Table() = default;
+};
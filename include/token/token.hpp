@@ -2,64 +2,106 @@
 
 #include <stdint.h>
 
-#include <any>
 #include <string>
+#include <string_view>
+#include <type_traits>
 
-enum class Token_Type {
-  TT_LEFT_PAREN,
-  TT_RIGHT_PAREN,
-  TT_LEFT_BRACE,
-  TT_RIGHT_BRACE,
-  TT_COMMA,
-  TT_DOT,
-  TT_MINUS,
-  TT_PLUS,
-  TT_SEMICOLON,
-  TT_SLASH,
-  TT_STAR,
-  TT_BANG,
-  TT_BANG_EQUAL,
-  TT_EQUAL,
-  TT_EQUAL_EQUAL,
-  TT_GREATER,
-  TT_GREATER_EQUAL,
-  TT_LESS,
-  TT_LESS_EQUAL,
-  TT_IDENTIFIER,
-  TT_STRING,
-  TT_NUMBER,
-  TT_AND,
-  TT_CLASS,
-  TT_ELSE,
-  TT_FALSE,
-  TT_FUN,
-  TT_FOR,
-  TT_IF,
-  TT_NIL,
-  TT_OR,
-  TT_PRINT,
-  TT_RETURN,
-  TT_SUPER,
-  TT_THIS,
-  TT_TRUE,
-  TT_VAR,
-  TT_WHILE,
-  TT_EOF
+#include "data_structures/dynamic_array.hpp"
+
+/* Every token type. Keywords also carry the spelling they are scanned from.
+The Token_Type enum, token_type_to_str and the Scanner's keyword table are all
+generated from this list, so adding a keyword here is all it takes. */
+#define LOX_TOKEN_TYPES(TOKEN, KEYWORD) \
+  TOKEN(TT_LEFT_PAREN)                  \
+  TOKEN(TT_RIGHT_PAREN)                 \
+  TOKEN(TT_LEFT_BRACE)                  \
+  TOKEN(TT_RIGHT_BRACE)                 \
+  TOKEN(TT_COMMA)                       \
+  TOKEN(TT_DOT)                         \
+  TOKEN(TT_MINUS)                       \
+  TOKEN(TT_PLUS)                        \
+  TOKEN(TT_SEMICOLON)                   \
+  TOKEN(TT_SLASH)                       \
+  TOKEN(TT_STAR)                        \
+  TOKEN(TT_BANG)                        \
+  TOKEN(TT_BANG_EQUAL)                  \
+  TOKEN(TT_EQUAL)                       \
+  TOKEN(TT_EQUAL_EQUAL)                 \
+  TOKEN(TT_GREATER)                     \
+  TOKEN(TT_GREATER_EQUAL)               \
+  TOKEN(TT_LESS)                        \
+  TOKEN(TT_LESS_EQUAL)                  \
+  TOKEN(TT_IDENTIFIER)                  \
+  TOKEN(TT_STRING)                      \
+  TOKEN(TT_NUMBER)                      \
+  KEYWORD(TT_AND, "and")                \
+  KEYWORD(TT_CLASS, "class")            \
+  KEYWORD(TT_ELSE, "else")              \
+  KEYWORD(TT_FALSE, "false")            \
+  KEYWORD(TT_FUN, "fun")                \
+  KEYWORD(TT_FOR, "for")                \
+  KEYWORD(TT_IF, "if")                  \
+  KEYWORD(TT_NIL, "nil")                \
+  KEYWORD(TT_OR, "or")                  \
+  KEYWORD(TT_PRINT, "print")            \
+  KEYWORD(TT_RETURN, "return")          \
+  KEYWORD(TT_SUPER, "super")            \
+  KEYWORD(TT_THIS, "this")              \
+  KEYWORD(TT_TRUE, "true")              \
+  KEYWORD(TT_VAR, "var")                \
+  KEYWORD(TT_WHILE, "while")            \
+  TOKEN(TT_EOF)
+
+enum class Token_Type : uint8_t {
+#define TOKEN(name) name,
+#define KEYWORD(name, spelling) name,
+  LOX_TOKEN_TYPES(TOKEN, KEYWORD)
+#undef KEYWORD
+#undef TOKEN
 };
 
-std::string token_type_to_str(Token_Type tt);
+// Returns the name of the token type, e.g. "Token_Type::TT_EOF". The names are
+// string literals, so the views never dangle.
+std::string_view token_type_to_str(Token_Type tt);
 
+/* A token is 16 bytes of plain data: its type, the position and length of its
+lexeme in the Source_File it was scanned from, and its literal. The literal of
+a number is an index into the Literal_Table, and that of an identifier or a
+string is the symbol of its name or of its value (the lexeme without the
+quotes) in the String_Interner. The line of a token is looked up from its
+offset with Source_File::get_line. Tokens are trivially copyable so token
+arrays are dense and can be copied and written out with memcpy. */
 class Token {
+  // Maps cached token arrays straight onto Tokens, so it checks their layout.
+  friend class Token_Cache;
+
  public:
   Token() = default;
-  Token(Token_Type type, const std::string& lexeme, const std::any& literal,
-        uint64_t line);
+  Token(Token_Type type, uint32_t offset, uint32_t length,
+        uint32_t literal = 0)
+      : type(type), offset(offset), length(length), literal(literal) {}
+
+  Token_Type get_type() const;
+  uint32_t get_offset() const;
+  uint32_t get_length() const;
+  uint32_t get_literal() const;
 
-  std::string to_string() const;
+  // Returns the lexeme; source must be the text the token was scanned from.
+  std::string_view get_lexeme(std::string_view source) const;
+
+  std::string to_string(std::string_view source) const;
 
  private:
   Token_Type type;
-  std::string lexeme;
-  std::any literal;
-  uint64_t line;
+  uint32_t offset;
+  uint32_t length;
+  uint32_t literal;
 };
+
+static_assert(sizeof(Token) == 16, "Tokens should stay 16 bytes.");
+static_assert(std::is_trivially_copyable_v<Token>,
+              "Tokens should be copyable with memcpy.");
+
+/* An array of tokens. Its memory comes from a std::pmr::memory_resource, e.g. a
+Monotonic_Resource so that the tokens of a compilation live in its Arena. */
+using Token_Array = lox_pmr::Dynamic_Array<Token>;
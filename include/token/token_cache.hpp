@@ -0,0 +1,113 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "data_structures/dynamic_array.hpp"
+#include "source_file/source_file.hpp"
+#include "token/literal_table.hpp"
+#include "token/symbol_table.hpp"
+#include "token/token.hpp"
+
+/*******************************************************************************
+An on-disk cache of the tokens scanned from a source, so that an unchanged
+source doesn't have to be scanned again. A cache file is keyed by a hash of the
+source's contents and is memory-mapped when loaded; the tokens are used where
+they are in the mapping, without being parsed or copied. Only the number
+literals are copied, into a Literal_Table. The scanner's symbol table, the text
+and hash of every symbol, is stored too and also used where it is in the
+mapping, so loading never hashes or interns the tokens' texts again.
+
+A cache file is laid out as follows, with all numbers little-endian:
+
+  char    magic[4]      "LXTC"
+  uint32  version       FORMAT_VERSION
+  uint32  token_types   The number of token types, which changes the encoding
+  uint32  symbol_check  The low half of String_Interner::hash("LXTC"), so that
+                        hashes written by a build that hashes differently miss
+  uint64  hash          content_hash of the source
+  uint64  length        Length of the source
+  uint64  token_count
+  uint64  number_count
+  uint64  symbol_count
+  uint64  symbol_bytes  Length of the symbols' texts together
+  tokens  token_count records of 16 bytes: a uint8 type, 3 zero bytes, then
+          uint32 offset, length and literal, which is the layout of Token
+  float64 numbers[number_count]
+  symbols symbol_count records of 16 bytes: uint64 hash, then uint32 offset
+          and length of the text in texts
+  char    texts[symbol_bytes]
+
+Load checks that every token, literal and symbol is in range, so a damaged file
+misses rather than crashing; like the numbers, the texts aren't checked against
+the source.
+
+Caches are only written and read on little-endian machines; elsewhere store
+does nothing and load always misses.
+*******************************************************************************/
+
+class Token_Cache {
+ public:
+  // Bumped whenever the format or the meaning of the tokens changes.
+  static constexpr uint32_t FORMAT_VERSION = 3;
+
+  // Returns a 64-bit hash of the text that stays the same across runs.
+  static uint64_t content_hash(std::string_view text);
+
+  // Returns the path of the cache file for source: the source's path with
+  // ".lxtc" appended if directory is empty, or the hash of its contents in
+  // directory otherwise.
+  static std::string path_for(const Source_File& source,
+                              const std::string& directory);
+
+  // Writes the tokens, literals and symbols scanned from source to the cache
+  // file at path, replacing it atomically. Throws std::system_error on
+  // failure.
+  static void store(const std::string& path, const Source_File& source,
+                    Token_Array& tokens, const Literal_Table& literals,
+                    const Symbol_Table& symbols);
+
+  // Maps the cache file at path. Returns true if it holds the tokens of
+  // source, false if it is missing, stale or damaged.
+  bool load(const std::string& path, const Source_File& source);
+
+  // The cached tokens; valid while this Token_Cache is alive.
+  const Token* begin() const;
+  const Token* end() const;
+
+  // Returns the number literals of the cached tokens.
+  const Literal_Table& get_literals() const;
+
+  // Returns the names and string values the cached tokens' symbols refer to,
+  // read where they are in the mapping.
+  const Symbol_Table& get_symbols() const;
+
+ private:
+  // The symbol records and their texts in the mapping.
+  class Mapped_Symbols final : public Symbol_Table {
+   public:
+    std::string_view get_string(uint32_t symbol) const override;
+    uint64_t get_hash(uint32_t symbol) const override;
+    std::size_t get_size() const override;
+
+    const char* records = nullptr;
+    std::size_t count = 0;
+    std::string_view texts;
+  };
+
+  // The mapped cache file.
+  Source_File file = Source_File(std::string());
+
+  const Token* tokens = nullptr;
+  std::size_t token_count = 0;
+
+  Literal_Table literals;
+
+  Mapped_Symbols symbols;
+
+  // Checks that a Token is laid out like a token record.
+  static constexpr bool layout_matches();
+};
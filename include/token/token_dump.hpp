@@ -0,0 +1,69 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+#include "token/literal_table.hpp"
+#include "token/token.hpp"
+
+/*******************************************************************************
+Writes tokens to a file descriptor, formatting them into one reusable buffer
+that is written out with a single write() whenever it fills up, instead of
+building strings and flushing once per token.
+
+The text format is one line per token, e.g.
+
+  type: Token_Type::TT_IDENTIFIER lexeme: answer
+
+The binary format starts with the magic bytes "LXTK" and a version byte (1),
+followed by one record per token with all numbers little-endian:
+
+  uint8   type        The Token_Type value.
+  uint32  offset      Offset of the lexeme in the source.
+  uint32  length      Length of the lexeme, followed by its bytes.
+  float64 value       Only for TT_NUMBER; the literal value.
+*******************************************************************************/
+
+class Token_Dump {
+ public:
+  enum class Format : uint8_t { TEXT, BINARY };
+
+  // Writes to the file descriptor fd, e.g. STDOUT_FILENO, which stays open.
+  Token_Dump(int fd, Format format);
+
+  Token_Dump(const Token_Dump&) = delete;
+  Token_Dump& operator=(const Token_Dump&) = delete;
+
+  // Writes out what is left in the buffer; errors are ignored here, so call
+  // flush to see them.
+  ~Token_Dump();
+
+  // Adds a token scanned from source, whose number literals are in literals.
+  void write(const Token& token, std::string_view source,
+             const Literal_Table& literals);
+
+  // Writes out the buffer. Throws std::system_error if the write fails.
+  void flush();
+
+ private:
+  static constexpr std::size_t BUFFER_SIZE = 1 << 16;
+
+  int fd;
+  Format format;
+
+  std::unique_ptr<char[]> buffer;
+  std::size_t used;
+
+  // Appends bytes to the buffer, flushing it first if they don't fit. Bytes
+  // that don't fit in an empty buffer are written out directly.
+  void append(const char* bytes, std::size_t count);
+  void append(std::string_view text);
+  void append_u32(uint32_t value);
+  void append_f64(double value);
+
+  // Writes count bytes to fd, retrying short and interrupted writes.
+  void write_all(const char* bytes, std::size_t count);
+};
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <string_view>
+
+#include "data_structures/dynamic_array.hpp"
+#include "vm/value.hpp"
+
+/* Every instruction, with the format of its operands and its effect on the
+height of the stack. Operands follow the op code; 16-bit operands are stored
+high byte first. The Op_Code enum, op_code_to_str, op_code_format and
+op_code_stack_effect are all generated from this list.
+
+  SIMPLE    no operands.
+  BYTE      an 8-bit slot or count.
+  SHORT     a 16-bit global slot.
+  CONSTANT  a 16-bit index into the constant pool.
+  JUMP      a 16-bit forward offset from the end of the instruction.
+  LOOP      a 16-bit backward offset from the end of the instruction.
+  INVOKE    a 16-bit constant holding the method name and an 8-bit argument
+            count.
+  CLOSURE   a 16-bit constant holding the function, then an 8-bit is-local
+            flag and an 8-bit index for each of the function's upvalues.
+
+The stack effects of OP_CALL, OP_INVOKE and OP_SUPER_INVOKE leave out the
+arguments they pop. */
+#define LOX_OP_CODES(OP)                     \
+  OP(OP_CONSTANT, CONSTANT, 1)               \
+  OP(OP_NIL, SIMPLE, 1)                      \
+  OP(OP_TRUE, SIMPLE, 1)                     \
+  OP(OP_FALSE, SIMPLE, 1)                    \
+  OP(OP_POP, SIMPLE, -1)                     \
+  OP(OP_GET_LOCAL, BYTE, 1)                  \
+  OP(OP_SET_LOCAL, BYTE, 0)                  \
+  OP(OP_GET_GLOBAL, SHORT, 1)                \
+  OP(OP_DEFINE_GLOBAL, SHORT, -1)            \
+  OP(OP_SET_GLOBAL, SHORT, 0)                \
+  OP(OP_GET_UPVALUE, BYTE, 1)                \
+  OP(OP_SET_UPVALUE, BYTE, 0)                \
+  OP(OP_GET_PROPERTY, CONSTANT, 0)           \
+  OP(OP_SET_PROPERTY, CONSTANT, -1)          \
+  OP(OP_GET_SUPER, CONSTANT, -1)             \
+  OP(OP_EQUAL, SIMPLE, -1)                   \
+  OP(OP_NOT_EQUAL, SIMPLE, -1)               \
+  OP(OP_GREATER, SIMPLE, -1)                 \
+  OP(OP_GREATER_EQUAL, SIMPLE, -1)           \
+  OP(OP_LESS, SIMPLE, -1)                    \
+  OP(OP_LESS_EQUAL, SIMPLE, -1)              \
+  OP(OP_ADD, SIMPLE, -1)                     \
+  OP(OP_SUBTRACT, SIMPLE, -1)                \
+  OP(OP_MULTIPLY, SIMPLE, -1)                \
+  OP(OP_DIVIDE, SIMPLE, -1)                  \
+  OP(OP_NOT, SIMPLE, 0)                      \
+  OP(OP_NEGATE, SIMPLE, 0)                   \
+  OP(OP_PRINT, SIMPLE, -1)                   \
+  OP(OP_JUMP, JUMP, 0)                       \
+  OP(OP_JUMP_IF_FALSE, JUMP, 0)              \
+  OP(OP_LOOP, LOOP, 0)                       \
+  OP(OP_CALL, BYTE, 0)                       \
+  OP(OP_INVOKE, INVOKE, 0)                   \
+  OP(OP_SUPER_INVOKE, INVOKE, -1)            \
+  OP(OP_CLOSURE, CLOSURE, 1)                 \
+  OP(OP_CLOSE_UPVALUE, SIMPLE, -1)           \
+  OP(OP_RETURN, SIMPLE, -1)                  \
+  OP(OP_CLASS, CONSTANT, 1)                  \
+  OP(OP_INHERIT, SIMPLE, -1)                 \
+  OP(OP_METHOD, CONSTANT, -1)
+
+enum class Op_Code : uint8_t {
+#define OP(name, format, effect) name,
+  LOX_OP_CODES(OP)
+#undef OP
+};
+
+enum class Operand_Format : uint8_t {
+  SIMPLE,
+  BYTE,
+  SHORT,
+  CONSTANT,
+  JUMP,
+  LOOP,
+  INVOKE,
+  CLOSURE
+};
+
+// Returns the name of the op code, e.g. "OP_RETURN".
+std::string_view op_code_to_str(Op_Code op);
+
+Operand_Format op_code_format(Op_Code op);
+
+// Returns by how much the instruction changes the height of the stack.
+int op_code_stack_effect(Op_Code op);
+
+/*******************************************************************************
+A compiled function's bytecode, the constants it refers to and the source line
+of every byte. Lines are run-length encoded: consecutive bytes from the same
+line share one entry holding the line and the offset of the first of them, so
+the table grows with the number of line changes rather than with the code.
+*******************************************************************************/
+
+class Chunk {
+ public:
+  // The most constants a chunk can hold; constant operands are 16-bit.
+  static constexpr std::size_t MAX_CONSTANTS = 1 << 16;
+
+  // Appends a byte of code compiled from the given source line.
+  void write(uint8_t byte, uint32_t line);
+
+  // Overwrites the byte at offset, e.g. to patch a jump.
+  void patch(std::size_t offset, uint8_t byte);
+
+  // Adds a value to the constant pool and returns its index.
+  std::size_t add_constant(Value value);
+
+  // Returns the number of bytes of code.
+  std::size_t get_size() const;
+
+  // Returns the byte at offset.
+  uint8_t get_byte(std::size_t offset) const;
+
+  // Returns the code, for the VM to execute.
+  uint8_t* get_code();
+
+  // Returns the number of constants.
+  std::size_t get_constant_count() const;
+
+  // Returns the constant at index.
+  Value get_constant(std::size_t index) const;
+
+  // Returns the constant pool, for the VM to read.
+  Value* get_constants();
+
+  // Returns the source line of the byte at offset.
+  uint32_t get_line(std::size_t offset) const;
+
+ private:
+  // A run of bytes compiled from one line, starting at start.
+  struct line_run {
+    uint32_t start;
+    uint32_t line;
+  };
+
+  Dynamic_Array<uint8_t> code;
+  Dynamic_Array<Value> constants;
+  Dynamic_Array<line_run> lines;
+};
@@ -0,0 +1,222 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <string_view>
+
+#include "data_structures/dynamic_array.hpp"
+#include "data_structures/hash_table.hpp"
+#include "error_reporter/error_reporter.hpp"
+#include "parser/ast.hpp"
+#include "source_file/source_file.hpp"
+#include "token/literal_table.hpp"
+#include "token/symbol_table.hpp"
+#include "vm/chunk.hpp"
+#include "vm/object.hpp"
+#include "vm/vm.hpp"
+
+/*******************************************************************************
+Compiles a parsed program to bytecode in a single pass over its syntax tree,
+emitting each node's code as it is visited, with the book's scoping rules:
+locals live in stack slots and are resolved at compile time, variables captured
+by closures become upvalues and everything else is a global, resolved to a slot
+by the VM. The tree is walked recursively, which is safe because the Parser
+never builds one deeper than Parser::MAX_DEPTH.
+
+Locals are named by their symbols, so resolving a name compares 32-bit
+integers rather than strings. The compiler also tracks how high every
+function's code can grow the stack, so that a call can check there is room for
+the whole frame once instead of every push checking.
+
+Errors are reported like the book's, e.g. "[line 3] Error at 'return': Can't
+return from top-level code."; compilation goes on after an error to report the
+rest, but no function is returned.
+*******************************************************************************/
+
+class Compiler {
+ public:
+  // The most locals and upvalues a function can have; their operands are
+  // 8-bit.
+  static constexpr int MAX_LOCALS = 256;
+  static constexpr int MAX_UPVALUES = 256;
+
+  Compiler(VM& vm, const Source_File& source, const Ast& ast,
+           const Literal_Table& literals, const Symbol_Table& symbols,
+           Error_Reporter& e);
+
+  // Compiles the program into the top-level script function; nullptr if it
+  // has errors. The VM must not collect garbage while compiling.
+  Obj_Function* compile();
+
+ private:
+  enum class Function_Type : uint8_t {
+    FT_FUNCTION,
+    FT_INITIALIZER,
+    FT_METHOD,
+    FT_SCRIPT
+  };
+
+  // Names of locals that aren't symbols: the hidden slot 0 of functions, and
+  // "this" and "super".
+  static constexpr uint32_t NO_NAME = UINT32_MAX;
+  static constexpr uint32_t THIS_NAME = UINT32_MAX - 1;
+  static constexpr uint32_t SUPER_NAME = UINT32_MAX - 2;
+
+  struct local {
+    uint32_t name;
+
+    // The scope depth the local was declared at; -1 until it is initialized.
+    int depth;
+
+    bool is_captured;
+  };
+
+  struct upvalue {
+    uint8_t index;
+    bool is_local;
+  };
+
+  // The state of a function being compiled; functions nest.
+  struct function_state {
+    function_state* enclosing;
+    Obj_Function* function;
+    Function_Type type;
+
+    local locals[MAX_LOCALS];
+    int local_count;
+    upvalue upvalues[MAX_UPVALUES];
+    int scope_depth;
+
+    // The height of the stack at the current instruction, counting the
+    // callee's slot.
+    int stack_height;
+
+    // The constant index of every number, by its bits, and string already in
+    // the function's constant pool.
+    Hash_Table<uint64_t, uint16_t> number_constants;
+    Hash_Table<uint64_t, uint16_t> string_constants;
+  };
+
+  struct class_state {
+    class_state* enclosing;
+    bool has_superclass;
+  };
+
+  VM& vm;
+  const Source_File& source;
+  const Ast& ast;
+  const Literal_Table& literals;
+  const Symbol_Table& symbols;
+  Error_Reporter& e;
+
+  function_state* current = nullptr;
+  class_state* current_class = nullptr;
+
+  // The line of the node being compiled.
+  uint32_t line = 1;
+
+  // The string object and global slot of each symbol, created on first use.
+  Dynamic_Array<Obj_String*> strings;
+  Dynamic_Array<uint32_t> global_slots;
+
+  bool had_error = false;
+
+  void begin_function(function_state& state, Function_Type type,
+                      uint32_t name);
+  Obj_Function* end_function();
+
+  void statement(Node_Id id);
+  void expression(Node_Id id);
+
+  void block(uint32_t list);
+  void var_declaration(const Ast_Node& node);
+  void function_declaration(const Ast_Node& node);
+  void class_declaration(const Ast_Node& node);
+  void if_statement(const Ast_Node& node);
+  void while_statement(const Ast_Node& node);
+  void return_statement(const Ast_Node& node);
+
+  // Compiles node's parameters and body into a new function and emits the
+  // closure creating it.
+  void function(const Ast_Node& node, Function_Type type);
+
+  void binary(const Ast_Node& node);
+  void logical(const Ast_Node& node);
+  void call(const Ast_Node& node);
+
+  // Reports a super expression outside of a subclass; returns whether it is
+  // valid.
+  bool check_super(const Ast_Node& node);
+
+  // Compiles the arguments of list and returns their count.
+  uint8_t arguments(uint32_t list);
+
+  /***********************************************************************
+  VARIABLES AND SCOPES
+  ***********************************************************************/
+  void begin_scope();
+  void end_scope();
+
+  // Emits a read of the variable name, or an assignment of the value on top
+  // of the stack to it.
+  void named_variable(uint32_t name, bool assign, const Ast_Node& node);
+
+  int resolve_local(function_state& state, uint32_t name,
+                    const Ast_Node& node);
+  int resolve_upvalue(function_state& state, uint32_t name,
+                      const Ast_Node& node);
+  int add_upvalue(function_state& state, uint8_t index, bool is_local,
+                  uint32_t name, const Ast_Node& node);
+
+  // Declares a local in the current scope; globals aren't declared.
+  void declare_variable(uint32_t name, const Ast_Node& node);
+  void add_local(uint32_t name, const Ast_Node& node);
+  void mark_initialized();
+
+  // Defines the variable just declared: a local becomes usable and a global
+  // is set from the top of the stack.
+  void define_variable(uint32_t global);
+
+  // Returns the global slot of symbol.
+  uint32_t global(uint32_t symbol, const Ast_Node& node);
+
+  Obj_String* string(uint32_t symbol);
+
+  // Returns the text of a local's name, for error messages.
+  std::string_view name_text(uint32_t name) const;
+
+  /***********************************************************************
+  EMITTING CODE
+  ***********************************************************************/
+  Chunk& chunk();
+
+  void emit_byte(uint8_t byte);
+  void emit_short(uint16_t value);
+
+  // Emits op and accounts for its stack effect.
+  void emit_op(Op_Code op);
+  void emit_op(Op_Code op, uint8_t operand);
+  void emit_op_short(Op_Code op, uint16_t operand);
+
+  // Changes the tracked stack height, e.g. by the arguments a call pops.
+  void adjust_stack(int delta);
+
+  // Emits a jump with a placeholder offset and returns the offset's position.
+  std::size_t emit_jump(Op_Code op);
+  void patch_jump(std::size_t offset, const Ast_Node& node);
+  void emit_loop(std::size_t loop_start, const Ast_Node& node);
+
+  // Emits the implicit return at the end of a function.
+  void emit_return();
+
+  uint16_t make_constant(Value value, const Ast_Node& node);
+
+  /***********************************************************************
+  ERRORS
+  ***********************************************************************/
+  // Reports message at lexeme, the text of node's token.
+  void error(const Ast_Node& node, std::string_view lexeme,
+             std::string_view message);
+
+  uint32_t line_of(const Ast_Node& node) const;
+};
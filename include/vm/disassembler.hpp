@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "vm/chunk.hpp"
+#include "vm/object.hpp"
+
+/*******************************************************************************
+Prints bytecode in the book's format, one instruction per line: the offset, the
+source line ("|" when it is the same as the previous instruction's), the op
+code and its operands, with constants printed as values and jumps with their
+targets, e.g.
+
+  0000    1 OP_CONSTANT         0 '1.5'
+  0003    | OP_JUMP_IF_FALSE    3 -> 12
+*******************************************************************************/
+
+// Appends the instruction at offset and returns the offset of the next one.
+std::size_t disassemble_instruction(const Chunk& chunk, std::size_t offset,
+                                    std::string& out);
+
+// Appends a "== name ==" header and every instruction of chunk.
+void disassemble_chunk(const Chunk& chunk, std::string_view name,
+                       std::string& out);
+
+// Appends function's chunk, then the chunks of the functions it defines.
+void disassemble_function(const Obj_Function* function, std::string& out);
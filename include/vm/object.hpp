@@ -0,0 +1,142 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <string_view>
+
+#include "data_structures/hash_table.hpp"
+#include "vm/chunk.hpp"
+#include "vm/value.hpp"
+
+/*******************************************************************************
+The objects Lox values can refer to, all allocated by the VM. Every object
+starts with an Obj header holding its type, the collector's mark bit and the
+next object on the VM's list of every object, which the collector sweeps. A
+string's characters are allocated right after it, so a string is a single
+allocation.
+*******************************************************************************/
+
+enum class Object_Type : uint8_t {
+  OT_STRING,
+  OT_FUNCTION,
+  OT_NATIVE,
+  OT_CLOSURE,
+  OT_UPVALUE,
+  OT_CLASS,
+  OT_INSTANCE,
+  OT_BOUND_METHOD
+};
+
+struct Obj {
+  Object_Type type;
+
+  // Whether the collector found the object reachable.
+  bool marked = false;
+
+  Obj* next = nullptr;
+};
+
+struct Obj_String : Obj {
+  static constexpr Object_Type TYPE = Object_Type::OT_STRING;
+
+  uint32_t length;
+  uint64_t hash;
+
+  // Returns the characters, which follow the object.
+  std::string_view get_text() const {
+    return std::string_view(reinterpret_cast<const char*>(this + 1),
+                            this->length);
+  }
+};
+
+// Strings are interned, so tables of them compare pointers and reuse the hash
+// computed when the string was created.
+template <>
+struct Hash_Table_Key<Obj_String*> {
+  using lookup_type = Obj_String*;
+
+  static uint64_t hash(const lookup_type& key) { return key->hash; }
+};
+
+struct Obj_Function : Obj {
+  static constexpr Object_Type TYPE = Object_Type::OT_FUNCTION;
+
+  uint8_t arity = 0;
+  uint32_t upvalue_count = 0;
+
+  // The most stack slots a call uses, including the callee's slot.
+  uint32_t max_stack = 0;
+
+  Chunk chunk;
+
+  // nullptr for the top-level script.
+  Obj_String* name = nullptr;
+};
+
+// A function implemented in C++; it receives its arguments in args.
+using Native_Function = Value (*)(int arg_count, Value* args);
+
+struct Obj_Native : Obj {
+  static constexpr Object_Type TYPE = Object_Type::OT_NATIVE;
+
+  Native_Function function;
+};
+
+// A variable captured by a closure. While the variable is on the stack the
+// upvalue points to its slot; when it goes out of scope it is moved into
+// closed and the upvalue points there.
+struct Obj_Upvalue : Obj {
+  static constexpr Object_Type TYPE = Object_Type::OT_UPVALUE;
+
+  Value* location;
+  Value closed;
+
+  // The next of the VM's open upvalues, which are sorted by slot.
+  Obj_Upvalue* next_open = nullptr;
+};
+
+struct Obj_Closure : Obj {
+  static constexpr Object_Type TYPE = Object_Type::OT_CLOSURE;
+
+  Obj_Function* function;
+
+  // function->upvalue_count upvalues, allocated after the closure.
+  Obj_Upvalue** get_upvalues() {
+    return reinterpret_cast<Obj_Upvalue**>(this + 1);
+  }
+};
+
+struct Obj_Class : Obj {
+  static constexpr Object_Type TYPE = Object_Type::OT_CLASS;
+
+  Obj_String* name;
+  Hash_Table<Obj_String*, Value> methods;
+};
+
+struct Obj_Instance : Obj {
+  static constexpr Object_Type TYPE = Object_Type::OT_INSTANCE;
+
+  Obj_Class* klass;
+  Hash_Table<Obj_String*, Value> fields;
+};
+
+struct Obj_Bound_Method : Obj {
+  static constexpr Object_Type TYPE = Object_Type::OT_BOUND_METHOD;
+
+  Value receiver;
+  Obj_Closure* method;
+};
+
+// Returns whether value refers to an object of the given type.
+inline bool is_object_type(Value value, Object_Type type) {
+  return value.is_object() && (value.get_object()->type == type);
+}
+
+// Returns the object value refers to as a T; value must refer to a T.
+template <typename T>
+T* as_object(Value value) {
+  return static_cast<T*>(value.get_object());
+}
+
+// Appends object as print shows it.
+void write_object(const Obj* object, std::string& out);
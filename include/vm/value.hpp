@@ -0,0 +1,274 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <bit>
+#include <string>
+
+struct Obj;
+
+/*******************************************************************************
+A Lox value: nil, a boolean, a number or a reference to an object on the VM's
+heap, passed and stored by value everywhere: in token literals, on the VM's
+stack, in constant pools, globals and fields.
+
+Values are NaN-boxed into 64 bits. A double is stored as itself. Every other
+value is hidden in the payload of a quiet NaN, which arithmetic never produces:
+nil, false, true and undefined are small tags in the low bits, and an object
+is its pointer, which fits in the low 48 bits, with the sign bit set. Telling
+a number apart is one mask and compare, and a stack of values is an array of
+64-bit words.
+
+Building with LOX_TAGGED_VALUES defined swaps in a tagged union of a type and
+the payloads instead, twice the size, which a debugger shows directly.
+
+Undefined is not a Lox value; it marks a global slot whose variable hasn't been
+defined yet, so that reading it is reported as an error.
+*******************************************************************************/
+
+enum class Value_Type : uint8_t {
+  VT_NIL,
+  VT_BOOL,
+  VT_NUMBER,
+  VT_OBJECT,
+  VT_UNDEFINED
+};
+
+class Value {
+ public:
+  // Constructs nil.
+  Value();
+
+  static Value nil();
+  static Value boolean(bool value);
+  static Value number(double value);
+  static Value object(Obj* value);
+  static Value undefined();
+
+  Value_Type get_type() const;
+
+  bool is_nil() const;
+  bool is_bool() const;
+  bool is_number() const;
+  bool is_object() const;
+  bool is_undefined() const;
+
+  // The payloads; only valid for values of the matching type.
+  bool get_bool() const;
+  double get_number() const;
+  Obj* get_object() const;
+
+  // nil and false are falsey; every other value is truthy.
+  bool is_falsey() const;
+
+  // Lox equality: values of different types are never equal, numbers compare
+  // as doubles and objects by identity, which for strings is by contents
+  // because strings are interned.
+  bool operator==(const Value& other) const;
+
+ private:
+#if defined(LOX_TAGGED_VALUES)
+  Value_Type type;
+  union {
+    bool boolean;
+    double number;
+    Obj* object;
+  } as;
+#else
+  // The exponent and the top two mantissa bits; all set in a value that isn't
+  // a number.
+  static constexpr uint64_t QUIET_NAN = 0x7FFC000000000000ULL;
+
+  // Set, with QUIET_NAN, in a value that is an object.
+  static constexpr uint64_t SIGN_BIT = 0x8000000000000000ULL;
+
+  static constexpr uint64_t TAG_NIL = 1;
+  static constexpr uint64_t TAG_FALSE = 2;
+  static constexpr uint64_t TAG_TRUE = 3;
+  static constexpr uint64_t TAG_UNDEFINED = 4;
+
+  uint64_t bits;
+
+  explicit constexpr Value(uint64_t bits) : bits(bits) {}
+#endif
+};
+
+#if !defined(LOX_TAGGED_VALUES)
+static_assert(sizeof(Value) == sizeof(uint64_t),
+              "NaN-boxed values should be 64 bits.");
+#endif
+
+// Appends value as print shows it.
+void write_value(Value value, std::string& out);
+
+/*******************************************************************************
+Inline definitions; values are handled in the VM's innermost loop.
+*******************************************************************************/
+#if defined(LOX_TAGGED_VALUES)
+
+inline Value::Value() : type(Value_Type::VT_NIL) { this->as.number = 0; }
+
+inline Value Value::nil() { return Value(); }
+
+inline Value Value::boolean(bool value) {
+  Value v;
+  v.type = Value_Type::VT_BOOL;
+  v.as.boolean = value;
+  return v;
+}
+
+inline Value Value::number(double value) {
+  Value v;
+  v.type = Value_Type::VT_NUMBER;
+  v.as.number = value;
+  return v;
+}
+
+inline Value Value::object(Obj* value) {
+  Value v;
+  v.type = Value_Type::VT_OBJECT;
+  v.as.object = value;
+  return v;
+}
+
+inline Value Value::undefined() {
+  Value v;
+  v.type = Value_Type::VT_UNDEFINED;
+  return v;
+}
+
+inline Value_Type Value::get_type() const { return this->type; }
+
+inline bool Value::is_nil() const { return this->type == Value_Type::VT_NIL; }
+
+inline bool Value::is_bool() const {
+  return this->type == Value_Type::VT_BOOL;
+}
+
+inline bool Value::is_number() const {
+  return this->type == Value_Type::VT_NUMBER;
+}
+
+inline bool Value::is_object() const {
+  return this->type == Value_Type::VT_OBJECT;
+}
+
+inline bool Value::is_undefined() const {
+  return this->type == Value_Type::VT_UNDEFINED;
+}
+
+inline bool Value::get_bool() const { return this->as.boolean; }
+
+inline double Value::get_number() const { return this->as.number; }
+
+inline Obj* Value::get_object() const { return this->as.object; }
+
+inline bool Value::is_falsey() const {
+  return is_nil() || (is_bool() && !this->as.boolean);
+}
+
+inline bool Value::operator==(const Value& other) const {
+  if (this->type != other.type) {
+    return false;
+  }
+
+  switch (this->type) {
+    case Value_Type::VT_BOOL:
+      return this->as.boolean == other.as.boolean;
+    case Value_Type::VT_NUMBER:
+      return this->as.number == other.as.number;
+    case Value_Type::VT_OBJECT:
+      return this->as.object == other.as.object;
+    default:
+      return true;
+  }
+}
+
+#else
+
+inline Value::Value() : bits(QUIET_NAN | TAG_NIL) {}
+
+inline Value Value::nil() { return Value(); }
+
+inline Value Value::boolean(bool value) {
+  return Value(QUIET_NAN | (value ? TAG_TRUE : TAG_FALSE));
+}
+
+inline Value Value::number(double value) {
+  return Value(std::bit_cast<uint64_t>(value));
+}
+
+inline Value Value::object(Obj* value) {
+  return Value(SIGN_BIT | QUIET_NAN | (uint64_t)(uintptr_t)value);
+}
+
+inline Value Value::undefined() { return Value(QUIET_NAN | TAG_UNDEFINED); }
+
+inline Value_Type Value::get_type() const {
+  if (is_number()) {
+    return Value_Type::VT_NUMBER;
+  }
+
+  if (is_object()) {
+    return Value_Type::VT_OBJECT;
+  }
+
+  switch (this->bits & ~QUIET_NAN) {
+    case TAG_NIL:
+      return Value_Type::VT_NIL;
+    case TAG_UNDEFINED:
+      return Value_Type::VT_UNDEFINED;
+    default:
+      return Value_Type::VT_BOOL;
+  }
+}
+
+inline bool Value::is_nil() const {
+  return this->bits == (QUIET_NAN | TAG_NIL);
+}
+
+inline bool Value::is_bool() const {
+  // TAG_FALSE and TAG_TRUE differ only in the lowest bit.
+  return (this->bits | 1) == (QUIET_NAN | TAG_TRUE);
+}
+
+inline bool Value::is_number() const {
+  return (this->bits & QUIET_NAN) != QUIET_NAN;
+}
+
+inline bool Value::is_object() const {
+  return (this->bits & (SIGN_BIT | QUIET_NAN)) == (SIGN_BIT | QUIET_NAN);
+}
+
+inline bool Value::is_undefined() const {
+  return this->bits == (QUIET_NAN | TAG_UNDEFINED);
+}
+
+inline bool Value::get_bool() const {
+  return this->bits == (QUIET_NAN | TAG_TRUE);
+}
+
+inline double Value::get_number() const {
+  return std::bit_cast<double>(this->bits);
+}
+
+inline Obj* Value::get_object() const {
+  return (Obj*)(uintptr_t)(this->bits & ~(SIGN_BIT | QUIET_NAN));
+}
+
+inline bool Value::is_falsey() const {
+  return (this->bits == (QUIET_NAN | TAG_NIL)) ||
+         (this->bits == (QUIET_NAN | TAG_FALSE));
+}
+
+inline bool Value::operator==(const Value& other) const {
+  // NaN isn't equal to itself and 0 equals -0, so numbers can't be compared
+  // by their bits.
+  if (is_number() && other.is_number()) {
+    return get_number() == other.get_number();
+  }
+
+  return this->bits == other.bits;
+}
+
+#endif
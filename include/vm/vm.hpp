@@ -0,0 +1,261 @@
+#pragma once
+
+#include <stdint.h>
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "data_structures/dynamic_array.hpp"
+#include "data_structures/hash_table.hpp"
+#include "error_reporter/error_reporter.hpp"
+#include "source_file/source_file.hpp"
+#include "token/literal_table.hpp"
+#include "token/string_interner.hpp"
+#include "token/symbol_table.hpp"
+#include "token/token.hpp"
+#include "vm/chunk.hpp"
+#include "vm/object.hpp"
+#include "vm/value.hpp"
+
+class Parser;
+
+enum class Interpret_Result : uint8_t {
+  IR_OK,
+  IR_COMPILE_ERROR,
+  IR_RUNTIME_ERROR
+};
+
+/*******************************************************************************
+The bytecode virtual machine. interpret parses a source, or its tokens if they
+were already scanned, compiles it to bytecode with the Compiler and runs it on
+a stack of values, with one call frame per active function call. The dispatch
+loop keeps the instruction pointer in a local variable and switches on each op
+code.
+
+Globals are resolved to slots when they are compiled, so reading one is an
+index into an array rather than a lookup by name; the slots, like every other
+piece of state, persist across calls to interpret, so a REPL can run one line at
+a time on the same VM.
+
+Strings are interned, so equal strings are the same object and compare by
+pointer. Objects are freed by a mark-sweep collector, which runs when the bytes
+allocated since the last collection pass a threshold that grows with the heap.
+The roots are the stack, the call frames' closures, the open upvalues and the
+globals; the table of interned strings is weak.
+
+Output from print is buffered and written to the output stream when the buffer
+fills up, when a runtime error is reported and when interpret returns.
+*******************************************************************************/
+
+class VM {
+ public:
+  // The deepest calls can nest.
+  static constexpr std::size_t FRAMES_MAX = 256;
+
+  // The number of values the stack holds.
+  static constexpr std::size_t STACK_MAX = FRAMES_MAX * 256;
+
+  explicit VM(std::ostream& out = std::cout);
+  ~VM();
+
+  VM(const VM&) = delete;
+  VM& operator=(const VM&) = delete;
+
+  // Compiles and runs source, reporting errors to e.
+  Interpret_Result interpret(const Source_File& source, Error_Reporter& e);
+
+  // The same with the tokens of source already scanned, ending with TT_EOF,
+  // and their literals and symbols, e.g. loaded from a Token_Cache.
+  Interpret_Result interpret(const Source_File& source,
+                             std::span<const Token> tokens,
+                             const Literal_Table& literals,
+                             const Symbol_Table& symbols, Error_Reporter& e);
+
+  // Compiles source and appends the disassembly of its bytecode to out.
+  // Returns false if it has compile errors.
+  bool disassemble(const Source_File& source, Error_Reporter& e,
+                   std::string& out);
+
+  // When set, the collector runs before every allocation, so that objects the
+  // VM forgets to keep reachable are freed right away; for testing.
+  void set_stress_collection(bool stress);
+
+  // Returns the number of bytes of objects currently allocated.
+  std::size_t get_bytes_allocated() const;
+
+  /***********************************************************************
+  FOR THE COMPILER
+  ***********************************************************************/
+  // Returns the string object with text, creating it if it doesn't exist.
+  Obj_String* intern(std::string_view text);
+
+  Obj_Function* new_function();
+
+  // Returns the slot of the global variable name, giving it a new slot if it
+  // doesn't have one yet.
+  uint32_t global_slot(Obj_String* name);
+
+ private:
+  struct call_frame {
+    Obj_Closure* closure;
+    uint8_t* ip;
+
+    // The frame's first stack slot, which holds the callee.
+    Value* slots;
+  };
+
+  // The heap grows by this factor between collections.
+  static constexpr std::size_t HEAP_GROW_FACTOR = 2;
+
+  static constexpr std::size_t FIRST_COLLECTION = 1 << 20;
+
+  // Output is written out once the buffer holds this many bytes.
+  static constexpr std::size_t OUTPUT_BUFFER_SIZE = 1 << 16;
+
+  std::ostream& out;
+  std::string output;
+
+  // Where runtime errors go while interpret runs.
+  Error_Reporter* reporter = nullptr;
+
+  std::unique_ptr<Value[]> stack;
+  Value* stack_top;
+
+  call_frame frames[FRAMES_MAX];
+  std::size_t frame_count = 0;
+
+  // The upvalues still pointing into the stack, highest slot first.
+  Obj_Upvalue* open_upvalues = nullptr;
+
+  // The values of the globals, indexed by slot; undefined until the variable
+  // is defined.
+  Dynamic_Array<Value> globals;
+
+  // The name of every global slot, for error messages.
+  Dynamic_Array<Obj_String*> global_names;
+
+  Hash_Table<Obj_String*, uint32_t> global_slots;
+
+  Hash_Table<Interned_Text, Obj_String*> strings;
+
+  Obj_String* init_string = nullptr;
+
+  // Every object, most recently allocated first.
+  Obj* objects = nullptr;
+
+  std::size_t bytes_allocated = 0;
+  std::size_t next_collection = FIRST_COLLECTION;
+
+  // Whether collection is held off, e.g. while compiling, when the compiled
+  // functions aren't reachable from any root.
+  bool collection_paused = false;
+  bool stress_collection = false;
+
+  // Reachable objects whose references haven't been traced yet.
+  Dynamic_Array<Obj*> gray_stack;
+
+  // Compiles source into the top-level function; nullptr if it has errors.
+  Obj_Function* compile(const Source_File& source, Error_Reporter& e);
+  Obj_Function* compile(const Source_File& source,
+                        std::span<const Token> tokens,
+                        const Literal_Table& literals,
+                        const Symbol_Table& symbols, Error_Reporter& e);
+
+  // Compiles what parser parses from source.
+  Obj_Function* compile(const Source_File& source, Parser& parser,
+                        Error_Reporter& e);
+
+  // Runs the compiled top-level function.
+  Interpret_Result execute(Obj_Function* function, Error_Reporter& e);
+
+  Interpret_Result run();
+
+  void push(Value value);
+  Value pop();
+  Value peek(std::size_t distance) const;
+
+  void reset_stack();
+
+  // Reports a runtime error with a trace of the active calls and unwinds the
+  // stack.
+  void runtime_error(const std::string& message);
+
+  // Writes out the buffered output.
+  void flush_output();
+
+  bool call_value(Value callee, int arg_count);
+  bool call(Obj_Closure* closure, int arg_count);
+  bool invoke(Obj_String* name, int arg_count);
+  bool invoke_from_class(Obj_Class* klass, Obj_String* name, int arg_count);
+
+  // Replaces the instance on top of the stack with its method name bound to
+  // it.
+  bool bind_method(Obj_Class* klass, Obj_String* name);
+
+  Obj_Upvalue* capture_upvalue(Value* local);
+
+  // Closes the open upvalues pointing at last or above it.
+  void close_upvalues(Value* last);
+
+  void define_method(Obj_String* name);
+
+  // Replaces the two strings on top of the stack with their concatenation.
+  void concatenate();
+
+  void define_native(std::string_view name, Native_Function function);
+
+  /***********************************************************************
+  ALLOCATION AND COLLECTION
+  ***********************************************************************/
+  // Allocates a T, with extra bytes after it, and puts it on the list of
+  // objects. May collect garbage first.
+  template <typename T>
+  T* allocate_object(std::size_t extra = 0);
+
+  // Creates a string object with text, which must not be interned yet.
+  Obj_String* new_string(std::string_view text, uint64_t hash);
+
+  Obj_Closure* new_closure(Obj_Function* function);
+  Obj_Upvalue* new_upvalue(Value* slot);
+  Obj_Class* new_class(Obj_String* name);
+  Obj_Instance* new_instance(Obj_Class* klass);
+  Obj_Bound_Method* new_bound_method(Value receiver, Obj_Closure* method);
+
+  // Returns the number of bytes object was allocated with.
+  static std::size_t object_size(const Obj* object);
+
+  void free_object(Obj* object);
+
+  void collect_garbage();
+  void mark_roots();
+  void mark_value(Value value);
+  void mark_object(Obj* object);
+  void trace_references();
+  void blacken_object(Obj* object);
+
+  // Frees every unmarked object and unmarks the rest.
+  void sweep();
+};
+
+template <typename T>
+T* VM::allocate_object(std::size_t extra) {
+  std::size_t size = sizeof(T) + extra;
+
+  if (!this->collection_paused &&
+      (this->stress_collection ||
+       (this->bytes_allocated + size > this->next_collection))) {
+    collect_garbage();
+  }
+
+  T* object = new (::operator new(size)) T();
+  object->type = T::TYPE;
+  object->next = this->objects;
+  this->objects = object;
+  this->bytes_allocated += size;
+  return object;
+}
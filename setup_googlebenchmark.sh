@@ -0,0 +1,7 @@
+
+git clone --depth=1 -b main -q https://github.com/google/benchmark.git ./benchmark
+mkdir -p ./benchmark/build
+cd ./benchmark/build
+sudo cmake .. -DCMAKE_BUILD_TYPE=Release -DBENCHMARK_ENABLE_TESTING=OFF && sudo make && sudo make install
+cd ../../
+sudo rm -rf benchmark
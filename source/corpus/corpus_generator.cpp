@@ -0,0 +1,422 @@
+#include "corpus/corpus_generator.hpp"
+
+#include <errno.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <system_error>
+
+namespace {
+
+// Words names and strings are made of. Some start with a keyword, so that
+// keyword classification sees near misses.
+constexpr std::string_view WORDS[] = {
+    "count",   "total",  "index",   "node",     "value",   "left",
+    "right",   "buffer", "result",  "item",     "next",    "size",
+    "format",  "orbit",  "classic", "fund",     "ifdef",   "whiled",
+    "printer", "nilly",  "forward", "android",  "truthy",  "superb",
+    "thistle", "varied", "returns", "elsewise", "falsely", "ornate"};
+
+constexpr std::string_view BINARY_OPERATORS[] = {
+    " + ",  " - ",  " * ", " / ",  " == ", " != ",
+    " < ",  " <= ", " > ", " >= ", " and ", " or "};
+
+// The one-character tokens that can't combine with their neighbours: "!", "=",
+// "<", ">" and "/" can start two-character tokens.
+constexpr char ONE_CHAR_TOKENS[] = "(){},.-+;*";
+
+constexpr std::size_t WRITE_BLOCK_SIZE = 1 << 20;
+
+uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+void write_all(int fd, const char* bytes, std::size_t count) {
+  while (count > 0) {
+    ssize_t written = ::write(fd, bytes, count);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(),
+                              "Could not write corpus");
+    }
+    bytes += written;
+    count -= written;
+  }
+}
+
+}  // namespace
+
+Corpus_Generator::Corpus_Generator(uint64_t seed)
+    : Corpus_Generator(seed, Mix()) {}
+
+Corpus_Generator::Corpus_Generator(uint64_t seed, const Mix& mix) {
+  this->mix = mix;
+  this->statement_weight = mix.declarations + mix.prints + mix.expressions +
+                           mix.control_flow + mix.functions + mix.comments;
+  this->operand_weight = mix.identifiers + mix.numbers + mix.strings +
+                         mix.multi_line_strings + mix.literals;
+
+  if ((this->statement_weight == 0) || (this->operand_weight == 0) ||
+      (mix.max_operands == 0)) {
+    throw std::invalid_argument(
+        "A corpus mix needs some statements and some operands.");
+  }
+
+  // The state is seeded with splitmix64, as recommended for xoshiro.
+  for (uint64_t& word : this->state) {
+    seed += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = seed;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    word = z ^ (z >> 31);
+  }
+}
+
+void Corpus_Generator::generate(std::string& out, std::size_t bytes) {
+  std::size_t start = out.size();
+  while (out.size() - start < bytes) {
+    statement(out, 0, false);
+  }
+}
+
+void Corpus_Generator::write(int fd, std::size_t bytes) {
+  std::string block;
+  block.reserve(WRITE_BLOCK_SIZE + (WRITE_BLOCK_SIZE / 4));
+
+  // Each block overshoots by its last statement, which is counted against the
+  // next, so the corpus is the same as if it were generated in one go.
+  std::size_t written = 0;
+  while (written < bytes) {
+    block.clear();
+    generate(block, std::min(WRITE_BLOCK_SIZE, bytes - written));
+    write_all(fd, block.data(), block.size());
+    written += block.size();
+  }
+}
+
+std::string Corpus_Generator::long_string(std::size_t bytes) {
+  std::string out = "var long_string = \"";
+  out.reserve(out.size() + bytes + 3);
+  for (std::size_t i = 0; i < bytes; i++) {
+    out += static_cast<char>('a' + (i % 26));
+  }
+  out += "\";\n";
+  return out;
+}
+
+std::string Corpus_Generator::one_char_tokens(std::size_t count) {
+  std::string out;
+  out.reserve(count + (count / 64) + 1);
+  for (std::size_t i = 0; i < count; i++) {
+    out += ONE_CHAR_TOKENS[i % (sizeof(ONE_CHAR_TOKENS) - 1)];
+    if ((i % 64) == 63) {
+      out += '\n';
+    }
+  }
+  return out;
+}
+
+std::string Corpus_Generator::deep_nesting(std::size_t depth) {
+  std::string out;
+  out.reserve(4 * depth + 16);
+  out.append(depth, '{');
+  out += "print ";
+  out.append(depth, '(');
+  out += '1';
+  out.append(depth, ')');
+  out += ';';
+  out.append(depth, '}');
+  out += '\n';
+  return out;
+}
+
+uint64_t Corpus_Generator::next() {
+  // xoshiro256**
+  uint64_t result = rotl(this->state[1] * 5, 7) * 9;
+  uint64_t t = this->state[1] << 17;
+
+  this->state[2] ^= this->state[0];
+  this->state[3] ^= this->state[1];
+  this->state[1] ^= this->state[2];
+  this->state[0] ^= this->state[3];
+
+  this->state[2] ^= t;
+  this->state[3] = rotl(this->state[3], 45);
+
+  return result;
+}
+
+uint32_t Corpus_Generator::below(uint32_t bound) {
+  // Lemire's multiply-shift; the bias is negligible for the small bounds used
+  // here.
+  return static_cast<uint32_t>(((next() >> 32) * bound) >> 32);
+}
+
+template <std::size_t N>
+void Corpus_Generator::pick(std::string& out,
+                            const std::string_view (&choices)[N]) {
+  out += choices[below(N)];
+}
+
+void Corpus_Generator::statement(std::string& out, uint32_t depth,
+                                 bool in_function) {
+  // Statements with bodies are left out once the nesting is deep enough.
+  bool can_nest = depth < this->mix.max_depth;
+  uint32_t weight = this->statement_weight;
+  if (!can_nest) {
+    weight -= this->mix.control_flow + this->mix.functions;
+  }
+
+  // A mix of only nesting statements falls back to declarations there.
+  uint32_t choice = (weight == 0) ? 0 : below(weight);
+  indent(out, depth);
+
+  if ((weight == 0) || (choice < this->mix.declarations)) {
+    out += "var ";
+    pick(out, WORDS);
+    out += '_';
+    out += std::to_string(this->names++);
+    out += " = ";
+    expression(out, depth);
+    out += ";\n";
+    return;
+  }
+  choice -= this->mix.declarations;
+
+  if (choice < this->mix.prints) {
+    out += "print ";
+    expression(out, depth);
+    out += ";\n";
+    return;
+  }
+  choice -= this->mix.prints;
+
+  if (choice < this->mix.expressions) {
+    identifier(out);
+    switch (below(3)) {
+      case 0:
+        out += " = ";
+        expression(out, depth);
+        break;
+      case 1:
+        out += '.';
+        pick(out, WORDS);
+        [[fallthrough]];
+      default:
+        out += '(';
+        for (uint32_t i = below(4); i > 0; i--) {
+          expression(out, depth);
+          if (i > 1) {
+            out += ", ";
+          }
+        }
+        out += ')';
+        break;
+    }
+    out += ";\n";
+    return;
+  }
+  choice -= this->mix.expressions;
+
+  if (choice < this->mix.comments) {
+    comment(out);
+    return;
+  }
+  choice -= this->mix.comments;
+
+  if (choice < this->mix.control_flow) {
+    switch (below(3)) {
+      case 0:
+        out += "if (";
+        expression(out, depth);
+        out += ") ";
+        block(out, depth, in_function);
+        if (below(2) == 0) {
+          indent(out, depth);
+          out += "else ";
+          block(out, depth, in_function);
+        }
+        break;
+      case 1:
+        out += "while (";
+        expression(out, depth);
+        out += ") ";
+        block(out, depth, in_function);
+        break;
+      default: {
+        std::string counter = "i_" + std::to_string(this->names++);
+        out += "for (var " + counter + " = 0; " + counter + " < ";
+        number(out);
+        out += "; " + counter + " = " + counter + " + 1) ";
+        block(out, depth, in_function);
+        break;
+      }
+    }
+    return;
+  }
+
+  if (below(3) != 0) {
+    out += "fun ";
+    pick(out, WORDS);
+    out += '_';
+    out += std::to_string(this->names++);
+    out += '(';
+    for (uint32_t i = below(4); i > 0; i--) {
+      pick(out, WORDS);
+      out += '_';
+      out += std::to_string(i);
+      if (i > 1) {
+        out += ", ";
+      }
+    }
+    out += ") ";
+    block(out, depth, true);
+    return;
+  }
+
+  out += "class Class_";
+  out += std::to_string(this->classes);
+  if ((this->classes > 0) && (below(2) == 0)) {
+    out += " < Class_";
+    out += std::to_string(below(this->classes));
+  }
+  this->classes++;
+  out += " {\n";
+  for (uint32_t i = 1 + below(3); i > 0; i--) {
+    indent(out, depth + 1);
+    pick(out, WORDS);
+    out += "() ";
+    block(out, depth + 1, true);
+  }
+  indent(out, depth);
+  out += "}\n";
+}
+
+void Corpus_Generator::block(std::string& out, uint32_t depth,
+                             bool in_function) {
+  out += "{\n";
+  for (uint32_t i = 1 + below(4); i > 0; i--) {
+    statement(out, depth + 1, in_function);
+  }
+  if (in_function && below(2) == 0) {
+    indent(out, depth + 1);
+    out += "return ";
+    expression(out, depth + 1);
+    out += ";\n";
+  }
+  indent(out, depth);
+  out += "}\n";
+}
+
+void Corpus_Generator::expression(std::string& out, uint32_t depth) {
+  for (uint32_t i = 1 + below(this->mix.max_operands); i > 0; i--) {
+    operand(out, depth);
+    if (i > 1) {
+      pick(out, BINARY_OPERATORS);
+    }
+  }
+}
+
+void Corpus_Generator::operand(std::string& out, uint32_t depth) {
+  switch (below(16)) {
+    case 0:
+      out += '-';
+      break;
+    case 1:
+      out += '!';
+      break;
+    case 2:
+      if (depth < this->mix.max_depth) {
+        out += '(';
+        expression(out, depth + 1);
+        out += ')';
+        return;
+      }
+      break;
+  }
+
+  uint32_t choice = below(this->operand_weight);
+  if (choice < this->mix.identifiers) {
+    identifier(out);
+    return;
+  }
+  choice -= this->mix.identifiers;
+
+  if (choice < this->mix.numbers) {
+    number(out);
+    return;
+  }
+  choice -= this->mix.numbers;
+
+  if (choice < this->mix.strings) {
+    string_literal(out, false);
+    return;
+  }
+  choice -= this->mix.strings;
+
+  if (choice < this->mix.multi_line_strings) {
+    string_literal(out, true);
+    return;
+  }
+
+  constexpr std::string_view LITERALS[] = {"true", "false", "nil"};
+  pick(out, LITERALS);
+}
+
+void Corpus_Generator::identifier(std::string& out) {
+  pick(out, WORDS);
+  if (below(2) == 0) {
+    out += '_';
+    out += std::to_string(below(100));
+  }
+}
+
+void Corpus_Generator::number(std::string& out) {
+  switch (below(4)) {
+    case 0:
+      out += static_cast<char>('0' + below(10));
+      break;
+    case 1:
+      out += std::to_string(below(100000));
+      break;
+    case 2:
+      out += std::to_string(below(1000));
+      out += '.';
+      out += std::to_string(below(1000000));
+      break;
+    default:
+      out += std::to_string(next() % 1000000000000000ULL);
+      break;
+  }
+}
+
+void Corpus_Generator::string_literal(std::string& out, bool multi_line) {
+  out += '"';
+  uint32_t lines = multi_line ? 2 + below(4) : 1;
+  for (uint32_t line = 0; line < lines; line++) {
+    if (line > 0) {
+      out += '\n';
+    }
+    for (uint32_t i = 1 + below(8); i > 0; i--) {
+      pick(out, WORDS);
+      if (i > 1) {
+        out += ' ';
+      }
+    }
+  }
+  out += '"';
+}
+
+void Corpus_Generator::comment(std::string& out) {
+  out += "//";
+  for (uint32_t i = 1 + below(12); i > 0; i--) {
+    out += ' ';
+    pick(out, WORDS);
+  }
+  out += '\n';
+}
+
+void Corpus_Generator::indent(std::string& out, uint32_t depth) {
+  out.append(2 * depth, ' ');
+}
@@ -3,6 +3,46 @@
 #include <iostream>
 
 void Error_Reporter::error(const uint64_t line, const std::string& message) {
-  std::cerr << "[line " << line << "] Error: " << message << std::endl;
+  error(line, "", message);
+}
+
+void Error_Reporter::error(const uint64_t line, const std::string& where,
+                           const std::string& message) {
+  this->had_error = true;
+
+  if (this->hold_errors) {
+    this->held += "[line " + std::to_string(line) + "] Error" + where + ": " +
+                  message + "\n";
+    return;
+  }
+
+  std::cerr << "[line " << line << "] Error" << where << ": " << message
+            << std::endl;
+}
+
+void Error_Reporter::runtime_error(const std::string& message,
+                                   const std::string& trace) {
+  this->had_runtime_error = true;
+
+  if (this->hold_errors) {
+    this->held += message + "\n" + trace;
+    return;
+  }
+
+  std::cerr << message << "\n" << trace << std::flush;
+}
+
+void Error_Reporter::report_held(const Error_Reporter& src) {
+  if (!src.had_error) {
+    return;
+  }
+
   this->had_error = true;
+
+  if (this->hold_errors) {
+    this->held += src.held;
+    return;
+  }
+
+  std::cerr << src.held << std::flush;
 }
@@ -1,5 +1,6 @@
 #include <cstdlib>
 #include <iostream>
+#include <string_view>
 
 #include "data_structures/hash_table.hpp"
 #include "error_reporter/error_reporter.hpp"
@@ -13,15 +14,46 @@
 
 int main(int argc, char** argv) {
   Error_Reporter e;
+  Run_Options options;
 
-  if (argc > 2) {
-    std::cout << "Usage: jlox_in_cpp [filename]" << std::endl;
+  // Options come before the file name.
+  int first_argument = 1;
+  while ((first_argument < argc) &&
+         (std::string_view(argv[first_argument]).starts_with("--"))) {
+    std::string_view option(argv[first_argument]);
+    if (option == "--dump-tokens") {
+      options.dump_tokens = true;
+    } else if (option == "--binary-tokens") {
+      options.dump_tokens = true;
+      options.token_format = Token_Dump::Format::BINARY;
+    } else if (option == "--dump-ast") {
+      options.dump_ast = true;
+    } else if (option == "--disassemble") {
+      options.disassemble = true;
+    } else if (option == "--token-cache") {
+      options.token_cache = true;
+    } else if (option.starts_with("--token-cache=")) {
+      options.token_cache = true;
+      options.token_cache_directory = option.substr(14);
+    } else {
+      std::cout << "Unknown option " << option << std::endl;
+      return 64;
+    }
+    first_argument++;
+  }
+
+  int arguments = argc - first_argument;
+  if (arguments > 1) {
+    std::cout << "Usage: jlox_in_cpp [--dump-tokens] [--binary-tokens] "
+                 "[--token-cache[=directory]] [--dump-ast] [--disassemble] "
+                 "[filename]"
+              << std::endl;
     return 64;
-  } else if (argc == 2) {
-    uint64_t ret_code = run_file(argv[1], e);
+  } else if (arguments == 1) {
+    uint64_t ret_code = run_file(argv[first_argument], e, options);
     return ret_code;
   } else {
-    run_prompt(e);
+    run_prompt(e, options);
   }
 
   return 0;
@@ -1,31 +1,143 @@
 #include "main_functions.hpp"
 
-#include <fstream>
+#include <unistd.h>
+
 #include <iostream>
-#include <sstream>
+#include <span>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
 
-#include "data_structures/dynamic_array.hpp"
+#include "memory/arena.hpp"
+#include "parser/ast_printer.hpp"
+#include "parser/parser.hpp"
 #include "scanner/scanner.hpp"
 #include "token/token.hpp"
+#include "token/token_cache.hpp"
+#include "vm/vm.hpp"
+
+// Scans all the tokens of source with s and writes them to the cache file at
+// path.
+static Token_Array& scan_and_store(const std::string& path,
+                                   const Source_File& source, Scanner& s,
+                                   Error_Reporter& e) {
+  Token_Array& tokens = s.scan_tokens();
+
+  // Tokens with errors aren't cached, so the errors are reported every run.
+  if (!e.had_error) {
+    try {
+      Token_Cache::store(path, source, tokens, s.get_literals(),
+                         s.get_symbols());
+    } catch (const std::system_error& error) {
+      // The cache is only an optimization; the tokens are used anyway.
+      std::cerr << "Could not write token cache " << error.what()
+                << std::endl;
+    }
+  }
+
+  return tokens;
+}
+
+// Prints the tokens of source from its token cache if the cache is up to date,
+// or scans them and refreshes the cache otherwise.
+static void dump_cached(const Source_File& source, Error_Reporter& e,
+                        const Run_Options& options, Token_Dump& dump) {
+  std::string path =
+      Token_Cache::path_for(source, options.token_cache_directory);
+
+  Token_Cache cache;
+  if (cache.load(path, source)) {
+    for (const Token& token : cache) {
+      dump.write(token, source.get_contents(), cache.get_literals());
+    }
+    return;
+  }
+
+  Scanner s(source, e);
+  for (const Token& token : scan_and_store(path, source, s, e)) {
+    dump.write(token, source.get_contents(), s.get_literals());
+  }
+}
 
-uint64_t run_file(const std::string& file_path, Error_Reporter& e) {
-  // Get file contents as a string.
-  std::ifstream file(file_path);
-  std::ostringstream oss;
-  oss << file.rdbuf();
-  file.close();
+// Runs source on vm from its token cache if the cache is up to date, so that
+// it isn't scanned again, or scans it, refreshes the cache and runs the
+// scanned tokens otherwise.
+static void interpret_cached(const Source_File& source, Error_Reporter& e,
+                             VM& vm, const Run_Options& options) {
+  std::string path =
+      Token_Cache::path_for(source, options.token_cache_directory);
 
-  // Execute the code in the file.
-  run(oss.str(), e);
+  Token_Cache cache;
+  if (cache.load(path, source)) {
+    vm.interpret(source, std::span<const Token>(cache.begin(), cache.end()),
+                 cache.get_literals(), cache.get_symbols(), e);
+    return;
+  }
+
+  Scanner s(source, e);
+  Token_Array& tokens = scan_and_store(path, source, s, e);
+
+  // Scan errors are already reported and, like any compile error, keep the
+  // program from running.
+  if (e.had_error) {
+    return;
+  }
+
+  vm.interpret(source, std::span<const Token>(tokens.begin(), tokens.end()),
+               s.get_literals(), s.get_symbols(), e);
+}
+
+// Parses source and prints its syntax tree. The tree and everything else the
+// parse allocates lives in one arena, freed when the dump is done.
+static void dump_ast(const Source_File& source, Error_Reporter& e) {
+  Arena arena;
+  Monotonic_Resource resource(arena);
+
+  Parser parser(source, e, &resource);
+  Ast& ast = parser.parse();
+
+  // The statements with syntax errors were left out of the tree, so it isn't
+  // printed; only the errors are.
+  if (e.had_error) {
+    return;
+  }
+
+  std::string out;
+  Ast_Printer(ast, parser.get_literals(), parser.get_symbols())
+      .print(ast.get_root(), out);
+  std::cout << out << std::flush;
+}
+
+uint64_t run_file(const std::string& file_path, Error_Reporter& e,
+                  const Run_Options& options) {
+  try {
+    // Execute the code in the file. The file is mapped rather than copied and
+    // the scanner reads the mapping.
+    VM vm;
+    run(Source_File::open(file_path), e, vm, options);
+  } catch (const std::system_error& error) {
+    std::cerr << "Could not read " << error.what() << std::endl;
+    return 66;
+  } catch (const std::length_error& error) {
+    std::cerr << file_path << ": " << error.what() << std::endl;
+    return 65;
+  }
 
   if (e.had_error) {
     return 65;
   }
 
+  if (e.had_runtime_error) {
+    return 70;
+  }
+
   return 0;
 }
 
-void run_prompt(Error_Reporter& e) {
+void run_prompt(Error_Reporter& e, const Run_Options& options) {
+  // Every line runs on the same VM, so later lines see earlier lines' globals.
+  VM vm;
+
   while (true) {
     std::string line;
 
@@ -36,17 +148,57 @@ void run_prompt(Error_Reporter& e) {
       break;
     }
 
-    run(line, e);
+    run(Source_File(std::move(line)), e, vm, options);
 
     e.had_error = false;
+    e.had_runtime_error = false;
   }
 }
 
-void run(const std::string& source, Error_Reporter& e) {
-  Scanner s(source, e);
-  Dynamic_Array<Token> tokens = s.scan_tokens();
+void run(const Source_File& source, Error_Reporter& e, VM& vm,
+         const Run_Options& options) {
+  if (options.dump_ast) {
+    dump_ast(source, e);
+    return;
+  }
+
+  if (options.disassemble) {
+    std::string out;
+    vm.disassemble(source, e, out);
+    std::cout << out << std::flush;
+    return;
+  }
+
+  if (!options.dump_tokens) {
+    if (options.token_cache && !source.get_name().empty()) {
+      interpret_cached(source, e, vm, options);
+    } else {
+      vm.interpret(source, e);
+    }
+    return;
+  }
+
+  // The dump writes to the file descriptor directly, after anything already
+  // buffered by std::cout.
+  std::cout << std::flush;
+
+  Token_Dump dump(STDOUT_FILENO, options.token_format);
+
+  try {
+    if (options.token_cache && !source.get_name().empty()) {
+      dump_cached(source, e, options, dump);
+    } else {
+      // Tokens are printed as they are scanned rather than collected first,
+      // and written out in large blocks.
+      Scanner s(source, e);
+      for (const Token& token : s) {
+        dump.write(token, source.get_contents(), s.get_literals());
+      }
+    }
 
-  for (Token token : tokens) {
-    std::cout << token.to_string() << std::endl;
+    dump.flush();
+  } catch (const std::system_error& error) {
+    std::cerr << error.what() << std::endl;
+    e.had_error = true;
   }
 }
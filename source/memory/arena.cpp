@@ -0,0 +1,124 @@
+#include "memory/arena.hpp"
+
+#include <algorithm>
+
+Arena::Arena(std::size_t first_block_size) {
+  this->current = nullptr;
+  this->position = nullptr;
+  this->limit = nullptr;
+  this->next_block_size = std::max<std::size_t>(first_block_size, 64);
+  this->bytes_used = 0;
+  this->bytes_reserved = 0;
+  this->finalizers = nullptr;
+}
+
+Arena::~Arena() {
+  run_finalizers();
+  free_blocks(this->current);
+}
+
+void Arena::reset() {
+  run_finalizers();
+
+  // Keep the largest block, which is the newest unless an oversized
+  // allocation was put behind it.
+  block* largest = this->current;
+  for (block* b = this->current; b != nullptr; b = b->previous) {
+    if (b->size > largest->size) {
+      largest = b;
+    }
+  }
+
+  for (block* b = this->current; b != nullptr;) {
+    block* previous = b->previous;
+    if (b != largest) {
+      ::operator delete(b);
+    }
+    b = previous;
+  }
+
+  this->current = largest;
+  this->bytes_used = 0;
+  this->bytes_reserved = 0;
+  if (largest != nullptr) {
+    largest->previous = nullptr;
+    this->position = (char*)(largest + 1);
+    this->limit = this->position + largest->size;
+    this->bytes_reserved = largest->size;
+  }
+}
+
+std::size_t Arena::get_bytes_used() const { return this->bytes_used; }
+
+std::size_t Arena::get_bytes_reserved() const { return this->bytes_reserved; }
+
+void* Arena::allocate_slow(std::size_t bytes, std::size_t alignment) {
+  // Enough room for the bytes wherever the alignment puts them in the block.
+  std::size_t needed = bytes + alignment;
+  if (needed < bytes) {
+    throw std::bad_alloc();
+  }
+
+  // An allocation larger than a whole block gets a block of its own, put
+  // behind the current one so that the current one's free space isn't lost.
+  if ((needed > this->next_block_size) && (this->current != nullptr)) {
+    block* own = static_cast<block*>(::operator new(sizeof(block) + needed));
+    own->size = needed;
+    own->previous = this->current->previous;
+    this->current->previous = own;
+    this->bytes_reserved += needed;
+
+    char* aligned = (char*)(((uintptr_t)(own + 1) + (alignment - 1)) &
+                            ~(uintptr_t)(alignment - 1));
+    this->bytes_used += bytes;
+    return aligned;
+  }
+
+  std::size_t size = std::max(this->next_block_size, needed);
+  block* b = static_cast<block*>(::operator new(sizeof(block) + size));
+  b->size = size;
+  b->previous = this->current;
+  this->current = b;
+  this->position = (char*)(b + 1);
+  this->limit = this->position + size;
+  this->bytes_reserved += size;
+  this->next_block_size = std::min(this->next_block_size * 2, MAX_BLOCK_SIZE);
+
+  return allocate(bytes, alignment);
+}
+
+void Arena::run_finalizers() {
+  while (this->finalizers != nullptr) {
+    finalizer* f = this->finalizers;
+    this->finalizers = f->previous;
+    f->destroy(f->object);
+  }
+}
+
+void Arena::free_blocks(block* first) {
+  while (first != nullptr) {
+    block* previous = first->previous;
+    ::operator delete(first);
+    first = previous;
+  }
+}
+
+Monotonic_Resource::Monotonic_Resource(Arena& arena) : arena(arena) {}
+
+Arena& Monotonic_Resource::get_arena() const { return this->arena; }
+
+void* Monotonic_Resource::do_allocate(std::size_t bytes,
+                                      std::size_t alignment) {
+  return this->arena.allocate(bytes, alignment);
+}
+
+void Monotonic_Resource::do_deallocate(void*, std::size_t, std::size_t) {}
+
+bool Monotonic_Resource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  // Resources on the same arena can free each other's memory, which is to
+  // say neither frees any.
+  const Monotonic_Resource* resource =
+      dynamic_cast<const Monotonic_Resource*>(&other);
+  return (resource != nullptr) && (&resource->arena == &this->arena);
+}
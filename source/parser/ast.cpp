@@ -0,0 +1,52 @@
+#include "parser/ast.hpp"
+
+#include <stdexcept>
+
+Ast::Ast(std::pmr::memory_resource* resource)
+    : nodes(resource), lists(resource) {
+  this->root = NO_NODE;
+}
+
+Node_Id Ast::add(Node_Kind kind, uint32_t offset, uint32_t a, uint32_t b,
+                 uint32_t c, Token_Type op) {
+  if ((std::size_t)(this->nodes.get_maximum_index() + 1) >= NO_NODE) {
+    throw std::length_error("Too many syntax tree nodes.");
+  }
+
+  Node_Id node = (Node_Id)(this->nodes.get_maximum_index() + 1);
+  this->nodes.push_back(Ast_Node{kind, op, offset, a, b, c});
+  return node;
+}
+
+uint32_t Ast::add_list(const uint32_t* items, std::size_t count) {
+  uint32_t list = (uint32_t)(this->lists.get_maximum_index() + 1);
+
+  // The count and the items are appended in one go.
+  uint32_t* stored = this->lists.append_for_overwrite(count + 1);
+  stored[0] = (uint32_t)count;
+  for (std::size_t i = 0; i < count; i++) {
+    stored[i + 1] = items[i];
+  }
+  return list;
+}
+
+const Ast_Node& Ast::get(Node_Id node) const { return this->nodes[node]; }
+
+std::span<const uint32_t> Ast::get_list(uint32_t list) const {
+  const uint32_t* count = &this->lists[list];
+  return std::span<const uint32_t>(count + 1, *count);
+}
+
+Node_Id Ast::get_root() const { return this->root; }
+
+void Ast::set_root(Node_Id node) { this->root = node; }
+
+std::size_t Ast::get_size() const {
+  return this->nodes.get_maximum_index() + 1;
+}
+
+void Ast::clear() {
+  this->nodes = lox_pmr::Dynamic_Array<Ast_Node>(this->nodes.get_allocator());
+  this->lists = lox_pmr::Dynamic_Array<uint32_t>(this->lists.get_allocator());
+  this->root = NO_NODE;
+}
@@ -0,0 +1,218 @@
+#include "parser/ast_printer.hpp"
+
+#include <charconv>
+#include <string_view>
+
+// Returns how the operator of a unary, binary or logical expression is spelled.
+static std::string_view operator_spelling(Token_Type op) {
+  switch (op) {
+    case Token_Type::TT_MINUS:
+      return "-";
+    case Token_Type::TT_PLUS:
+      return "+";
+    case Token_Type::TT_SLASH:
+      return "/";
+    case Token_Type::TT_STAR:
+      return "*";
+    case Token_Type::TT_BANG:
+      return "!";
+    case Token_Type::TT_BANG_EQUAL:
+      return "!=";
+    case Token_Type::TT_EQUAL_EQUAL:
+      return "==";
+    case Token_Type::TT_GREATER:
+      return ">";
+    case Token_Type::TT_GREATER_EQUAL:
+      return ">=";
+    case Token_Type::TT_LESS:
+      return "<";
+    case Token_Type::TT_LESS_EQUAL:
+      return "<=";
+    case Token_Type::TT_AND:
+      return "and";
+    case Token_Type::TT_OR:
+      return "or";
+    default:
+      return "?";
+  }
+}
+
+Ast_Printer::Ast_Printer(const Ast& ast, const Literal_Table& literals,
+                         const Symbol_Table& symbols)
+    : ast(ast), literals(literals), symbols(symbols) {}
+
+std::string Ast_Printer::print(Node_Id node) const {
+  std::string out;
+  print(node, out);
+  return out;
+}
+
+void Ast_Printer::print(Node_Id node, std::string& out) const {
+  const Ast_Node& n = this->ast.get(node);
+
+  switch (n.kind) {
+    case Node_Kind::NK_NUMBER: {
+      char digits[32];
+      auto result = std::to_chars(digits, digits + sizeof(digits),
+                                  this->literals.get_number(n.a));
+      out.append(digits, result.ptr);
+      return;
+    }
+    case Node_Kind::NK_STRING:
+      out += '"';
+      out += this->symbols.get_string(n.a);
+      out += '"';
+      return;
+    case Node_Kind::NK_TRUE:
+      out += "true";
+      return;
+    case Node_Kind::NK_FALSE:
+      out += "false";
+      return;
+    case Node_Kind::NK_NIL:
+      out += "nil";
+      return;
+    case Node_Kind::NK_VARIABLE:
+      out += this->symbols.get_string(n.a);
+      return;
+    case Node_Kind::NK_THIS:
+      out += "this";
+      return;
+    case Node_Kind::NK_PROGRAM:
+      for (Node_Id statement : this->ast.get_list(n.a)) {
+        print(statement, out);
+        out += '\n';
+      }
+      return;
+    default:
+      break;
+  }
+
+  out += '(';
+  switch (n.kind) {
+    case Node_Kind::NK_ASSIGN:
+      out += "= ";
+      out += this->symbols.get_string(n.a);
+      out += ' ';
+      print(n.b, out);
+      break;
+    case Node_Kind::NK_UNARY:
+      out += operator_spelling(n.op);
+      out += ' ';
+      print(n.a, out);
+      break;
+    case Node_Kind::NK_BINARY:
+    case Node_Kind::NK_LOGICAL:
+      out += operator_spelling(n.op);
+      out += ' ';
+      print(n.a, out);
+      out += ' ';
+      print(n.b, out);
+      break;
+    case Node_Kind::NK_GROUPING:
+      out += "group ";
+      print(n.a, out);
+      break;
+    case Node_Kind::NK_CALL:
+      out += "call ";
+      print(n.a, out);
+      print_list(n.b, out);
+      break;
+    case Node_Kind::NK_GET:
+      out += "get ";
+      print(n.a, out);
+      out += ' ';
+      out += this->symbols.get_string(n.b);
+      break;
+    case Node_Kind::NK_SET:
+      out += "set ";
+      print(n.a, out);
+      out += ' ';
+      out += this->symbols.get_string(n.b);
+      out += ' ';
+      print(n.c, out);
+      break;
+    case Node_Kind::NK_SUPER:
+      out += "super ";
+      out += this->symbols.get_string(n.a);
+      break;
+    case Node_Kind::NK_EXPRESSION:
+      out += "; ";
+      print(n.a, out);
+      break;
+    case Node_Kind::NK_PRINT:
+      out += "print ";
+      print(n.a, out);
+      break;
+    case Node_Kind::NK_VAR:
+      out += "var ";
+      out += this->symbols.get_string(n.a);
+      if (n.b != Ast::NO_NODE) {
+        out += ' ';
+        print(n.b, out);
+      }
+      break;
+    case Node_Kind::NK_BLOCK:
+      out += "block";
+      print_list(n.a, out);
+      break;
+    case Node_Kind::NK_IF:
+      out += "if ";
+      print(n.a, out);
+      out += ' ';
+      print(n.b, out);
+      if (n.c != Ast::NO_NODE) {
+        out += ' ';
+        print(n.c, out);
+      }
+      break;
+    case Node_Kind::NK_WHILE:
+      out += "while ";
+      print(n.a, out);
+      out += ' ';
+      print(n.b, out);
+      break;
+    case Node_Kind::NK_FUNCTION: {
+      out += "fun ";
+      out += this->symbols.get_string(n.a);
+      out += " (";
+      bool first = true;
+      for (uint32_t parameter : this->ast.get_list(n.b)) {
+        if (!first) {
+          out += ' ';
+        }
+        out += this->symbols.get_string(parameter);
+        first = false;
+      }
+      out += ')';
+      print_list(n.c, out);
+      break;
+    }
+    case Node_Kind::NK_RETURN:
+      out += "return";
+      if (n.a != Ast::NO_NODE) {
+        out += ' ';
+        print(n.a, out);
+      }
+      break;
+    case Node_Kind::NK_CLASS:
+      out += "class ";
+      out += this->symbols.get_string(n.a);
+      if (n.b != Ast::NO_NODE) {
+        out += " < ";
+        print(n.b, out);
+      }
+      print_list(n.c, out);
+      break;
+    default:
+      break;
+  }
+  out += ')';
+}
+
+void Ast_Printer::print_list(uint32_t list, std::string& out) const {
+  for (Node_Id node : this->ast.get_list(list)) {
+    out += ' ';
+    print(node, out);
+  }
+}
@@ -0,0 +1,577 @@
+#include "parser/parser.hpp"
+
+#include <string>
+
+const std::array<Parser::Parse_Rule, (std::size_t)Token_Type::TT_EOF + 1>
+    Parser::RULES = [] {
+      std::array<Parse_Rule, (std::size_t)Token_Type::TT_EOF + 1> rules{};
+      auto rule = [&rules](Token_Type type, Prefix_Function prefix,
+                           Infix_Function infix, Precedence precedence) {
+        rules[(std::size_t)type] = Parse_Rule{prefix, infix, precedence};
+      };
+
+      rule(Token_Type::TT_LEFT_PAREN, &Parser::grouping, &Parser::call,
+           Precedence::CALL);
+      rule(Token_Type::TT_DOT, nullptr, &Parser::dot, Precedence::CALL);
+      rule(Token_Type::TT_MINUS, &Parser::unary, &Parser::binary,
+           Precedence::TERM);
+      rule(Token_Type::TT_PLUS, nullptr, &Parser::binary, Precedence::TERM);
+      rule(Token_Type::TT_SLASH, nullptr, &Parser::binary, Precedence::FACTOR);
+      rule(Token_Type::TT_STAR, nullptr, &Parser::binary, Precedence::FACTOR);
+      rule(Token_Type::TT_BANG, &Parser::unary, nullptr, Precedence::NONE);
+      rule(Token_Type::TT_BANG_EQUAL, nullptr, &Parser::binary,
+           Precedence::EQUALITY);
+      rule(Token_Type::TT_EQUAL_EQUAL, nullptr, &Parser::binary,
+           Precedence::EQUALITY);
+      rule(Token_Type::TT_GREATER, nullptr, &Parser::binary,
+           Precedence::COMPARISON);
+      rule(Token_Type::TT_GREATER_EQUAL, nullptr, &Parser::binary,
+           Precedence::COMPARISON);
+      rule(Token_Type::TT_LESS, nullptr, &Parser::binary,
+           Precedence::COMPARISON);
+      rule(Token_Type::TT_LESS_EQUAL, nullptr, &Parser::binary,
+           Precedence::COMPARISON);
+      rule(Token_Type::TT_IDENTIFIER, &Parser::variable, nullptr,
+           Precedence::NONE);
+      rule(Token_Type::TT_STRING, &Parser::string, nullptr, Precedence::NONE);
+      rule(Token_Type::TT_NUMBER, &Parser::number, nullptr, Precedence::NONE);
+      rule(Token_Type::TT_AND, nullptr, &Parser::logical, Precedence::AND);
+      rule(Token_Type::TT_OR, nullptr, &Parser::logical, Precedence::OR);
+      rule(Token_Type::TT_FALSE, &Parser::literal, nullptr, Precedence::NONE);
+      rule(Token_Type::TT_TRUE, &Parser::literal, nullptr, Precedence::NONE);
+      rule(Token_Type::TT_NIL, &Parser::literal, nullptr, Precedence::NONE);
+      rule(Token_Type::TT_THIS, &Parser::this_, nullptr, Precedence::NONE);
+      rule(Token_Type::TT_SUPER, &Parser::super_, nullptr, Precedence::NONE);
+      return rules;
+    }();
+
+Parser::Parser(const Source_File& source, Error_Reporter& e,
+               std::pmr::memory_resource* resource)
+    : source(source),
+      scanner(source, e, lox_byte_scan::best(), resource),
+      tokens(this->scanner),
+      error_reporting(e),
+      literals(this->scanner.get_literals()),
+      symbols(this->scanner.get_symbols()),
+      ast(resource),
+      scratch(resource) {
+  this->depth = 0;
+}
+
+Parser::Parser(const Source_File& source, std::span<const Token> tokens,
+               const Literal_Table& literals, const Symbol_Table& symbols,
+               Error_Reporter& e, std::pmr::memory_resource* resource)
+    : source(source),
+      scanner(source, e, lox_byte_scan::best(), resource),
+      tokens(tokens),
+      error_reporting(e),
+      literals(literals),
+      symbols(symbols),
+      ast(resource),
+      scratch(resource) {
+  this->depth = 0;
+}
+
+Ast& Parser::parse() {
+  int mark = this->scratch.get_maximum_index() + 1;
+  uint32_t offset = peek().get_offset();
+
+  while (!check(Token_Type::TT_EOF)) {
+    Node_Id node = declaration();
+    if (node != Ast::NO_NODE) {
+      this->scratch.push_back(node);
+    }
+  }
+
+  this->ast.set_root(
+      this->ast.add(Node_Kind::NK_PROGRAM, offset, finish_list(mark)));
+  return this->ast;
+}
+
+const Literal_Table& Parser::get_literals() const { return this->literals; }
+
+const Symbol_Table& Parser::get_symbols() const { return this->symbols; }
+
+/*******************************************************************************
+STATEMENTS
+*******************************************************************************/
+Node_Id Parser::declaration() {
+  // The scratch lists and the depth are unwound to here after an error.
+  int mark = this->scratch.get_maximum_index() + 1;
+  uint32_t depth = this->depth;
+
+  try {
+    if (match(Token_Type::TT_CLASS)) {
+      return class_declaration();
+    }
+    if (match(Token_Type::TT_FUN)) {
+      return function("function");
+    }
+    if (match(Token_Type::TT_VAR)) {
+      return var_declaration();
+    }
+    return statement();
+  } catch (const Parse_Error&) {
+    truncate_scratch(mark);
+    this->depth = depth;
+    synchronize();
+    return Ast::NO_NODE;
+  }
+}
+
+Node_Id Parser::class_declaration() {
+  Token name = consume(Token_Type::TT_IDENTIFIER, "Expect class name.");
+
+  Node_Id superclass = Ast::NO_NODE;
+  if (match(Token_Type::TT_LESS)) {
+    const Token& super_name =
+        consume(Token_Type::TT_IDENTIFIER, "Expect superclass name.");
+    superclass = this->ast.add(Node_Kind::NK_VARIABLE,
+                               super_name.get_offset(),
+                               super_name.get_literal());
+  }
+
+  consume(Token_Type::TT_LEFT_BRACE, "Expect '{' before class body.");
+  int mark = this->scratch.get_maximum_index() + 1;
+  while (!check(Token_Type::TT_RIGHT_BRACE) && !check(Token_Type::TT_EOF)) {
+    this->scratch.push_back(function("method"));
+  }
+  consume(Token_Type::TT_RIGHT_BRACE, "Expect '}' after class body.");
+
+  return this->ast.add(Node_Kind::NK_CLASS, name.get_offset(),
+                       name.get_literal(), superclass, finish_list(mark));
+}
+
+Node_Id Parser::function(const char* kind) {
+  enter();
+
+  // The messages name the kind, so they are only built when reported.
+  auto expect = [&](Token_Type type, const char* before,
+                    const char* after) -> const Token& {
+    if (!check(type)) {
+      error(peek(), std::string(before) + kind + after);
+      throw Parse_Error();
+    }
+    return advance();
+  };
+
+  Token name = expect(Token_Type::TT_IDENTIFIER, "Expect ", " name.");
+  expect(Token_Type::TT_LEFT_PAREN, "Expect '(' after ", " name.");
+
+  int mark = this->scratch.get_maximum_index() + 1;
+  if (!check(Token_Type::TT_RIGHT_PAREN)) {
+    do {
+      if ((std::size_t)(this->scratch.get_maximum_index() + 1 - mark) >=
+          MAX_ARGUMENTS) {
+        error(peek(), "Can't have more than 255 parameters.");
+      }
+      this->scratch.push_back(
+          consume(Token_Type::TT_IDENTIFIER, "Expect parameter name.")
+              .get_literal());
+    } while (match(Token_Type::TT_COMMA));
+  }
+  consume(Token_Type::TT_RIGHT_PAREN, "Expect ')' after parameters.");
+  uint32_t parameters = finish_list(mark);
+
+  expect(Token_Type::TT_LEFT_BRACE, "Expect '{' before ", " body.");
+  uint32_t body = block();
+
+  this->depth--;
+  return this->ast.add(Node_Kind::NK_FUNCTION, name.get_offset(),
+                       name.get_literal(), parameters, body);
+}
+
+Node_Id Parser::var_declaration() {
+  Token name = consume(Token_Type::TT_IDENTIFIER, "Expect variable name.");
+
+  Node_Id initializer = Ast::NO_NODE;
+  if (match(Token_Type::TT_EQUAL)) {
+    initializer = expression();
+  }
+
+  consume(Token_Type::TT_SEMICOLON, "Expect ';' after variable declaration.");
+  return this->ast.add(Node_Kind::NK_VAR, name.get_offset(),
+                       name.get_literal(), initializer);
+}
+
+Node_Id Parser::statement() {
+  enter();
+
+  Node_Id node;
+  if (match(Token_Type::TT_FOR)) {
+    node = for_statement();
+  } else if (match(Token_Type::TT_IF)) {
+    node = if_statement();
+  } else if (match(Token_Type::TT_PRINT)) {
+    node = print_statement();
+  } else if (match(Token_Type::TT_RETURN)) {
+    node = return_statement();
+  } else if (match(Token_Type::TT_WHILE)) {
+    node = while_statement();
+  } else if (match(Token_Type::TT_LEFT_BRACE)) {
+    uint32_t offset = this->previous.get_offset();
+    node = this->ast.add(Node_Kind::NK_BLOCK, offset, block());
+  } else {
+    node = expression_statement();
+  }
+
+  this->depth--;
+  return node;
+}
+
+Node_Id Parser::for_statement() {
+  uint32_t offset = this->previous.get_offset();
+  consume(Token_Type::TT_LEFT_PAREN, "Expect '(' after 'for'.");
+
+  Node_Id initializer = Ast::NO_NODE;
+  if (match(Token_Type::TT_VAR)) {
+    initializer = var_declaration();
+  } else if (!match(Token_Type::TT_SEMICOLON)) {
+    initializer = expression_statement();
+  }
+
+  Node_Id condition = Ast::NO_NODE;
+  if (!check(Token_Type::TT_SEMICOLON)) {
+    condition = expression();
+  }
+  consume(Token_Type::TT_SEMICOLON, "Expect ';' after loop condition.");
+
+  Node_Id increment = Ast::NO_NODE;
+  if (!check(Token_Type::TT_RIGHT_PAREN)) {
+    increment = expression();
+  }
+  consume(Token_Type::TT_RIGHT_PAREN, "Expect ')' after for clauses.");
+
+  Node_Id body = statement();
+
+  // for (initializer; condition; increment) body becomes
+  // { initializer; while (condition) { body; increment; } }
+  if (increment != Ast::NO_NODE) {
+    uint32_t statements[] = {
+        body, this->ast.add(Node_Kind::NK_EXPRESSION,
+                            this->ast.get(increment).offset, increment)};
+    body = this->ast.add(Node_Kind::NK_BLOCK, offset,
+                         this->ast.add_list(statements, 2));
+  }
+
+  if (condition == Ast::NO_NODE) {
+    condition = this->ast.add(Node_Kind::NK_TRUE, offset);
+  }
+  body = this->ast.add(Node_Kind::NK_WHILE, offset, condition, body);
+
+  if (initializer != Ast::NO_NODE) {
+    uint32_t statements[] = {initializer, body};
+    body = this->ast.add(Node_Kind::NK_BLOCK, offset,
+                         this->ast.add_list(statements, 2));
+  }
+
+  return body;
+}
+
+Node_Id Parser::if_statement() {
+  uint32_t offset = this->previous.get_offset();
+  consume(Token_Type::TT_LEFT_PAREN, "Expect '(' after 'if'.");
+  Node_Id condition = expression();
+  consume(Token_Type::TT_RIGHT_PAREN, "Expect ')' after if condition.");
+
+  Node_Id then_branch = statement();
+  Node_Id else_branch = Ast::NO_NODE;
+  if (match(Token_Type::TT_ELSE)) {
+    else_branch = statement();
+  }
+
+  return this->ast.add(Node_Kind::NK_IF, offset, condition, then_branch,
+                       else_branch);
+}
+
+Node_Id Parser::print_statement() {
+  uint32_t offset = this->previous.get_offset();
+  Node_Id value = expression();
+  consume(Token_Type::TT_SEMICOLON, "Expect ';' after value.");
+  return this->ast.add(Node_Kind::NK_PRINT, offset, value);
+}
+
+Node_Id Parser::return_statement() {
+  uint32_t offset = this->previous.get_offset();
+
+  Node_Id value = Ast::NO_NODE;
+  if (!check(Token_Type::TT_SEMICOLON)) {
+    value = expression();
+  }
+
+  consume(Token_Type::TT_SEMICOLON, "Expect ';' after return value.");
+  return this->ast.add(Node_Kind::NK_RETURN, offset, value);
+}
+
+Node_Id Parser::while_statement() {
+  uint32_t offset = this->previous.get_offset();
+  consume(Token_Type::TT_LEFT_PAREN, "Expect '(' after 'while'.");
+  Node_Id condition = expression();
+  consume(Token_Type::TT_RIGHT_PAREN, "Expect ')' after condition.");
+  Node_Id body = statement();
+
+  return this->ast.add(Node_Kind::NK_WHILE, offset, condition, body);
+}
+
+Node_Id Parser::expression_statement() {
+  Node_Id value = expression();
+  consume(Token_Type::TT_SEMICOLON, "Expect ';' after expression.");
+  return this->ast.add(Node_Kind::NK_EXPRESSION, this->ast.get(value).offset,
+                       value);
+}
+
+uint32_t Parser::block() {
+  int mark = this->scratch.get_maximum_index() + 1;
+
+  while (!check(Token_Type::TT_RIGHT_BRACE) && !check(Token_Type::TT_EOF)) {
+    Node_Id node = declaration();
+    if (node != Ast::NO_NODE) {
+      this->scratch.push_back(node);
+    }
+  }
+
+  consume(Token_Type::TT_RIGHT_BRACE, "Expect '}' after block.");
+  return finish_list(mark);
+}
+
+/*******************************************************************************
+EXPRESSIONS
+*******************************************************************************/
+Node_Id Parser::expression() {
+  return parse_precedence(Precedence::ASSIGNMENT);
+}
+
+Node_Id Parser::parse_precedence(Precedence precedence) {
+  uint32_t depth = this->depth;
+  enter();
+
+  Prefix_Function prefix = RULES[(std::size_t)peek().get_type()].prefix;
+  if (prefix == nullptr) {
+    error(peek(), "Expect expression.");
+    throw Parse_Error();
+  }
+  advance();
+
+  // Only an expression parsed at the lowest precedence can be the target of
+  // an assignment; e.g. in a + b = c the b must not take the = c.
+  bool can_assign = precedence <= Precedence::ASSIGNMENT;
+  Node_Id left = (this->*prefix)(can_assign);
+
+  // Each operator taken puts the expression so far one level deeper in the
+  // tree, so it counts as nesting too; a chain such as 1 + 1 + ... + 1 is
+  // parsed in this loop but is as deep as it is long.
+  while (precedence <= RULES[(std::size_t)peek().get_type()].precedence) {
+    enter();
+    Infix_Function infix = RULES[(std::size_t)advance().get_type()].infix;
+    left = (this->*infix)(left, can_assign);
+  }
+
+  // An = left over follows something that can't be assigned to. The value is
+  // parsed anyway, so the error doesn't cascade.
+  if (can_assign && match(Token_Type::TT_EQUAL)) {
+    Token equals = this->previous;
+    expression();
+    error(equals, "Invalid assignment target.");
+  }
+
+  this->depth = depth;
+  return left;
+}
+
+Node_Id Parser::grouping(bool) {
+  uint32_t offset = this->previous.get_offset();
+  Node_Id inner = expression();
+  consume(Token_Type::TT_RIGHT_PAREN, "Expect ')' after expression.");
+  return this->ast.add(Node_Kind::NK_GROUPING, offset, inner);
+}
+
+Node_Id Parser::number(bool) {
+  return this->ast.add(Node_Kind::NK_NUMBER, this->previous.get_offset(),
+                       this->previous.get_literal());
+}
+
+Node_Id Parser::string(bool) {
+  return this->ast.add(Node_Kind::NK_STRING, this->previous.get_offset(),
+                       this->previous.get_literal());
+}
+
+Node_Id Parser::literal(bool) {
+  Node_Kind kind = Node_Kind::NK_NIL;
+  if (this->previous.get_type() == Token_Type::TT_TRUE) {
+    kind = Node_Kind::NK_TRUE;
+  } else if (this->previous.get_type() == Token_Type::TT_FALSE) {
+    kind = Node_Kind::NK_FALSE;
+  }
+
+  return this->ast.add(kind, this->previous.get_offset());
+}
+
+Node_Id Parser::variable(bool can_assign) {
+  Token name = this->previous;
+
+  if (can_assign && match(Token_Type::TT_EQUAL)) {
+    Node_Id value = expression();
+    return this->ast.add(Node_Kind::NK_ASSIGN, name.get_offset(),
+                         name.get_literal(), value);
+  }
+
+  return this->ast.add(Node_Kind::NK_VARIABLE, name.get_offset(),
+                       name.get_literal());
+}
+
+Node_Id Parser::this_(bool) {
+  return this->ast.add(Node_Kind::NK_THIS, this->previous.get_offset());
+}
+
+Node_Id Parser::super_(bool) {
+  uint32_t offset = this->previous.get_offset();
+  consume(Token_Type::TT_DOT, "Expect '.' after 'super'.");
+  const Token& method =
+      consume(Token_Type::TT_IDENTIFIER, "Expect superclass method name.");
+  return this->ast.add(Node_Kind::NK_SUPER, offset, method.get_literal());
+}
+
+Node_Id Parser::unary(bool) {
+  Token op = this->previous;
+  Node_Id operand = parse_precedence(Precedence::UNARY);
+  return this->ast.add(Node_Kind::NK_UNARY, op.get_offset(), operand, 0, 0,
+                       op.get_type());
+}
+
+Node_Id Parser::binary(Node_Id left, bool) {
+  // The right operand binds one level tighter, so operators of the same
+  // precedence associate to the left.
+  Token op = this->previous;
+  Precedence precedence = RULES[(std::size_t)op.get_type()].precedence;
+  Node_Id right = parse_precedence((Precedence)((uint8_t)precedence + 1));
+  return this->ast.add(Node_Kind::NK_BINARY, op.get_offset(), left, right, 0,
+                       op.get_type());
+}
+
+Node_Id Parser::logical(Node_Id left, bool) {
+  Token op = this->previous;
+  Precedence precedence = RULES[(std::size_t)op.get_type()].precedence;
+  Node_Id right = parse_precedence((Precedence)((uint8_t)precedence + 1));
+  return this->ast.add(Node_Kind::NK_LOGICAL, op.get_offset(), left, right, 0,
+                       op.get_type());
+}
+
+Node_Id Parser::call(Node_Id left, bool) {
+  uint32_t offset = this->previous.get_offset();
+
+  int mark = this->scratch.get_maximum_index() + 1;
+  if (!check(Token_Type::TT_RIGHT_PAREN)) {
+    do {
+      if ((std::size_t)(this->scratch.get_maximum_index() + 1 - mark) >=
+          MAX_ARGUMENTS) {
+        error(peek(), "Can't have more than 255 arguments.");
+      }
+      this->scratch.push_back(expression());
+    } while (match(Token_Type::TT_COMMA));
+  }
+  consume(Token_Type::TT_RIGHT_PAREN, "Expect ')' after arguments.");
+
+  return this->ast.add(Node_Kind::NK_CALL, offset, left, finish_list(mark));
+}
+
+Node_Id Parser::dot(Node_Id left, bool can_assign) {
+  const Token& name =
+      consume(Token_Type::TT_IDENTIFIER, "Expect property name after '.'.");
+  uint32_t offset = name.get_offset();
+  uint32_t property = name.get_literal();
+
+  if (can_assign && match(Token_Type::TT_EQUAL)) {
+    Node_Id value = expression();
+    return this->ast.add(Node_Kind::NK_SET, offset, left, property, value);
+  }
+
+  return this->ast.add(Node_Kind::NK_GET, offset, left, property);
+}
+
+/*******************************************************************************
+HELPERS
+*******************************************************************************/
+uint32_t Parser::finish_list(int mark) {
+  std::size_t count = this->scratch.get_maximum_index() + 1 - mark;
+  const uint32_t* items = (count == 0) ? nullptr : &this->scratch[mark];
+  uint32_t list = this->ast.add_list(items, count);
+  truncate_scratch(mark);
+  return list;
+}
+
+void Parser::truncate_scratch(int mark) {
+  while (this->scratch.get_maximum_index() >= mark) {
+    this->scratch.remove(this->scratch.get_maximum_index());
+  }
+}
+
+void Parser::enter() {
+  if (++this->depth > MAX_DEPTH) {
+    error(peek(), "Too much nesting.");
+    throw Parse_Error();
+  }
+}
+
+const Token& Parser::peek() { return this->tokens.peek(); }
+
+bool Parser::check(Token_Type type) { return this->tokens.check(type); }
+
+bool Parser::match(Token_Type type) {
+  if (!check(type)) {
+    return false;
+  }
+
+  advance();
+  return true;
+}
+
+const Token& Parser::advance() {
+  this->previous = this->tokens.advance();
+  return this->previous;
+}
+
+const Token& Parser::consume(Token_Type type, std::string_view message) {
+  if (!check(type)) {
+    error(peek(), message);
+    throw Parse_Error();
+  }
+
+  return advance();
+}
+
+void Parser::error(const Token& token, std::string_view message) {
+  std::string where = " at end";
+  if (token.get_type() != Token_Type::TT_EOF) {
+    std::string_view lexeme = token.get_lexeme(this->source.get_contents());
+    where = " at '" + std::string(lexeme) + "'";
+  }
+
+  this->error_reporting.error(this->source.get_line(token.get_offset()), where,
+                              std::string(message));
+}
+
+void Parser::synchronize() {
+  advance();
+
+  while (!check(Token_Type::TT_EOF)) {
+    if (this->previous.get_type() == Token_Type::TT_SEMICOLON) {
+      return;
+    }
+
+    switch (peek().get_type()) {
+      case Token_Type::TT_CLASS:
+      case Token_Type::TT_FUN:
+      case Token_Type::TT_VAR:
+      case Token_Type::TT_FOR:
+      case Token_Type::TT_IF:
+      case Token_Type::TT_WHILE:
+      case Token_Type::TT_PRINT:
+      case Token_Type::TT_RETURN:
+        return;
+      default:
+        break;
+    }
+
+    advance();
+  }
+}
@@ -0,0 +1,289 @@
+#include "scanner/byte_scan.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LOX_BYTE_SCAN_X86
+#endif
+
+namespace lox_byte_scan {
+
+/*******************************************************************************
+SCALAR KERNELS
+*******************************************************************************/
+static bool is_whitespace(char c) {
+  return ((c == ' ') || (c == '\t') || (c == '\r') || (c == '\n'));
+}
+
+static bool is_identifier_byte(char c) {
+  return (((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+          ((c >= '0') && (c <= '9')) || (c == '_'));
+}
+
+static std::size_t scalar_skip_whitespace(const char* text, std::size_t length,
+                                          uint64_t& newlines) {
+  std::size_t i = 0;
+  while ((i < length) && is_whitespace(text[i])) {
+    newlines += (text[i] == '\n');
+    i++;
+  }
+  return i;
+}
+
+static std::size_t scalar_find_newline(const char* text, std::size_t length) {
+  std::size_t i = 0;
+  while ((i < length) && (text[i] != '\n')) {
+    i++;
+  }
+  return i;
+}
+
+static std::size_t scalar_find_quote(const char* text, std::size_t length,
+                                     uint64_t& newlines) {
+  std::size_t i = 0;
+  while ((i < length) && (text[i] != '"')) {
+    newlines += (text[i] == '\n');
+    i++;
+  }
+  return i;
+}
+
+static std::size_t scalar_skip_identifier(const char* text,
+                                          std::size_t length) {
+  std::size_t i = 0;
+  while ((i < length) && is_identifier_byte(text[i])) {
+    i++;
+  }
+  return i;
+}
+
+static const Kernels SCALAR = {"scalar", scalar_skip_whitespace,
+                               scalar_find_newline, scalar_find_quote,
+                               scalar_skip_identifier};
+
+const Kernels& scalar() { return SCALAR; }
+
+#if defined(LOX_BYTE_SCAN_X86)
+
+/*******************************************************************************
+SSE4.2 KERNELS
+The kernels process 16 bytes per step with unaligned loads and finish the last
+partial block with the scalar kernels, so they never read past the end of the
+text. PCMPESTRI classifies a block against a set or ranges of bytes and returns
+the index of the first byte outside of it (16 if there is none).
+*******************************************************************************/
+#define LOX_SSE42 __attribute__((target("sse4.2,popcnt")))
+
+// Bits of mask below bit index.
+static inline uint32_t bits_below(uint32_t mask, uint32_t index) {
+  return (index >= 32) ? mask : (mask & ((1u << index) - 1u));
+}
+
+LOX_SSE42 static std::size_t sse42_skip_whitespace(const char* text,
+                                                   std::size_t length,
+                                                   uint64_t& newlines) {
+  const __m128i set = _mm_setr_epi8(' ', '\t', '\r', '\n', 0, 0, 0, 0, 0, 0, 0,
+                                    0, 0, 0, 0, 0);
+  const __m128i newline = _mm_set1_epi8('\n');
+  std::size_t i = 0;
+  for (; (i + 16) <= length; i += 16) {
+    __m128i block = _mm_loadu_si128((const __m128i*)(text + i));
+    int end = _mm_cmpestri(set, 4, block, 16,
+                           _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY |
+                               _SIDD_NEGATIVE_POLARITY |
+                               _SIDD_LEAST_SIGNIFICANT);
+    uint32_t newline_mask =
+        (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline));
+    newlines += __builtin_popcount(bits_below(newline_mask, end));
+    if (end < 16) {
+      return i + end;
+    }
+  }
+  return i + scalar_skip_whitespace(text + i, length - i, newlines);
+}
+
+LOX_SSE42 static std::size_t sse42_find_newline(const char* text,
+                                                std::size_t length) {
+  const __m128i newline = _mm_set1_epi8('\n');
+  std::size_t i = 0;
+  for (; (i + 16) <= length; i += 16) {
+    __m128i block = _mm_loadu_si128((const __m128i*)(text + i));
+    uint32_t mask =
+        (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline));
+    if (mask != 0) {
+      return i + __builtin_ctz(mask);
+    }
+  }
+  return i + scalar_find_newline(text + i, length - i);
+}
+
+LOX_SSE42 static std::size_t sse42_find_quote(const char* text,
+                                              std::size_t length,
+                                              uint64_t& newlines) {
+  const __m128i quote = _mm_set1_epi8('"');
+  const __m128i newline = _mm_set1_epi8('\n');
+  std::size_t i = 0;
+  for (; (i + 16) <= length; i += 16) {
+    __m128i block = _mm_loadu_si128((const __m128i*)(text + i));
+    uint32_t quote_mask =
+        (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, quote));
+    uint32_t newline_mask =
+        (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline));
+    if (quote_mask != 0) {
+      uint32_t end = __builtin_ctz(quote_mask);
+      newlines += __builtin_popcount(bits_below(newline_mask, end));
+      return i + end;
+    }
+    newlines += __builtin_popcount(newline_mask);
+  }
+  return i + scalar_find_quote(text + i, length - i, newlines);
+}
+
+LOX_SSE42 static std::size_t sse42_skip_identifier(const char* text,
+                                                   std::size_t length) {
+  const __m128i ranges = _mm_setr_epi8('a', 'z', 'A', 'Z', '0', '9', '_', '_',
+                                       0, 0, 0, 0, 0, 0, 0, 0);
+  std::size_t i = 0;
+  for (; (i + 16) <= length; i += 16) {
+    __m128i block = _mm_loadu_si128((const __m128i*)(text + i));
+    int end = _mm_cmpestri(ranges, 8, block, 16,
+                           _SIDD_UBYTE_OPS | _SIDD_CMP_RANGES |
+                               _SIDD_NEGATIVE_POLARITY |
+                               _SIDD_LEAST_SIGNIFICANT);
+    if (end < 16) {
+      return i + end;
+    }
+  }
+  return i + scalar_skip_identifier(text + i, length - i);
+}
+
+#undef LOX_SSE42
+
+static const Kernels SSE42 = {"sse4.2", sse42_skip_whitespace,
+                              sse42_find_newline, sse42_find_quote,
+                              sse42_skip_identifier};
+
+/*******************************************************************************
+AVX2 KERNELS
+The same approach as the SSE4.2 kernels with 32 bytes per step. AVX2 has no
+string compare instructions, so byte classes are built from byte compares;
+signed compares work for the ASCII ranges because bytes of 0x80 and above are
+negative and so below every range.
+*******************************************************************************/
+#define LOX_AVX2 __attribute__((target("avx2,bmi,popcnt")))
+
+LOX_AVX2 static inline __m256i in_range(__m256i block, char low, char high) {
+  return _mm256_and_si256(_mm256_cmpgt_epi8(block, _mm256_set1_epi8(low - 1)),
+                          _mm256_cmpgt_epi8(_mm256_set1_epi8(high + 1), block));
+}
+
+LOX_AVX2 static std::size_t avx2_skip_whitespace(const char* text,
+                                                 std::size_t length,
+                                                 uint64_t& newlines) {
+  std::size_t i = 0;
+  for (; (i + 32) <= length; i += 32) {
+    __m256i block = _mm256_loadu_si256((const __m256i*)(text + i));
+    __m256i is_newline = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n'));
+    __m256i is_space = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(' ')),
+                        _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\t'))),
+        _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\r')),
+                        is_newline));
+    uint32_t other_mask = ~(uint32_t)_mm256_movemask_epi8(is_space);
+    uint32_t newline_mask = (uint32_t)_mm256_movemask_epi8(is_newline);
+    if (other_mask != 0) {
+      uint32_t end = _tzcnt_u32(other_mask);
+      newlines += __builtin_popcount(bits_below(newline_mask, end));
+      return i + end;
+    }
+    newlines += __builtin_popcount(newline_mask);
+  }
+  return i + scalar_skip_whitespace(text + i, length - i, newlines);
+}
+
+LOX_AVX2 static std::size_t avx2_find_newline(const char* text,
+                                              std::size_t length) {
+  const __m256i newline = _mm256_set1_epi8('\n');
+  std::size_t i = 0;
+  for (; (i + 32) <= length; i += 32) {
+    __m256i block = _mm256_loadu_si256((const __m256i*)(text + i));
+    uint32_t mask =
+        (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline));
+    if (mask != 0) {
+      return i + _tzcnt_u32(mask);
+    }
+  }
+  return i + scalar_find_newline(text + i, length - i);
+}
+
+LOX_AVX2 static std::size_t avx2_find_quote(const char* text,
+                                            std::size_t length,
+                                            uint64_t& newlines) {
+  const __m256i quote = _mm256_set1_epi8('"');
+  const __m256i newline = _mm256_set1_epi8('\n');
+  std::size_t i = 0;
+  for (; (i + 32) <= length; i += 32) {
+    __m256i block = _mm256_loadu_si256((const __m256i*)(text + i));
+    uint32_t quote_mask =
+        (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, quote));
+    uint32_t newline_mask =
+        (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newline));
+    if (quote_mask != 0) {
+      uint32_t end = _tzcnt_u32(quote_mask);
+      newlines += __builtin_popcount(bits_below(newline_mask, end));
+      return i + end;
+    }
+    newlines += __builtin_popcount(newline_mask);
+  }
+  return i + scalar_find_quote(text + i, length - i, newlines);
+}
+
+LOX_AVX2 static std::size_t avx2_skip_identifier(const char* text,
+                                                 std::size_t length) {
+  std::size_t i = 0;
+  for (; (i + 32) <= length; i += 32) {
+    __m256i block = _mm256_loadu_si256((const __m256i*)(text + i));
+    // Setting bit 5 folds upper case letters onto lower case ones.
+    __m256i folded = _mm256_or_si256(block, _mm256_set1_epi8(0x20));
+    __m256i is_identifier = _mm256_or_si256(
+        _mm256_or_si256(in_range(folded, 'a', 'z'), in_range(block, '0', '9')),
+        _mm256_cmpeq_epi8(block, _mm256_set1_epi8('_')));
+    uint32_t other_mask = ~(uint32_t)_mm256_movemask_epi8(is_identifier);
+    if (other_mask != 0) {
+      return i + _tzcnt_u32(other_mask);
+    }
+  }
+  return i + scalar_skip_identifier(text + i, length - i);
+}
+
+#undef LOX_AVX2
+
+static const Kernels AVX2 = {"avx2", avx2_skip_whitespace, avx2_find_newline,
+                             avx2_find_quote, avx2_skip_identifier};
+
+const Kernels* sse42() {
+  return __builtin_cpu_supports("sse4.2") ? &SSE42 : nullptr;
+}
+
+const Kernels* avx2() {
+  return (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("bmi"))
+             ? &AVX2
+             : nullptr;
+}
+
+#else
+
+const Kernels* sse42() { return nullptr; }
+
+const Kernels* avx2() { return nullptr; }
+
+#endif
+
+const Kernels& best() {
+  // Picked once; the CPU doesn't change while the program runs.
+  static const Kernels& kernels = avx2()    ? *avx2()
+                                  : sse42() ? *sse42()
+                                            : scalar();
+  return kernels;
+}
+
+}  // namespace lox_byte_scan
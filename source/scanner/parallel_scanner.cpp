@@ -0,0 +1,249 @@
+#include "scanner/parallel_scanner.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include "scanner/scanner.hpp"
+
+// Returns whether text ends inside a string when it starts inside one
+// (in_string) or between tokens. Only strings and comments matter: a '"'
+// between tokens starts a string unless a "//" before it on its line starts a
+// comment. The quotes are found with the vector kernels, and only the line of
+// each quote is searched for a comment.
+static bool ends_in_string(const char* text, std::size_t length, bool in_string,
+                           const lox_byte_scan::Kernels& kernels) {
+  std::string_view view(text, length);
+  std::size_t i = 0;
+  while (i < length) {
+    uint64_t newlines = 0;
+    std::size_t quote = i + kernels.find_quote(text + i, length - i, newlines);
+    if (quote == length) {
+      return in_string;
+    }
+
+    if (in_string) {
+      in_string = false;
+      i = quote + 1;
+      continue;
+    }
+
+    // There are no quotes between i and the quote, so a "//" on the quote's
+    // line after i can't be inside a string.
+    std::size_t line_start = view.substr(i, quote - i).rfind('\n');
+    line_start =
+        (line_start == std::string_view::npos) ? i : (i + line_start + 1);
+    std::size_t comment =
+        view.substr(line_start, quote - line_start).find("//");
+    if (comment != std::string_view::npos) {
+      i = quote + kernels.find_newline(text + quote, length - quote);
+    } else {
+      in_string = true;
+      i = quote + 1;
+    }
+  }
+
+  return in_string;
+}
+
+// Calls work on every chunk, each on its own thread.
+template <typename Chunk, typename Work>
+static void for_each_in_parallel(Dynamic_Array<Chunk>& chunks, Work work) {
+  Dynamic_Array<std::thread> threads;
+  for (int i = 1; i <= chunks.get_maximum_index(); i++) {
+    threads.emplace_back(work, std::ref(chunks[i]));
+  }
+
+  // The calling thread takes the first chunk.
+  work(chunks[0]);
+
+  for (std::thread& thread : threads) {
+    thread.join();
+  }
+}
+
+Parallel_Scanner::Parallel_Scanner(const Source_File& source_file,
+                                   Error_Reporter& e, std::size_t chunks,
+                                   const lox_byte_scan::Kernels& kernels)
+    : source_file(source_file), error_reporting(e), kernels(kernels) {
+  this->chunk_count = chunks;
+  if (this->chunk_count == 0) {
+    this->chunk_count = std::min<std::size_t>(
+        std::max(1u, std::thread::hardware_concurrency()),
+        (source_file.get_contents().length() / MIN_CHUNK_BYTES) + 1);
+  }
+}
+
+Token_Array& Parallel_Scanner::scan_tokens() {
+  // The source has been scanned already if there is a TT_EOF token.
+  if (this->tokens.get_maximum_index() >= 0) {
+    return this->tokens;
+  }
+
+  std::string_view text = this->source_file.get_contents();
+
+  // Split the source at the starts of lines near evenly spaced points.
+  Dynamic_Array<Chunk> chunks;
+  chunks.reserve(this->chunk_count);
+  std::size_t begin = 0;
+  for (std::size_t i = 1; i <= this->chunk_count; i++) {
+    std::size_t end = text.length();
+    if (i < this->chunk_count) {
+      std::size_t target =
+          std::max(begin, (text.length() / this->chunk_count) * i);
+      const void* newline =
+          std::memchr(text.data() + target, '\n', text.length() - target);
+      if (newline != nullptr) {
+        end = ((const char*)newline - text.data()) + 1;
+      }
+    }
+
+    Chunk& chunk = chunks.emplace_back();
+    chunk.begin = begin;
+    chunk.end = end;
+    chunk.first_token = 0;
+    chunk.literal_base = 0;
+    chunk.errors.hold_errors = true;
+
+    begin = end;
+    if (begin == text.length()) {
+      break;
+    }
+  }
+
+  for_each_in_parallel(chunks, [this](Chunk& chunk) { survey(chunk); });
+
+  // Follow the strings from chunk to chunk to find where each one starts.
+  bool in_string = false;
+  uint64_t line = 1;
+  for (Chunk& chunk : chunks) {
+    chunk.starts_in_string = in_string;
+    chunk.line = line;
+    in_string = chunk.ends_in_string[in_string];
+    line += chunk.newlines;
+  }
+
+  // The first chunk is scanned straight into the result; the others are
+  // copied in after it.
+  for_each_in_parallel(chunks, [this, &chunks](Chunk& chunk) {
+    if (&chunk == &chunks[0]) {
+      scan(chunk, this->tokens, this->literals, this->symbols);
+    } else {
+      scan(chunk, chunk.tokens, chunk.literals, chunk.symbols);
+    }
+  });
+
+  // Place each chunk's tokens and literals after the ones of the chunks before
+  // it, intern its symbols after theirs, and report the errors in order.
+  std::size_t token_count = 0;
+  uint32_t literal_count = (uint32_t)this->literals.get_size();
+  for (int i = 1; i <= chunks.get_maximum_index(); i++) {
+    Chunk& chunk = chunks[i];
+    chunk.first_token = token_count;
+    chunk.literal_base = literal_count;
+    token_count += chunk.tokens.get_maximum_index() + 1;
+    literal_count += (uint32_t)chunk.literals.get_size();
+
+    for (std::size_t j = 0; j < chunk.literals.get_size(); j++) {
+      this->literals.add_number(chunk.literals.get_number((uint32_t)j));
+    }
+
+    // The hashes were computed by the chunk's own interner.
+    chunk.symbol_map.reserve(chunk.symbols.get_size());
+    for (std::size_t j = 0; j < chunk.symbols.get_size(); j++) {
+      chunk.symbol_map.push_back(
+          this->symbols.intern(chunk.symbols.get_string((uint32_t)j),
+                               chunk.symbols.get_hash((uint32_t)j)));
+    }
+  }
+  for (Chunk& chunk : chunks) {
+    this->error_reporting.report_held(chunk.errors);
+  }
+
+  // Copy the tokens in parallel too, so that joining them doesn't limit how
+  // well the scanning scales.
+  this->tokens.reserve(this->tokens.get_maximum_index() + 1 + token_count + 1);
+  Token* joined = this->tokens.append_for_overwrite(token_count);
+  for_each_in_parallel(chunks, [joined](Chunk& chunk) {
+    Token* destination = joined + chunk.first_token;
+    for (const Token& token : chunk.tokens) {
+      if (token.get_type() == Token_Type::TT_NUMBER) {
+        *destination = Token(token.get_type(), token.get_offset(),
+                             token.get_length(),
+                             chunk.literal_base + token.get_literal());
+      } else if ((token.get_type() == Token_Type::TT_IDENTIFIER) ||
+                 (token.get_type() == Token_Type::TT_STRING)) {
+        *destination =
+            Token(token.get_type(), token.get_offset(), token.get_length(),
+                  chunk.symbol_map[token.get_literal()]);
+      } else {
+        *destination = token;
+      }
+      destination++;
+    }
+  });
+
+  // Add end of file (EOF) token.
+  this->tokens.emplace_back(Token_Type::TT_EOF, (uint32_t)text.length(), 0u);
+
+  return this->tokens;
+}
+
+const Literal_Table& Parallel_Scanner::get_literals() const {
+  return this->literals;
+}
+
+const String_Interner& Parallel_Scanner::get_symbols() const {
+  return this->symbols;
+}
+
+void Parallel_Scanner::survey(Chunk& chunk) const {
+  std::string_view text = this->source_file.get_contents();
+  const char* begin = text.data() + chunk.begin;
+  std::size_t length = chunk.end - chunk.begin;
+
+  chunk.ends_in_string[0] = ends_in_string(begin, length, false, this->kernels);
+  chunk.ends_in_string[1] = ends_in_string(begin, length, true, this->kernels);
+  chunk.newlines = (uint64_t)std::count(begin, begin + length, '\n');
+}
+
+void Parallel_Scanner::scan(Chunk& chunk, Token_Array& tokens,
+                            Literal_Table& literals,
+                            String_Interner& symbols) const {
+  Scanner s(this->source_file, chunk.errors, this->kernels);
+  s.current = chunk.begin;
+  s.line = chunk.line;
+
+  // The rest of a string that started in an earlier chunk was scanned with
+  // that chunk.
+  if (chunk.starts_in_string) {
+    uint64_t newlines = 0;
+    s.current += this->kernels.find_quote(s.source.data() + chunk.begin,
+                                          chunk.end - chunk.begin, newlines);
+    s.line += newlines;
+    if (s.current == chunk.end) {
+      return;
+    }
+
+    // The closing ".
+    s.current++;
+  }
+
+  std::size_t estimate =
+      (chunk.end - s.current) / Scanner::ESTIMATED_BYTES_PER_TOKEN;
+  tokens.reserve(tokens.get_maximum_index() + 1 + estimate + 1);
+
+  // Scan the tokens that start in the chunk; the last one may end past it.
+  while (s.current < chunk.end) {
+    s.start = s.current;  // We are at the beginning of the next lexeme.
+    if (s.scan_token()) {
+      tokens.push_back(s.token);
+    }
+  }
+
+  literals = std::move(s.literals);
+  symbols = std::move(s.symbols);
+}
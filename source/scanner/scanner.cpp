@@ -1,220 +1,305 @@
 #include "scanner/scanner.hpp"
 
+#include <charconv>
+#include <limits>
+#include <string_view>
+#include <system_error>
+
+#include "scanner/char_class.hpp"
+#include "scanner/keywords.hpp"
 #include "token/token.hpp"
 
-Scanner::Scanner(const std::string& source, Error_Reporter& e) {
-  this->source = source;
-  this->error_reporting = e;
-  tokens = new Dynamic_Array<Token>();
+Scanner::Scanner(const Source_File& source_file, Error_Reporter& e,
+                 const lox_byte_scan::Kernels& kernels,
+                 std::pmr::memory_resource* resource)
+    : source_file(source_file),
+      tokens(resource),
+      literals(resource),
+      symbols(resource),
+      error_reporting(e),
+      kernels(kernels) {
+  this->source = this->source_file.get_contents();
+  this->more_input = false;
+  this->ended = false;
+  this->cut_off = false;
 
   this->start = 0;  // Index of the first character in the lexeme.
   this->current =
       0;  // Index of the current character being considered in the lexeme.
   this->line = 1;  // Current line number of source code.
+}
 
-  this->lox_keywords = new Hash_Table<std::string, Token_Type>();
-
-#define ENUM_TO_STR(v) std::string(#v).substr(3), v
-
-  this->lox_keywords->insert(ENUM_TO_STR(Token_Type::TT_AND));
-  this->lox_keywords->insert(ENUM_TO_STR(Token_Type::TT_CLASS));
-  this->lox_keywords->insert(ENUM_TO_STR(Token_Type::TT_ELSE));
-  this->lox_keywords->insert(ENUM_TO_STR(Token_Type::TT_FALSE));
-  this->lox_keywords->insert(ENUM_TO_STR(Token_Type::TT_FOR));
-  this->lox_keywords->insert(ENUM_TO_STR(Token_Type::TT_FUN));
-  this->lox_keywords->insert(ENUM_TO_STR(Token_Type::TT_IF));
-  this->lox_keywords->insert(ENUM_TO_STR(Token_Type::TT_NIL));
-  this->lox_keywords->insert(ENUM_TO_STR(Token_Type::TT_OR));
-  this->lox_keywords->insert(ENUM_TO_STR(Token_Type::TT_PRINT));
-  this->lox_keywords->insert(ENUM_TO_STR(Token_Type::TT_RETURN));
-  this->lox_keywords->insert(ENUM_TO_STR(Token_Type::TT_SUPER));
-  this->lox_keywords->insert(ENUM_TO_STR(Token_Type::TT_THIS));
-  this->lox_keywords->insert(ENUM_TO_STR(Token_Type::TT_TRUE));
-  this->lox_keywords->insert(ENUM_TO_STR(Token_Type::TT_VAR));
-  this->lox_keywords->insert(ENUM_TO_STR(Token_Type::TT_WHILE));
-
-#undef ENUM_TO_STR
+Scanner::Scanner(Error_Reporter& e, const lox_byte_scan::Kernels& kernels,
+                 std::pmr::memory_resource* resource)
+    : Scanner(Source_File(std::string()), e, kernels, resource) {
+  this->more_input = true;
 }
 
 bool Scanner::is_at_end() const { return (current >= source.length()); }
 
+// True if index is past the end of the window and more input is coming.
+bool Scanner::reaches_end(uint64_t index) const {
+  return (more_input && (index >= source.length()));
+}
+
 // Returns the current character and advances current.
 char Scanner::advance() {
   current++;
   return source[(current - 1)];
 }
 
-void Scanner::add_token(Token_Type type) { add_token(type, NULL); }
+bool Scanner::add_token(Token_Type type, uint32_t literal) {
+  // The token only records where its lexeme is in the source; nothing is
+  // copied.
+  token = Token(type, (uint32_t)start, (uint32_t)(current - start), literal);
+  return true;
+}
 
-void Scanner::add_token(Token_Type type, const std::any& literal) {
-  std::string text = source.substr(start, (current - start));
-  Token t(type, text, literal, line);
-  tokens->insert(t, (tokens->get_maximum_index() + 1));
+Token_Array& Scanner::scan_tokens() {
+  // Pre-size the token array from the source length so that lexing a large
+  // source doesn't repeatedly grow the array.
+  tokens.reserve(tokens.get_maximum_index() + 1 +
+                 ((source.length() - current) / ESTIMATED_BYTES_PER_TOKEN) +
+                 1);
+
+  Token next;
+  while (next_token(next)) {
+    tokens.push_back(next);
+  }
+
+  return tokens;
 }
 
-Dynamic_Array<Token>& Scanner::scan_tokens() {
-  // Scan tokens until end of source.
+bool Scanner::next_token(Token& next) {
+  // A token cut off by the end of the window waits for the next piece.
+  if (cut_off) {
+    return false;
+  }
+
+  // Scan lexemes until one of them is a token; whitespace and comments
+  // aren't.
   while (!is_at_end()) {
     start = current;  // We are at the beginning of the next lexeme.
-    scan_token();
+    uint64_t start_line = line;
+    bool scanned = scan_token();
+
+    // A lexeme that reaches the last character of the window might continue in
+    // the next piece, e.g. an identifier or a '!' followed by '=', so it is
+    // scanned again from its start once the next piece has arrived.
+    if (reaches_end(current + 1)) {
+      current = start;
+      line = start_line;
+      cut_off = true;
+      return false;
+    }
+
+    if (scanned) {
+      next = token;
+      return true;
+    }
+  }
+
+  if (more_input || ended) {
+    return false;
   }
 
   // Add end of file (EOF) token.
-  Token t(Token_Type::TT_EOF, "", NULL, line);
-  tokens->insert(t, (tokens->get_maximum_index() + 1));
+  ended = true;
+  next = Token(Token_Type::TT_EOF, (uint32_t)current, 0u);
+  return true;
+}
 
-  return *tokens;
+void Scanner::feed(std::string_view chunk) {
+  // Keep the text that hasn't been scanned, which begins with the token cut
+  // off by the end of the last piece, if any; everything before it has been
+  // returned already.
+  window.erase(0, current);
+  window.append(chunk);
+  source = window;
+  start = 0;
+  current = 0;
+  cut_off = false;
+
+  // The literals of the returned tokens are only valid until the next piece.
+  literals.clear();
 }
 
-void Scanner::scan_token() {
-  char c = advance();
+void Scanner::finish() {
+  more_input = false;
+  cut_off = false;
+}
+
+Scanner::Iterator Scanner::begin() { return Iterator(*this); }
 
-  switch (c) {
-    case '(':
-      add_token(Token_Type::TT_LEFT_PAREN);
-      break;
-    case ')':
-      add_token(Token_Type::TT_RIGHT_PAREN);
-      break;
-    case '{':
-      add_token(Token_Type::TT_LEFT_BRACE);
-      break;
-    case '}':
-      add_token(Token_Type::TT_RIGHT_BRACE);
-      break;
-    case ',':
-      add_token(Token_Type::TT_COMMA);
-      break;
-    case '.':
-      add_token(Token_Type::TT_DOT);
-      break;
-    case '-':
-      add_token(Token_Type::TT_MINUS);
-      break;
-    case '+':
-      add_token(Token_Type::TT_PLUS);
-      break;
-    case ';':
-      add_token(Token_Type::TT_SEMICOLON);
-      break;
-    case '*':
-      add_token(Token_Type::TT_STAR);
-      break;
-    case '!':
-      add_token(match('=') ? Token_Type::TT_BANG_EQUAL : Token_Type::TT_BANG);
-      break;
-    case '=':
-      add_token(match('=') ? Token_Type::TT_EQUAL_EQUAL : Token_Type::TT_EQUAL);
-      break;
-    case '<':
-      add_token(match('=') ? Token_Type::TT_LESS_EQUAL : Token_Type::TT_LESS);
-      break;
-    case '>':
-      add_token(match('=') ? Token_Type::TT_GREATER_EQUAL
-                           : Token_Type::TT_GREATER);
-      break;
-    case '/':
-      if (match('/')) {
+std::default_sentinel_t Scanner::end() const { return std::default_sentinel; }
+
+std::string_view Scanner::get_text() const { return this->source; }
+
+const Literal_Table& Scanner::get_literals() const { return this->literals; }
+
+const String_Interner& Scanner::get_symbols() const { return this->symbols; }
+
+bool Scanner::scan_token() {
+  char c = advance();
+  const lox_char_class::Char_Info& info = lox_char_class::info(c);
+
+  // One table lookup picks the kind of token; the switch over the dense class
+  // values compiles to a single jump table.
+  switch (info.char_class) {
+    case lox_char_class::Char_Class::SINGLE:
+      return add_token(info.single);
+    case lox_char_class::Char_Class::OPERATOR:
+      // Maximal munch: the two-character token if the next character is '='.
+      if (peek() == '=') {
+        current++;
+        return add_token(info.with_equal);
+      }
+      return add_token(info.single);
+    case lox_char_class::Char_Class::SLASH:
+      if (peek() == '/') {
         // Ignore comments.
-        while ((peek() != '\n') && (!is_at_end())) {
-          advance();
-        }
-      } else {
-        add_token(Token_Type::TT_SLASH);
+        skip_comment();
+        return false;
       }
-      break;
-    case ' ':
-      break;
-    case '\r':
-      break;
-    case '\t':
-      break;
-    case '\n':
-      line++;
-      break;
-    case '"':
-      lox_string();
-      break;
-    default:
-      if (is_digit(c)) {
-        lox_number();
-      } else if (is_alpha(c)) {
-        lox_identifier();
-      } else {
+      return add_token(Token_Type::TT_SLASH);
+    case lox_char_class::Char_Class::WHITESPACE:
+      // Step back so the whole run of whitespace is skipped at once.
+      current--;
+      skip_whitespace();
+      return false;
+    case lox_char_class::Char_Class::QUOTE:
+      return lox_string();
+    case lox_char_class::Char_Class::DIGIT:
+      return lox_number();
+    case lox_char_class::Char_Class::ALPHA:
+      return lox_identifier();
+    case lox_char_class::Char_Class::INVALID:
+      // Reported once the character is scanned for the last time.
+      if (!reaches_end(current + 1)) {
         error_reporting.error(line, "Unexpected character.");
       }
-      return;
+      return false;
   }
+
+  return false;
 }
 
-void Scanner::lox_identifier() {
-  while (is_alpha_numeric(peek())) {
-    advance();
+// Skips whitespace up to the next character that isn't whitespace.
+void Scanner::skip_whitespace() {
+  uint64_t newlines = 0;
+  current += kernels.skip_whitespace(source.data() + current,
+                                     source.length() - current, newlines);
+  line += newlines;
+}
+
+// Skips the rest of a comment, up to but not including the newline.
+void Scanner::skip_comment() {
+  current += kernels.find_newline(source.data() + current,
+                                  source.length() - current);
+}
+
+bool Scanner::lox_identifier() {
+  current += kernels.skip_identifier(source.data() + current,
+                                     source.length() - current);
+  // Classify the lexeme in place; any lexeme that isn't a keyword is an
+  // identifier.
+  std::string_view lexeme = source.substr(start, (current - start));
+  Token_Type type = keyword_or_identifier(lexeme);
+  if (type != Token_Type::TT_IDENTIFIER) {
+    return add_token(type);
   }
-  std::string text = source.substr(start, (current - start));
-  Token_Type* type = lox_keywords->search(text);
-  if (type == nullptr) {
-    *type = Token_Type::TT_IDENTIFIER;
+
+  return add_token(type, symbol(lexeme));
+}
+
+// Returns the symbol of text, or 0 for a token cut off by the end of the
+// window, which is scanned again with the next piece; interning the part seen
+// so far would make a symbol for a name that doesn't exist.
+uint32_t Scanner::symbol(std::string_view text) {
+  if (reaches_end(current + 1)) {
+    return 0;
   }
-  add_token(*type);
+
+  return symbols.intern(text);
 }
 
-void Scanner::lox_number() {
-  while (is_digit(peek())) {
-    advance();
+bool Scanner::lox_number() {
+  // The integer part is accumulated while it is scanned, so that the common
+  // case of a small integer needs no parsing afterwards. The first digit was
+  // consumed by scan_token.
+  uint64_t integer = source[start] - '0';
+  uint64_t digits = 1;
+  while (lox_char_class::is_digit(peek())) {
+    integer = (integer * 10) + (advance() - '0');
+    digits++;
   }
 
   // Look for the fractional part.
-  if ((peek() == '.') && (is_digit(peek_next()))) {
+  bool fractional = false;
+  if ((peek() == '.') && (lox_char_class::is_digit(peek_next()))) {
     // Consume the ".".
     advance();
 
-    while (is_digit(peek())) {
+    while (lox_char_class::is_digit(peek())) {
       advance();
     }
+    fractional = true;
   }
 
-  add_token(Token_Type::TT_NUMBER,
-            std::stod(source.substr(start, (current - start))));
-}
-
-void Scanner::lox_string() {
-  while ((peek() != '"') && (!is_at_end())) {
-    // Lox supports multiline strings but doesn't support escape sequences which
-    // is why this logic works.
-    if (peek() == '\n') {
-      line++;
-    }
-
-    advance();
+  // Up to 19 digits can't overflow the accumulator, and integers up to 2^53
+  // are exactly representable as doubles.
+  double value;
+  if (!fractional && (digits <= 19) && (integer <= MAX_EXACT_INTEGER)) {
+    value = (double)integer;
+  } else {
+    value = parse_number(source.substr(start, (current - start)));
   }
 
-  if (is_at_end()) {
-    error_reporting.error(line, "Unterminated string.");
-    return;
-  }
+  return add_token(Token_Type::TT_NUMBER, literals.add_number(value));
+}
 
-  // The closing ".
-  advance();
+double Scanner::parse_number(std::string_view lexeme) {
+  // from_chars parses the lexeme where it is, rounds correctly and, unlike
+  // std::stod, doesn't depend on the locale.
+  double value = 0;
+  std::from_chars_result result =
+      std::from_chars(lexeme.data(), lexeme.data() + lexeme.size(), value);
+
+  if (result.ec == std::errc::result_out_of_range) {
+    // Lox numbers have no exponent, so a number out of range is either too
+    // large, if its integer part isn't 0, or too small. Like Java's
+    // Double.parseDouble, those round to infinity and to 0.
+    bool zero_integer =
+        lexeme.substr(0, lexeme.find('.')).find_first_not_of('0') ==
+        std::string_view::npos;
+    value = zero_integer ? 0.0 : std::numeric_limits<double>::infinity();
+  }
 
-  // Trim the surrounding quotes and add a string token.
-  std::string value = source.substr((start + 1), (current - start - 2));
-  add_token(Token_Type::TT_STRING, value);
+  return value;
 }
 
-/* A conditional advance; only advance current if the current character is the
-expected character. */
-bool Scanner::match(char expected) {
+bool Scanner::lox_string() {
+  // Lox supports multiline strings but doesn't support escape sequences, so
+  // the string ends at the next quote.
+  uint64_t newlines = 0;
+  current += kernels.find_quote(source.data() + current,
+                                source.length() - current, newlines);
+  line += newlines;
+
   if (is_at_end()) {
+    // The rest of the string may be in the next piece.
+    if (!more_input) {
+      error_reporting.error(line, "Unterminated string.");
+    }
     return false;
   }
 
-  if (source[current] != expected) {
-    return false;
-  }
+  // The closing ".
+  advance();
 
-  current++;
-  return true;
+  // The value of a string is its lexeme without the surrounding quotes.
+  return add_token(Token_Type::TT_STRING,
+                   symbol(source.substr(start + 1, (current - start) - 2)));
 }
 
 char Scanner::peek() {
@@ -233,11 +318,22 @@ char Scanner::peek_next() {
   return source[current + 1];
 }
 
-bool Scanner::is_alpha(char c) {
-  return (((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
-          (c == '_'));
+Scanner::Iterator::Iterator(Scanner& scanner) {
+  this->scanner = &scanner;
+  this->valid = scanner.next_token(this->token);
+}
+
+const Token& Scanner::Iterator::operator*() const { return this->token; }
+
+const Token* Scanner::Iterator::operator->() const { return &(this->token); }
+
+Scanner::Iterator& Scanner::Iterator::operator++() {
+  this->valid = this->scanner->next_token(this->token);
+  return *this;
 }
 
-bool Scanner::is_alpha_numeric(char c) { return (is_alpha(c) || is_digit(c)); }
+void Scanner::Iterator::operator++(int) { ++(*this); }
 
-bool Scanner::is_digit(char c) { return ((c >= '0') && (c <= '9')); }
+bool Scanner::Iterator::operator==(std::default_sentinel_t) const {
+  return !(this->valid);
+}
@@ -0,0 +1,142 @@
+#include "source_file/source_file.hpp"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+static void check_length(std::size_t length) {
+  if (length > UINT32_MAX) {
+    throw std::length_error("Source files are limited to 4 GiB.");
+  }
+}
+
+Source_File::Source_File(std::string contents, std::string name) {
+  check_length(contents.size());
+
+  std::shared_ptr<buffer> b = std::make_shared<buffer>();
+  b->name = std::move(name);
+  b->owned = std::move(contents);
+  b->contents = b->owned;
+  this->data = std::move(b);
+}
+
+Source_File::Source_File(std::shared_ptr<const buffer> data) {
+  this->data = std::move(data);
+}
+
+Source_File::buffer::~buffer() {
+  if (this->mapping != nullptr) {
+    munmap(this->mapping, this->mapping_length);
+  }
+}
+
+// Closes a file descriptor when it goes out of scope.
+class File_Descriptor {
+ public:
+  explicit File_Descriptor(int fd) : fd(fd) {}
+  File_Descriptor(const File_Descriptor&) = delete;
+  File_Descriptor& operator=(const File_Descriptor&) = delete;
+  ~File_Descriptor() {
+    if (this->fd >= 0) {
+      close(this->fd);
+    }
+  }
+
+  int get() const { return this->fd; }
+
+ private:
+  int fd;
+};
+
+Source_File Source_File::open(const std::string& path) {
+  File_Descriptor fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC));
+  if (fd.get() < 0) {
+    throw std::system_error(errno, std::generic_category(), path);
+  }
+
+  struct stat status;
+  if (fstat(fd.get(), &status) != 0) {
+    throw std::system_error(errno, std::generic_category(), path);
+  }
+
+  std::shared_ptr<buffer> b = std::make_shared<buffer>();
+  b->name = path;
+
+  // Map regular files; the mapping stays valid after the descriptor is closed.
+  // Empty files can't be mapped and need no buffer.
+  if (S_ISREG(status.st_mode) && (status.st_size > 0)) {
+    check_length((std::size_t)status.st_size);
+    void* mapping = mmap(nullptr, (std::size_t)status.st_size, PROT_READ,
+                         MAP_PRIVATE, fd.get(), 0);
+    if (mapping != MAP_FAILED) {
+      // The scanner reads the file front to back once.
+      madvise(mapping, (std::size_t)status.st_size, MADV_SEQUENTIAL);
+      b->mapping = mapping;
+      b->mapping_length = (std::size_t)status.st_size;
+      b->contents = std::string_view((const char*)mapping, b->mapping_length);
+      return Source_File(std::move(b));
+    }
+  }
+
+  // Pipes, terminals and files that can't be mapped are read into one buffer,
+  // sized up front when the size is known and doubled when it runs out.
+  std::string& contents = b->owned;
+  contents.resize((status.st_size > 0) ? ((std::size_t)status.st_size + 1)
+                                       : (std::size_t)65536);
+  std::size_t length = 0;
+  while (true) {
+    if (length == contents.size()) {
+      contents.resize(contents.size() * 2);
+    }
+
+    ssize_t count = read(fd.get(), contents.data() + length,
+                         contents.size() - length);
+    if (count == 0) {
+      break;
+    }
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(), path);
+    }
+
+    length += (std::size_t)count;
+    check_length(length);
+  }
+  contents.resize(length);
+  b->contents = contents;
+
+  return Source_File(std::move(b));
+}
+
+std::string_view Source_File::get_contents() const {
+  return this->data->contents;
+}
+
+const std::string& Source_File::get_name() const { return this->data->name; }
+
+uint64_t Source_File::get_line(uint32_t offset) const {
+  const buffer& b = *(this->data);
+
+  std::call_once(b.line_starts_built, [&b]() {
+    b.line_starts.push_back(0);
+    for (std::size_t i = 0; i < b.contents.size(); i++) {
+      if (b.contents[i] == '\n') {
+        b.line_starts.push_back((uint32_t)(i + 1));
+      }
+    }
+  });
+
+  // The line is the number of line starts at or before the offset.
+  return (uint64_t)(std::upper_bound(b.line_starts.begin(),
+                                     b.line_starts.end(), offset) -
+                    b.line_starts.begin());
+}
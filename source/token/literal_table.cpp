@@ -0,0 +1,23 @@
+#include "token/literal_table.hpp"
+
+Literal_Table::Literal_Table(std::pmr::memory_resource* resource)
+    : values(resource) {}
+
+uint32_t Literal_Table::add_number(double value) {
+  this->values.push_back(Value::number(value));
+  return (uint32_t)this->values.get_maximum_index();
+}
+
+double Literal_Table::get_number(uint32_t index) const {
+  return this->values[index].get_number();
+}
+
+Value Literal_Table::get(uint32_t index) const { return this->values[index]; }
+
+std::size_t Literal_Table::get_size() const {
+  return this->values.get_maximum_index() + 1;
+}
+
+void Literal_Table::clear() {
+  this->values = lox_pmr::Dynamic_Array<Value>(this->values.get_allocator());
+}
@@ -0,0 +1,159 @@
+#include "token/string_interner.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <utility>
+
+String_Interner::String_Interner(std::pmr::memory_resource* resource)
+    : allocator(resource), symbols(resource), ids(resource), blocks(resource) {
+  this->position = nullptr;
+  this->remaining = 0;
+}
+
+String_Interner::String_Interner(const String_Interner& src)
+    : String_Interner(src.allocator.resource()) {
+  intern_all(src);
+}
+
+String_Interner::String_Interner(String_Interner&& src) noexcept
+    : allocator(src.allocator),
+      symbols(std::move(src.symbols)),
+      ids(std::move(src.ids)),
+      blocks(std::move(src.blocks)) {
+  this->position = src.position;
+  this->remaining = src.remaining;
+
+  // The blocks now belong to this interner.
+  src.position = nullptr;
+  src.remaining = 0;
+}
+
+String_Interner::~String_Interner() { release_blocks(); }
+
+String_Interner& String_Interner::operator=(const String_Interner& src) {
+  if (this != &src) {
+    String_Interner copy(src.allocator.resource());
+    copy.intern_all(src);
+    *this = std::move(copy);
+  }
+
+  return *this;
+}
+
+String_Interner& String_Interner::operator=(String_Interner&& src) {
+  if (this == &src) {
+    return *this;
+  }
+
+  // The blocks can only be taken over if this' allocator can free them;
+  // otherwise the texts are interned again into blocks of this' own.
+  if (this->allocator != src.allocator) {
+    clear();
+    intern_all(src);
+    src.clear();
+    return *this;
+  }
+
+  release_blocks();
+  this->symbols = std::move(src.symbols);
+  this->ids = std::move(src.ids);
+  this->blocks = std::move(src.blocks);
+  this->position = src.position;
+  this->remaining = src.remaining;
+
+  src.position = nullptr;
+  src.remaining = 0;
+  return *this;
+}
+
+uint64_t String_Interner::hash(std::string_view text) {
+  return std::hash<std::string_view>{}(text);
+}
+
+uint32_t String_Interner::intern(std::string_view text) {
+  return intern(text, hash(text));
+}
+
+uint32_t String_Interner::intern(std::string_view text, uint64_t hash) {
+  const uint32_t* existing = this->ids.search(Interned_Text{text, hash});
+  if (existing != nullptr) {
+    return *existing;
+  }
+
+  // Only new texts are copied, and the table's key refers to the copy.
+  uint32_t symbol = (uint32_t)(this->symbols.get_maximum_index() + 1);
+  Interned_Text stored{store(text), hash};
+  this->symbols.push_back(stored);
+  this->ids.insert(stored, symbol);
+  return symbol;
+}
+
+std::string_view String_Interner::get_string(uint32_t symbol) const {
+  return this->symbols[symbol].text;
+}
+
+uint64_t String_Interner::get_hash(uint32_t symbol) const {
+  return this->symbols[symbol].hash;
+}
+
+std::size_t String_Interner::get_size() const {
+  return this->symbols.get_maximum_index() + 1;
+}
+
+void String_Interner::clear() {
+  release_blocks();
+  this->symbols = lox_pmr::Dynamic_Array<Interned_Text>(this->allocator);
+  this->ids = lox_pmr::Hash_Table<Interned_Text, uint32_t>(this->allocator);
+  this->blocks = lox_pmr::Dynamic_Array<text_block>(this->allocator);
+}
+
+std::string_view String_Interner::store(std::string_view text) {
+  if (text.empty()) {
+    return std::string_view();
+  }
+
+  // A text longer than a block gets a block of its own, and the newest
+  // block's unused bytes are kept for the texts after it.
+  bool own_block = text.length() > BLOCK_SIZE;
+  if (own_block || (text.length() > this->remaining)) {
+    text_block block;
+    block.size = std::max(BLOCK_SIZE, text.length());
+    block.bytes = this->allocator.allocate(block.size);
+    try {
+      this->blocks.push_back(block);
+    } catch (...) {
+      this->allocator.deallocate(block.bytes, block.size);
+      throw;
+    }
+
+    if (own_block) {
+      std::memcpy(block.bytes, text.data(), text.length());
+      return std::string_view(block.bytes, text.length());
+    }
+
+    this->position = block.bytes;
+    this->remaining = block.size;
+  }
+
+  char* copy = this->position;
+  std::memcpy(copy, text.data(), text.length());
+  this->position += text.length();
+  this->remaining -= text.length();
+  return std::string_view(copy, text.length());
+}
+
+void String_Interner::intern_all(const String_Interner& src) {
+  for (int i = 0; i <= src.symbols.get_maximum_index(); i++) {
+    intern(src.symbols[i].text, src.symbols[i].hash);
+  }
+}
+
+void String_Interner::release_blocks() {
+  for (const text_block& block : this->blocks) {
+    this->allocator.deallocate(block.bytes, block.size);
+  }
+  this->blocks = lox_pmr::Dynamic_Array<text_block>(this->allocator);
+  this->position = nullptr;
+  this->remaining = 0;
+}
@@ -0,0 +1,312 @@
+#include "token/token_cache.hpp"
+
+#include <unistd.h>
+
+#include <bit>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+
+#include "token/string_interner.hpp"
+
+// The size of the fixed part of a cache file, before the tokens.
+static constexpr std::size_t HEADER_SIZE = 64;
+
+// The size of a token record.
+static constexpr std::size_t RECORD_SIZE = 16;
+
+// The size of a symbol record.
+static constexpr std::size_t SYMBOL_RECORD_SIZE = 16;
+
+// The number of token types; TT_EOF is the last one.
+static constexpr uint32_t TOKEN_TYPES = (uint32_t)Token_Type::TT_EOF + 1;
+
+static constexpr bool LITTLE_ENDIAN_HOST =
+    (std::endian::native == std::endian::little);
+
+// Identifies how String_Interner hashes, which may differ between builds.
+static uint32_t symbol_check() {
+  return (uint32_t)String_Interner::hash("LXTC");
+}
+
+static void put_u32(char* bytes, uint32_t value) {
+  for (int i = 0; i < 4; i++) {
+    bytes[i] = (char)(value >> (8 * i));
+  }
+}
+
+static void put_u64(char* bytes, uint64_t value) {
+  for (int i = 0; i < 8; i++) {
+    bytes[i] = (char)(value >> (8 * i));
+  }
+}
+
+static uint32_t get_u32(const char* bytes) {
+  uint32_t value = 0;
+  for (int i = 0; i < 4; i++) {
+    value |= (uint32_t)(unsigned char)bytes[i] << (8 * i);
+  }
+  return value;
+}
+
+static uint64_t get_u64(const char* bytes) {
+  return (uint64_t)get_u32(bytes) | ((uint64_t)get_u32(bytes + 4) << 32);
+}
+
+constexpr bool Token_Cache::layout_matches() {
+  return (sizeof(Token) == RECORD_SIZE) && (offsetof(Token, type) == 0) &&
+         (offsetof(Token, offset) == 4) && (offsetof(Token, length) == 8) &&
+         (offsetof(Token, literal) == 12) && (sizeof(Token_Type) == 1);
+}
+
+uint64_t Token_Cache::content_hash(std::string_view text) {
+  // Mixes in eight bytes at a time; the multiply and rotate spread every input
+  // bit over the whole state.
+  const uint64_t MULTIPLIER = 0x9E3779B97F4A7C15ULL;
+  uint64_t hash = 0x6A09E667F3BCC909ULL ^ text.length();
+
+  std::size_t i = 0;
+  for (; (i + 8) <= text.length(); i += 8) {
+    uint64_t word;
+    std::memcpy(&word, text.data() + i, 8);
+    hash = std::rotl((hash ^ word) * MULTIPLIER, 29);
+  }
+
+  uint64_t tail = 0;
+  std::memcpy(&tail, text.data() + i, text.length() - i);
+  hash = std::rotl((hash ^ tail) * MULTIPLIER, 29);
+
+  // Finalize so that the low bits depend on the high ones too.
+  hash ^= hash >> 32;
+  hash *= MULTIPLIER;
+  hash ^= hash >> 29;
+  return hash;
+}
+
+std::string Token_Cache::path_for(const Source_File& source,
+                                  const std::string& directory) {
+  if (directory.empty()) {
+    return source.get_name() + ".lxtc";
+  }
+
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.lxtc",
+                (unsigned long long)content_hash(source.get_contents()));
+  return directory + "/" + name;
+}
+
+void Token_Cache::store(const std::string& path, const Source_File& source,
+                        Token_Array& tokens, const Literal_Table& literals,
+                        const Symbol_Table& symbols) {
+  if constexpr (!LITTLE_ENDIAN_HOST || !layout_matches()) {
+    return;
+  }
+
+  std::string_view text = source.get_contents();
+  std::size_t token_count = tokens.get_maximum_index() + 1;
+  std::size_t number_count = literals.get_size();
+  std::size_t symbol_count = symbols.get_size();
+
+  std::size_t symbol_bytes = 0;
+  for (std::size_t i = 0; i < symbol_count; i++) {
+    symbol_bytes += symbols.get_string((uint32_t)i).length();
+  }
+
+  char header[HEADER_SIZE] = {};
+  std::memcpy(header, "LXTC", 4);
+  put_u32(header + 4, FORMAT_VERSION);
+  put_u32(header + 8, TOKEN_TYPES);
+  put_u32(header + 12, symbol_check());
+  put_u64(header + 16, content_hash(text));
+  put_u64(header + 24, text.length());
+  put_u64(header + 32, token_count);
+  put_u64(header + 40, number_count);
+  put_u64(header + 48, symbol_count);
+  put_u64(header + 56, symbol_bytes);
+
+  // Write a temporary file and rename it over the cache file, so that readers
+  // never see a partly written cache.
+  std::string temporary_path = path + ".tmp" + std::to_string(getpid());
+  std::ofstream file(temporary_path, std::ios::binary | std::ios::trunc);
+  file.write(header, HEADER_SIZE);
+
+  // Tokens are written in blocks with their padding bytes zeroed, so that the
+  // same tokens always give the same file. A block is 4 KiB, small enough for
+  // the stack.
+  const std::size_t BLOCK = 256;
+  char records[BLOCK * RECORD_SIZE];
+  for (std::size_t first = 0; first < token_count; first += BLOCK) {
+    std::size_t count = std::min(BLOCK, token_count - first);
+    std::memcpy(records, tokens.begin() + first, count * RECORD_SIZE);
+    for (std::size_t i = 0; i < count; i++) {
+      std::memset(records + (i * RECORD_SIZE) + 1, 0, 3);
+    }
+    file.write(records, count * RECORD_SIZE);
+  }
+
+  for (std::size_t i = 0; i < number_count; i++) {
+    char number[8];
+    put_u64(number, std::bit_cast<uint64_t>(literals.get_number((uint32_t)i)));
+    file.write(number, sizeof(number));
+  }
+
+  std::size_t symbol_offset = 0;
+  for (std::size_t i = 0; i < symbol_count; i++) {
+    char record[SYMBOL_RECORD_SIZE];
+    std::string_view symbol = symbols.get_string((uint32_t)i);
+    put_u64(record, symbols.get_hash((uint32_t)i));
+    put_u32(record + 8, (uint32_t)symbol_offset);
+    put_u32(record + 12, (uint32_t)symbol.length());
+    file.write(record, sizeof(record));
+    symbol_offset += symbol.length();
+  }
+
+  for (std::size_t i = 0; i < symbol_count; i++) {
+    std::string_view symbol = symbols.get_string((uint32_t)i);
+    file.write(symbol.data(), symbol.length());
+  }
+
+  // A failed stream doesn't say why, and errno may be left over from
+  // something else, so the error is only reported as an I/O error.
+  file.close();
+  if (!file) {
+    std::remove(temporary_path.c_str());
+    throw std::system_error(std::make_error_code(std::errc::io_error),
+                            temporary_path);
+  }
+
+  if (std::rename(temporary_path.c_str(), path.c_str()) != 0) {
+    int error = errno;
+    std::remove(temporary_path.c_str());
+    throw std::system_error(error, std::generic_category(), path);
+  }
+}
+
+bool Token_Cache::load(const std::string& path, const Source_File& source) {
+  if constexpr (!LITTLE_ENDIAN_HOST || !layout_matches()) {
+    return false;
+  }
+
+  try {
+    this->file = Source_File::open(path);
+  } catch (const std::system_error&) {
+    return false;
+  } catch (const std::length_error&) {
+    return false;
+  }
+
+  std::string_view bytes = this->file.get_contents();
+  std::string_view text = source.get_contents();
+  if ((bytes.length() < HEADER_SIZE) ||
+      (std::memcmp(bytes.data(), "LXTC", 4) != 0) ||
+      (get_u32(bytes.data() + 4) != FORMAT_VERSION) ||
+      (get_u32(bytes.data() + 8) != TOKEN_TYPES) ||
+      (get_u32(bytes.data() + 12) != symbol_check()) ||
+      (get_u64(bytes.data() + 24) != text.length()) ||
+      (get_u64(bytes.data() + 16) != content_hash(text))) {
+    return false;
+  }
+
+  // The file must be exactly as long as its counts say.
+  uint64_t token_count = get_u64(bytes.data() + 32);
+  uint64_t number_count = get_u64(bytes.data() + 40);
+  uint64_t symbol_count = get_u64(bytes.data() + 48);
+  uint64_t symbol_bytes = get_u64(bytes.data() + 56);
+  if ((token_count == 0) || (token_count > (bytes.length() / RECORD_SIZE)) ||
+      (number_count > (bytes.length() / 8)) ||
+      (symbol_count > (bytes.length() / SYMBOL_RECORD_SIZE)) ||
+      (symbol_bytes > bytes.length()) ||
+      (bytes.length() != (HEADER_SIZE + (token_count * RECORD_SIZE) +
+                          (number_count * 8) +
+                          (symbol_count * SYMBOL_RECORD_SIZE) +
+                          symbol_bytes))) {
+    return false;
+  }
+
+  this->tokens = reinterpret_cast<const Token*>(bytes.data() + HEADER_SIZE);
+  this->token_count = token_count;
+  if (this->tokens[token_count - 1].get_type() != Token_Type::TT_EOF) {
+    return false;
+  }
+
+  const char* numbers =
+      bytes.data() + HEADER_SIZE + (token_count * RECORD_SIZE);
+  this->literals.clear();
+  for (uint64_t i = 0; i < number_count; i++) {
+    this->literals.add_number(
+        std::bit_cast<double>(get_u64(numbers + (i * 8))));
+  }
+
+  // The symbol table is used where it is; its texts must lie within the
+  // file.
+  this->symbols.records = numbers + (number_count * 8);
+  this->symbols.count = symbol_count;
+  this->symbols.texts = std::string_view(
+      this->symbols.records + (symbol_count * SYMBOL_RECORD_SIZE),
+      symbol_bytes);
+  for (std::size_t i = 0; i < symbol_count; i++) {
+    const char* record = this->symbols.records + (i * SYMBOL_RECORD_SIZE);
+    if (((uint64_t)get_u32(record + 8) + get_u32(record + 12)) >
+        symbol_bytes) {
+      return false;
+    }
+  }
+
+  // Every token must lie within the source and every literal index within
+  // its table, so that a damaged file is a miss rather than a crash later.
+  for (std::size_t i = 0; i < token_count; i++) {
+    const Token& token = this->tokens[i];
+    if (((uint32_t)token.get_type() >= TOKEN_TYPES) ||
+        (((uint64_t)token.get_offset() + token.get_length()) >
+         text.length())) {
+      return false;
+    }
+
+    switch (token.get_type()) {
+      case Token_Type::TT_NUMBER:
+        if (token.get_literal() >= number_count) {
+          return false;
+        }
+        break;
+      case Token_Type::TT_STRING:
+      case Token_Type::TT_IDENTIFIER:
+        if (token.get_literal() >= symbol_count) {
+          return false;
+        }
+        break;
+      default:
+        break;
+    }
+  }
+
+  return true;
+}
+
+const Token* Token_Cache::begin() const { return this->tokens; }
+
+const Token* Token_Cache::end() const {
+  return this->tokens + this->token_count;
+}
+
+const Literal_Table& Token_Cache::get_literals() const {
+  return this->literals;
+}
+
+const Symbol_Table& Token_Cache::get_symbols() const { return this->symbols; }
+
+std::string_view Token_Cache::Mapped_Symbols::get_string(
+    uint32_t symbol) const {
+  const char* record = this->records + (symbol * SYMBOL_RECORD_SIZE);
+  return this->texts.substr(get_u32(record + 8), get_u32(record + 12));
+}
+
+uint64_t Token_Cache::Mapped_Symbols::get_hash(uint32_t symbol) const {
+  return get_u64(this->records + (symbol * SYMBOL_RECORD_SIZE));
+}
+
+std::size_t Token_Cache::Mapped_Symbols::get_size() const {
+  return this->count;
+}
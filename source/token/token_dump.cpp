@@ -0,0 +1,107 @@
+#include "token/token_dump.hpp"
+
+#include <errno.h>
+#include <unistd.h>
+
+#include <bit>
+#include <cstring>
+#include <system_error>
+
+Token_Dump::Token_Dump(int fd, Format format)
+    : buffer(std::make_unique<char[]>(BUFFER_SIZE)) {
+  this->fd = fd;
+  this->format = format;
+  this->used = 0;
+
+  if (this->format == Format::BINARY) {
+    append(std::string_view("LXTK\x01", 5));
+  }
+}
+
+Token_Dump::~Token_Dump() {
+  try {
+    flush();
+  } catch (const std::system_error&) {
+  }
+}
+
+void Token_Dump::write(const Token& token, std::string_view source,
+                       const Literal_Table& literals) {
+  std::string_view lexeme = token.get_lexeme(source);
+
+  if (this->format == Format::TEXT) {
+    append("type: ");
+    append(token_type_to_str(token.get_type()));
+    append(" lexeme: ");
+    append(lexeme);
+    append("\n");
+    return;
+  }
+
+  char type = (char)token.get_type();
+  append(&type, 1);
+  append_u32(token.get_offset());
+  append_u32(token.get_length());
+  append(lexeme);
+  if (token.get_type() == Token_Type::TT_NUMBER) {
+    append_f64(literals.get_number(token.get_literal()));
+  }
+}
+
+void Token_Dump::flush() {
+  std::size_t count = this->used;
+  this->used = 0;
+  write_all(this->buffer.get(), count);
+}
+
+void Token_Dump::append(const char* bytes, std::size_t count) {
+  if ((this->used + count) > BUFFER_SIZE) {
+    flush();
+
+    // Too big to buffer, e.g. a long string literal.
+    if (count > BUFFER_SIZE) {
+      write_all(bytes, count);
+      return;
+    }
+  }
+
+  std::memcpy(this->buffer.get() + this->used, bytes, count);
+  this->used += count;
+}
+
+void Token_Dump::append(std::string_view text) {
+  append(text.data(), text.length());
+}
+
+void Token_Dump::append_u32(uint32_t value) {
+  char bytes[4];
+  for (int i = 0; i < 4; i++) {
+    bytes[i] = (char)(value >> (8 * i));
+  }
+  append(bytes, sizeof(bytes));
+}
+
+void Token_Dump::append_f64(double value) {
+  uint64_t bits = std::bit_cast<uint64_t>(value);
+  char bytes[8];
+  for (int i = 0; i < 8; i++) {
+    bytes[i] = (char)(bits >> (8 * i));
+  }
+  append(bytes, sizeof(bytes));
+}
+
+void Token_Dump::write_all(const char* bytes, std::size_t count) {
+  while (count > 0) {
+    ssize_t written = ::write(this->fd, bytes, count);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(),
+                              "Could not write tokens");
+    }
+
+    bytes += written;
+    count -= (std::size_t)written;
+  }
+}
@@ -0,0 +1,92 @@
+#include "vm/chunk.hpp"
+
+std::string_view op_code_to_str(Op_Code op) {
+#define OP(name, format, effect) \
+  case (Op_Code::name):          \
+    return std::string_view(#name);
+
+  switch (op) { LOX_OP_CODES(OP) }
+
+#undef OP
+
+  return std::string_view("");
+}
+
+Operand_Format op_code_format(Op_Code op) {
+#define OP(name, format, effect) \
+  case (Op_Code::name):          \
+    return Operand_Format::format;
+
+  switch (op) { LOX_OP_CODES(OP) }
+
+#undef OP
+
+  return Operand_Format::SIMPLE;
+}
+
+int op_code_stack_effect(Op_Code op) {
+#define OP(name, format, effect) \
+  case (Op_Code::name):          \
+    return effect;
+
+  switch (op) { LOX_OP_CODES(OP) }
+
+#undef OP
+
+  return 0;
+}
+
+void Chunk::write(uint8_t byte, uint32_t line) {
+  int last = this->lines.get_maximum_index();
+  if ((last < 0) || (this->lines[last].line != line)) {
+    this->lines.push_back(
+        line_run{(uint32_t)(this->code.get_maximum_index() + 1), line});
+  }
+
+  this->code.push_back(byte);
+}
+
+void Chunk::patch(std::size_t offset, uint8_t byte) {
+  this->code.replace(byte, (int)offset);
+}
+
+std::size_t Chunk::add_constant(Value value) {
+  this->constants.push_back(value);
+  return this->constants.get_maximum_index();
+}
+
+std::size_t Chunk::get_size() const {
+  return this->code.get_maximum_index() + 1;
+}
+
+uint8_t Chunk::get_byte(std::size_t offset) const {
+  return this->code[(int)offset];
+}
+
+uint8_t* Chunk::get_code() { return this->code.begin(); }
+
+std::size_t Chunk::get_constant_count() const {
+  return this->constants.get_maximum_index() + 1;
+}
+
+Value Chunk::get_constant(std::size_t index) const {
+  return this->constants[(int)index];
+}
+
+Value* Chunk::get_constants() { return this->constants.begin(); }
+
+uint32_t Chunk::get_line(std::size_t offset) const {
+  // The last run starting at or before offset.
+  int low = 0;
+  int high = this->lines.get_maximum_index();
+  while (low < high) {
+    int middle = low + ((high - low + 1) / 2);
+    if (this->lines[middle].start <= offset) {
+      low = middle;
+    } else {
+      high = middle - 1;
+    }
+  }
+
+  return (high < 0) ? 0 : this->lines[low].line;
+}
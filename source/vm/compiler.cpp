@@ -0,0 +1,812 @@
+#include "vm/compiler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <memory>
+#include <span>
+#include <string>
+
+Compiler::Compiler(VM& vm, const Source_File& source, const Ast& ast,
+                   const Literal_Table& literals,
+                   const Symbol_Table& symbols, Error_Reporter& e)
+    : vm(vm),
+      source(source),
+      ast(ast),
+      literals(literals),
+      symbols(symbols),
+      e(e) {}
+
+Obj_Function* Compiler::compile() {
+  std::size_t symbol_count = this->symbols.get_size();
+  if (symbol_count > 0) {
+    std::fill_n(this->strings.append_for_overwrite(symbol_count), symbol_count,
+                nullptr);
+    std::fill_n(this->global_slots.append_for_overwrite(symbol_count),
+                symbol_count, UINT32_MAX);
+  }
+
+  auto script = std::make_unique<function_state>();
+  begin_function(*script, Function_Type::FT_SCRIPT, NO_NAME);
+
+  if (this->ast.get_root() != Ast::NO_NODE) {
+    const Ast_Node& program = this->ast.get(this->ast.get_root());
+    for (Node_Id id : this->ast.get_list(program.a)) {
+      statement(id);
+    }
+  }
+
+  // The script's implicit return is at the end of the source.
+  this->line = (uint32_t)this->source.get_line(
+      (uint32_t)this->source.get_contents().length());
+  Obj_Function* function = end_function();
+  return this->had_error ? nullptr : function;
+}
+
+void Compiler::begin_function(function_state& state, Function_Type type,
+                              uint32_t name) {
+  state.enclosing = this->current;
+  state.function = this->vm.new_function();
+  state.type = type;
+  state.local_count = 0;
+  state.scope_depth = 0;
+  state.stack_height = 0;
+  this->current = &state;
+
+  if (type != Function_Type::FT_SCRIPT) {
+    state.function->name = string(name);
+  }
+
+  // Slot 0 holds the callee, which methods see as "this".
+  local& slot = state.locals[state.local_count++];
+  slot.depth = 0;
+  slot.is_captured = false;
+  slot.name = ((type == Function_Type::FT_METHOD) ||
+               (type == Function_Type::FT_INITIALIZER))
+                  ? THIS_NAME
+                  : NO_NAME;
+  adjust_stack(1);
+}
+
+Obj_Function* Compiler::end_function() {
+  emit_return();
+
+  Obj_Function* function = this->current->function;
+  this->current = this->current->enclosing;
+  return function;
+}
+
+/*******************************************************************************
+STATEMENTS
+*******************************************************************************/
+void Compiler::statement(Node_Id id) {
+  const Ast_Node& node = this->ast.get(id);
+  uint32_t enclosing_line = this->line;
+  this->line = line_of(node);
+
+  switch (node.kind) {
+    case Node_Kind::NK_EXPRESSION:
+      expression(node.a);
+      emit_op(Op_Code::OP_POP);
+      break;
+    case Node_Kind::NK_PRINT:
+      expression(node.a);
+      emit_op(Op_Code::OP_PRINT);
+      break;
+    case Node_Kind::NK_VAR:
+      var_declaration(node);
+      break;
+    case Node_Kind::NK_BLOCK:
+      begin_scope();
+      block(node.a);
+      end_scope();
+      break;
+    case Node_Kind::NK_IF:
+      if_statement(node);
+      break;
+    case Node_Kind::NK_WHILE:
+      while_statement(node);
+      break;
+    case Node_Kind::NK_FUNCTION:
+      function_declaration(node);
+      break;
+    case Node_Kind::NK_RETURN:
+      return_statement(node);
+      break;
+    case Node_Kind::NK_CLASS:
+      class_declaration(node);
+      break;
+    default:
+      break;
+  }
+
+  this->line = enclosing_line;
+}
+
+void Compiler::block(uint32_t list) {
+  for (Node_Id id : this->ast.get_list(list)) {
+    statement(id);
+  }
+}
+
+void Compiler::var_declaration(const Ast_Node& node) {
+  uint32_t global = 0;
+  if (this->current->scope_depth > 0) {
+    declare_variable(node.a, node);
+  } else {
+    global = this->global(node.a, node);
+  }
+
+  if (node.b != Ast::NO_NODE) {
+    expression(node.b);
+  } else {
+    emit_op(Op_Code::OP_NIL);
+  }
+
+  define_variable(global);
+}
+
+void Compiler::function_declaration(const Ast_Node& node) {
+  uint32_t global = 0;
+  if (this->current->scope_depth > 0) {
+    // A local function can refer to itself, so it is usable right away.
+    declare_variable(node.a, node);
+    mark_initialized();
+  } else {
+    global = this->global(node.a, node);
+  }
+
+  function(node, Function_Type::FT_FUNCTION);
+  define_variable(global);
+}
+
+void Compiler::function(const Ast_Node& node, Function_Type type) {
+  // Function states are large and functions can nest deeply, so they live on
+  // the heap.
+  auto state = std::make_unique<function_state>();
+  begin_function(*state, type, node.a);
+  begin_scope();
+
+  for (uint32_t parameter : this->ast.get_list(node.b)) {
+    state->function->arity++;
+    declare_variable(parameter, node);
+    mark_initialized();
+    adjust_stack(1);
+  }
+
+  block(node.c);
+
+  // The function's locals are discarded with its frame, so its scope isn't
+  // ended.
+  Obj_Function* function = end_function();
+
+  emit_op_short(Op_Code::OP_CLOSURE,
+                make_constant(Value::object(function), node));
+  for (uint32_t i = 0; i < function->upvalue_count; i++) {
+    emit_byte(state->upvalues[i].is_local ? 1 : 0);
+    emit_byte(state->upvalues[i].index);
+  }
+}
+
+void Compiler::class_declaration(const Ast_Node& node) {
+  uint16_t name = make_constant(Value::object(string(node.a)), node);
+
+  uint32_t global = 0;
+  if (this->current->scope_depth > 0) {
+    declare_variable(node.a, node);
+  } else {
+    global = this->global(node.a, node);
+  }
+
+  emit_op_short(Op_Code::OP_CLASS, name);
+  define_variable(global);
+
+  class_state state{this->current_class, false};
+  this->current_class = &state;
+
+  if (node.b != Ast::NO_NODE) {
+    const Ast_Node& superclass = this->ast.get(node.b);
+    if (superclass.a == node.a) {
+      error(superclass, this->symbols.get_string(superclass.a),
+            "A class can't inherit from itself.");
+    }
+
+    named_variable(superclass.a, false, superclass);
+
+    // The superclass is kept in a local named "super" that methods capture.
+    begin_scope();
+    add_local(SUPER_NAME, node);
+    define_variable(0);
+
+    named_variable(node.a, false, node);
+    emit_op(Op_Code::OP_INHERIT);
+    state.has_superclass = true;
+  }
+
+  // The class stays on the stack while its methods are added to it.
+  named_variable(node.a, false, node);
+
+  for (Node_Id id : this->ast.get_list(node.c)) {
+    const Ast_Node& method = this->ast.get(id);
+    uint32_t enclosing_line = this->line;
+    this->line = line_of(method);
+
+    uint16_t method_name = make_constant(Value::object(string(method.a)),
+                                         method);
+    function(method, (this->symbols.get_string(method.a) == "init")
+                         ? Function_Type::FT_INITIALIZER
+                         : Function_Type::FT_METHOD);
+    emit_op_short(Op_Code::OP_METHOD, method_name);
+
+    this->line = enclosing_line;
+  }
+
+  emit_op(Op_Code::OP_POP);
+
+  if (state.has_superclass) {
+    end_scope();
+  }
+
+  this->current_class = state.enclosing;
+}
+
+void Compiler::if_statement(const Ast_Node& node) {
+  expression(node.a);
+
+  std::size_t then_jump = emit_jump(Op_Code::OP_JUMP_IF_FALSE);
+  emit_op(Op_Code::OP_POP);
+  statement(node.b);
+
+  std::size_t else_jump = emit_jump(Op_Code::OP_JUMP);
+  patch_jump(then_jump, node);
+
+  // The else branch starts with the condition still on the stack.
+  adjust_stack(1);
+  emit_op(Op_Code::OP_POP);
+
+  if (node.c != Ast::NO_NODE) {
+    statement(node.c);
+  }
+
+  patch_jump(else_jump, node);
+}
+
+void Compiler::while_statement(const Ast_Node& node) {
+  std::size_t loop_start = chunk().get_size();
+  expression(node.a);
+
+  std::size_t exit_jump = emit_jump(Op_Code::OP_JUMP_IF_FALSE);
+  emit_op(Op_Code::OP_POP);
+  statement(node.b);
+  emit_loop(loop_start, node);
+
+  patch_jump(exit_jump, node);
+
+  // The loop is left with the condition still on the stack.
+  adjust_stack(1);
+  emit_op(Op_Code::OP_POP);
+}
+
+void Compiler::return_statement(const Ast_Node& node) {
+  if (this->current->type == Function_Type::FT_SCRIPT) {
+    error(node, "return", "Can't return from top-level code.");
+  }
+
+  if (node.a == Ast::NO_NODE) {
+    emit_return();
+    return;
+  }
+
+  if (this->current->type == Function_Type::FT_INITIALIZER) {
+    error(node, "return", "Can't return a value from an initializer.");
+  }
+
+  expression(node.a);
+  emit_op(Op_Code::OP_RETURN);
+}
+
+/*******************************************************************************
+EXPRESSIONS
+*******************************************************************************/
+void Compiler::expression(Node_Id id) {
+  const Ast_Node& node = this->ast.get(id);
+  uint32_t enclosing_line = this->line;
+  this->line = line_of(node);
+
+  switch (node.kind) {
+    case Node_Kind::NK_NUMBER:
+      emit_op_short(Op_Code::OP_CONSTANT,
+                    make_constant(this->literals.get(node.a), node));
+      break;
+    case Node_Kind::NK_STRING:
+      emit_op_short(Op_Code::OP_CONSTANT,
+                    make_constant(Value::object(string(node.a)), node));
+      break;
+    case Node_Kind::NK_TRUE:
+      emit_op(Op_Code::OP_TRUE);
+      break;
+    case Node_Kind::NK_FALSE:
+      emit_op(Op_Code::OP_FALSE);
+      break;
+    case Node_Kind::NK_NIL:
+      emit_op(Op_Code::OP_NIL);
+      break;
+    case Node_Kind::NK_VARIABLE:
+      named_variable(node.a, false, node);
+      break;
+    case Node_Kind::NK_ASSIGN:
+      expression(node.b);
+      named_variable(node.a, true, node);
+      break;
+    case Node_Kind::NK_UNARY:
+      expression(node.a);
+      emit_op((node.op == Token_Type::TT_MINUS) ? Op_Code::OP_NEGATE
+                                                : Op_Code::OP_NOT);
+      break;
+    case Node_Kind::NK_BINARY:
+      binary(node);
+      break;
+    case Node_Kind::NK_LOGICAL:
+      logical(node);
+      break;
+    case Node_Kind::NK_GROUPING:
+      expression(node.a);
+      break;
+    case Node_Kind::NK_CALL:
+      call(node);
+      break;
+    case Node_Kind::NK_GET:
+      expression(node.a);
+      emit_op_short(Op_Code::OP_GET_PROPERTY,
+                    make_constant(Value::object(string(node.b)), node));
+      break;
+    case Node_Kind::NK_SET:
+      expression(node.a);
+      expression(node.c);
+      emit_op_short(Op_Code::OP_SET_PROPERTY,
+                    make_constant(Value::object(string(node.b)), node));
+      break;
+    case Node_Kind::NK_THIS:
+      if (this->current_class == nullptr) {
+        error(node, "this", "Can't use 'this' outside of a class.");
+        break;
+      }
+      named_variable(THIS_NAME, false, node);
+      break;
+    case Node_Kind::NK_SUPER:
+      if (check_super(node)) {
+        uint16_t name = make_constant(Value::object(string(node.a)), node);
+        named_variable(THIS_NAME, false, node);
+        named_variable(SUPER_NAME, false, node);
+        emit_op_short(Op_Code::OP_GET_SUPER, name);
+      }
+      break;
+    default:
+      break;
+  }
+
+  this->line = enclosing_line;
+}
+
+void Compiler::binary(const Ast_Node& node) {
+  expression(node.a);
+  expression(node.b);
+
+  switch (node.op) {
+    case Token_Type::TT_PLUS:
+      emit_op(Op_Code::OP_ADD);
+      break;
+    case Token_Type::TT_MINUS:
+      emit_op(Op_Code::OP_SUBTRACT);
+      break;
+    case Token_Type::TT_STAR:
+      emit_op(Op_Code::OP_MULTIPLY);
+      break;
+    case Token_Type::TT_SLASH:
+      emit_op(Op_Code::OP_DIVIDE);
+      break;
+    case Token_Type::TT_EQUAL_EQUAL:
+      emit_op(Op_Code::OP_EQUAL);
+      break;
+    case Token_Type::TT_BANG_EQUAL:
+      emit_op(Op_Code::OP_NOT_EQUAL);
+      break;
+    case Token_Type::TT_GREATER:
+      emit_op(Op_Code::OP_GREATER);
+      break;
+    case Token_Type::TT_GREATER_EQUAL:
+      emit_op(Op_Code::OP_GREATER_EQUAL);
+      break;
+    case Token_Type::TT_LESS:
+      emit_op(Op_Code::OP_LESS);
+      break;
+    case Token_Type::TT_LESS_EQUAL:
+      emit_op(Op_Code::OP_LESS_EQUAL);
+      break;
+    default:
+      break;
+  }
+}
+
+void Compiler::logical(const Ast_Node& node) {
+  expression(node.a);
+
+  if (node.op == Token_Type::TT_AND) {
+    // A falsey left operand is the result; otherwise it is discarded for the
+    // right one.
+    std::size_t end_jump = emit_jump(Op_Code::OP_JUMP_IF_FALSE);
+    emit_op(Op_Code::OP_POP);
+    expression(node.b);
+    patch_jump(end_jump, node);
+    return;
+  }
+
+  std::size_t else_jump = emit_jump(Op_Code::OP_JUMP_IF_FALSE);
+  std::size_t end_jump = emit_jump(Op_Code::OP_JUMP);
+  patch_jump(else_jump, node);
+  emit_op(Op_Code::OP_POP);
+  expression(node.b);
+  patch_jump(end_jump, node);
+}
+
+void Compiler::call(const Ast_Node& node) {
+  const Ast_Node& callee = this->ast.get(node.a);
+
+  // Calls of methods are fused with looking the method up, so that no bound
+  // method is created.
+  if (callee.kind == Node_Kind::NK_GET) {
+    expression(callee.a);
+    uint16_t name = make_constant(Value::object(string(callee.b)), callee);
+    uint8_t arg_count = arguments(node.b);
+    emit_op_short(Op_Code::OP_INVOKE, name);
+    emit_byte(arg_count);
+    adjust_stack(-arg_count);
+    return;
+  }
+
+  if (callee.kind == Node_Kind::NK_SUPER) {
+    if (!check_super(callee)) {
+      return;
+    }
+    uint16_t name = make_constant(Value::object(string(callee.a)), callee);
+    named_variable(THIS_NAME, false, callee);
+    uint8_t arg_count = arguments(node.b);
+    named_variable(SUPER_NAME, false, callee);
+    emit_op_short(Op_Code::OP_SUPER_INVOKE, name);
+    emit_byte(arg_count);
+    adjust_stack(-arg_count);
+    return;
+  }
+
+  expression(node.a);
+  uint8_t arg_count = arguments(node.b);
+  emit_op(Op_Code::OP_CALL, arg_count);
+  adjust_stack(-arg_count);
+}
+
+bool Compiler::check_super(const Ast_Node& node) {
+  if (this->current_class == nullptr) {
+    error(node, "super", "Can't use 'super' outside of a class.");
+    return false;
+  }
+
+  if (!this->current_class->has_superclass) {
+    error(node, "super", "Can't use 'super' in a class with no superclass.");
+    return false;
+  }
+
+  return true;
+}
+
+uint8_t Compiler::arguments(uint32_t list) {
+  std::span<const uint32_t> items = this->ast.get_list(list);
+  for (Node_Id id : items) {
+    expression(id);
+  }
+
+  return (uint8_t)items.size();
+}
+
+/*******************************************************************************
+VARIABLES AND SCOPES
+*******************************************************************************/
+void Compiler::begin_scope() { this->current->scope_depth++; }
+
+void Compiler::end_scope() {
+  function_state& state = *this->current;
+  state.scope_depth--;
+
+  while ((state.local_count > 0) &&
+         (state.locals[state.local_count - 1].depth > state.scope_depth)) {
+    emit_op(state.locals[state.local_count - 1].is_captured
+                ? Op_Code::OP_CLOSE_UPVALUE
+                : Op_Code::OP_POP);
+    state.local_count--;
+  }
+}
+
+void Compiler::named_variable(uint32_t name, bool assign,
+                              const Ast_Node& node) {
+  int arg = resolve_local(*this->current, name, node);
+  if (arg != -1) {
+    emit_op(assign ? Op_Code::OP_SET_LOCAL : Op_Code::OP_GET_LOCAL,
+            (uint8_t)arg);
+    return;
+  }
+
+  arg = resolve_upvalue(*this->current, name, node);
+  if (arg != -1) {
+    emit_op(assign ? Op_Code::OP_SET_UPVALUE : Op_Code::OP_GET_UPVALUE,
+            (uint8_t)arg);
+    return;
+  }
+
+  emit_op_short(assign ? Op_Code::OP_SET_GLOBAL : Op_Code::OP_GET_GLOBAL,
+                global(name, node));
+}
+
+int Compiler::resolve_local(function_state& state, uint32_t name,
+                            const Ast_Node& node) {
+  for (int i = state.local_count - 1; i >= 0; i--) {
+    if (state.locals[i].name == name) {
+      if (state.locals[i].depth == -1) {
+        error(node, name_text(name),
+              "Can't read local variable in its own initializer.");
+      }
+      return i;
+    }
+  }
+
+  return -1;
+}
+
+int Compiler::resolve_upvalue(function_state& state, uint32_t name,
+                              const Ast_Node& node) {
+  if (state.enclosing == nullptr) {
+    return -1;
+  }
+
+  int local = resolve_local(*state.enclosing, name, node);
+  if (local != -1) {
+    state.enclosing->locals[local].is_captured = true;
+    return add_upvalue(state, (uint8_t)local, true, name, node);
+  }
+
+  int upvalue = resolve_upvalue(*state.enclosing, name, node);
+  if (upvalue != -1) {
+    return add_upvalue(state, (uint8_t)upvalue, false, name, node);
+  }
+
+  return -1;
+}
+
+int Compiler::add_upvalue(function_state& state, uint8_t index, bool is_local,
+                          uint32_t name, const Ast_Node& node) {
+  uint32_t count = state.function->upvalue_count;
+  for (uint32_t i = 0; i < count; i++) {
+    if ((state.upvalues[i].index == index) &&
+        (state.upvalues[i].is_local == is_local)) {
+      return i;
+    }
+  }
+
+  if (count == MAX_UPVALUES) {
+    error(node, name_text(name), "Too many closure variables in function.");
+    return 0;
+  }
+
+  state.upvalues[count].is_local = is_local;
+  state.upvalues[count].index = index;
+  return state.function->upvalue_count++;
+}
+
+void Compiler::declare_variable(uint32_t name, const Ast_Node& node) {
+  function_state& state = *this->current;
+  if (state.scope_depth == 0) {
+    return;
+  }
+
+  for (int i = state.local_count - 1; i >= 0; i--) {
+    const local& declared = state.locals[i];
+    if ((declared.depth != -1) && (declared.depth < state.scope_depth)) {
+      break;
+    }
+
+    if (declared.name == name) {
+      error(node, name_text(name),
+            "Already a variable with this name in this scope.");
+    }
+  }
+
+  add_local(name, node);
+}
+
+void Compiler::add_local(uint32_t name, const Ast_Node& node) {
+  function_state& state = *this->current;
+  if (state.local_count == MAX_LOCALS) {
+    error(node, name_text(name), "Too many local variables in function.");
+    return;
+  }
+
+  local& added = state.locals[state.local_count++];
+  added.name = name;
+  added.depth = -1;
+  added.is_captured = false;
+}
+
+void Compiler::mark_initialized() {
+  function_state& state = *this->current;
+  if (state.scope_depth == 0) {
+    return;
+  }
+
+  state.locals[state.local_count - 1].depth = state.scope_depth;
+}
+
+void Compiler::define_variable(uint32_t global) {
+  if (this->current->scope_depth > 0) {
+    mark_initialized();
+    return;
+  }
+
+  emit_op_short(Op_Code::OP_DEFINE_GLOBAL, (uint16_t)global);
+}
+
+uint32_t Compiler::global(uint32_t symbol, const Ast_Node& node) {
+  uint32_t& slot = this->global_slots[symbol];
+  if (slot == UINT32_MAX) {
+    slot = this->vm.global_slot(string(symbol));
+  }
+
+  if (slot > UINT16_MAX) {
+    error(node, this->symbols.get_string(symbol), "Too many global variables.");
+    return 0;
+  }
+
+  return slot;
+}
+
+Obj_String* Compiler::string(uint32_t symbol) {
+  Obj_String*& interned = this->strings[symbol];
+  if (interned == nullptr) {
+    interned = this->vm.intern(this->symbols.get_string(symbol));
+  }
+
+  return interned;
+}
+
+std::string_view Compiler::name_text(uint32_t name) const {
+  switch (name) {
+    case NO_NAME:
+      return std::string_view("");
+    case THIS_NAME:
+      return std::string_view("this");
+    case SUPER_NAME:
+      return std::string_view("super");
+    default:
+      return this->symbols.get_string(name);
+  }
+}
+
+/*******************************************************************************
+EMITTING CODE
+*******************************************************************************/
+Chunk& Compiler::chunk() { return this->current->function->chunk; }
+
+void Compiler::emit_byte(uint8_t byte) { chunk().write(byte, this->line); }
+
+void Compiler::emit_short(uint16_t value) {
+  emit_byte((uint8_t)(value >> 8));
+  emit_byte((uint8_t)(value & 0xFF));
+}
+
+void Compiler::emit_op(Op_Code op) {
+  emit_byte((uint8_t)op);
+  adjust_stack(op_code_stack_effect(op));
+}
+
+void Compiler::emit_op(Op_Code op, uint8_t operand) {
+  emit_op(op);
+  emit_byte(operand);
+}
+
+void Compiler::emit_op_short(Op_Code op, uint16_t operand) {
+  emit_op(op);
+  emit_short(operand);
+}
+
+void Compiler::adjust_stack(int delta) {
+  function_state& state = *this->current;
+  state.stack_height += delta;
+  if (state.stack_height > (int)state.function->max_stack) {
+    state.function->max_stack = state.stack_height;
+  }
+}
+
+std::size_t Compiler::emit_jump(Op_Code op) {
+  emit_op_short(op, UINT16_MAX);
+  return chunk().get_size() - 2;
+}
+
+void Compiler::patch_jump(std::size_t offset, const Ast_Node& node) {
+  // The jump is relative to the end of its operand.
+  std::size_t jump = chunk().get_size() - offset - 2;
+  if (jump > UINT16_MAX) {
+    error(node, "", "Too much code to jump over.");
+  }
+
+  chunk().patch(offset, (uint8_t)((jump >> 8) & 0xFF));
+  chunk().patch(offset + 1, (uint8_t)(jump & 0xFF));
+}
+
+void Compiler::emit_loop(std::size_t loop_start, const Ast_Node& node) {
+  emit_op(Op_Code::OP_LOOP);
+
+  std::size_t offset = chunk().get_size() - loop_start + 2;
+  if (offset > UINT16_MAX) {
+    error(node, "", "Loop body too large.");
+  }
+
+  emit_short((uint16_t)offset);
+}
+
+void Compiler::emit_return() {
+  if (this->current->type == Function_Type::FT_INITIALIZER) {
+    emit_op(Op_Code::OP_GET_LOCAL, 0);
+  } else {
+    emit_op(Op_Code::OP_NIL);
+  }
+
+  emit_op(Op_Code::OP_RETURN);
+}
+
+uint16_t Compiler::make_constant(Value value, const Ast_Node& node) {
+  // Numbers and strings are added once per function, however often they are
+  // used; numbers are compared by their bits, so that 0 and -0 stay apart.
+  Hash_Table<uint64_t, uint16_t>* reused = nullptr;
+  uint64_t key = 0;
+  if (value.is_number()) {
+    reused = &this->current->number_constants;
+    key = std::bit_cast<uint64_t>(value.get_number());
+  } else if (is_object_type(value, Object_Type::OT_STRING)) {
+    reused = &this->current->string_constants;
+    key = (uint64_t)(uintptr_t)value.get_object();
+  }
+
+  if (reused != nullptr) {
+    const uint16_t* index = reused->search(key);
+    if (index != nullptr) {
+      return *index;
+    }
+  }
+
+  std::size_t index = chunk().add_constant(value);
+  if (index >= Chunk::MAX_CONSTANTS) {
+    error(node, "", "Too many constants in one chunk.");
+    return 0;
+  }
+
+  if (reused != nullptr) {
+    reused->insert(key, (uint16_t)index);
+  }
+
+  return (uint16_t)index;
+}
+
+/*******************************************************************************
+ERRORS
+*******************************************************************************/
+void Compiler::error(const Ast_Node& node, std::string_view lexeme,
+                     std::string_view message) {
+  this->had_error = true;
+
+  std::string where;
+  if (!lexeme.empty()) {
+    where = " at '" + std::string(lexeme) + "'";
+  }
+
+  this->e.error(line_of(node), where, std::string(message));
+}
+
+uint32_t Compiler::line_of(const Ast_Node& node) const {
+  return (uint32_t)this->source.get_line(node.offset);
+}
@@ -0,0 +1,148 @@
+#include "vm/disassembler.hpp"
+
+#include <stdint.h>
+#include <stdio.h>
+
+static uint16_t read_short(const Chunk& chunk, std::size_t offset) {
+  return (uint16_t)((chunk.get_byte(offset) << 8) | chunk.get_byte(offset + 1));
+}
+
+// Appends the op code's name padded to a column, and its first operand.
+static void write_operand(std::string_view name, unsigned long operand,
+                          std::string& out) {
+  char buffer[64];
+  int length = snprintf(buffer, sizeof(buffer), "%-16.*s %4lu",
+                        (int)name.length(), name.data(), operand);
+  out.append(buffer, length);
+}
+
+static void write_constant(const Chunk& chunk, std::size_t index,
+                           std::string& out) {
+  out += " '";
+  write_value(chunk.get_constant(index), out);
+  out += "'";
+}
+
+std::size_t disassemble_instruction(const Chunk& chunk, std::size_t offset,
+                                    std::string& out) {
+  char buffer[32];
+  int length = snprintf(buffer, sizeof(buffer), "%04zu ", offset);
+  out.append(buffer, length);
+
+  uint32_t line = chunk.get_line(offset);
+  if ((offset > 0) && (line == chunk.get_line(offset - 1))) {
+    out += "   | ";
+  } else {
+    length = snprintf(buffer, sizeof(buffer), "%4u ", line);
+    out.append(buffer, length);
+  }
+
+  Op_Code op = (Op_Code)chunk.get_byte(offset);
+  std::string_view name = op_code_to_str(op);
+  if (name.empty()) {
+    length = snprintf(buffer, sizeof(buffer), "Unknown opcode %d\n",
+                      chunk.get_byte(offset));
+    out.append(buffer, length);
+    return offset + 1;
+  }
+
+  switch (op_code_format(op)) {
+    case Operand_Format::SIMPLE:
+      out += name;
+      out += "\n";
+      return offset + 1;
+
+    case Operand_Format::BYTE:
+      write_operand(name, chunk.get_byte(offset + 1), out);
+      out += "\n";
+      return offset + 2;
+
+    case Operand_Format::SHORT:
+      write_operand(name, read_short(chunk, offset + 1), out);
+      out += "\n";
+      return offset + 3;
+
+    case Operand_Format::CONSTANT: {
+      uint16_t constant = read_short(chunk, offset + 1);
+      write_operand(name, constant, out);
+      write_constant(chunk, constant, out);
+      out += "\n";
+      return offset + 3;
+    }
+
+    case Operand_Format::JUMP:
+    case Operand_Format::LOOP: {
+      uint16_t jump = read_short(chunk, offset + 1);
+      std::size_t target = (op_code_format(op) == Operand_Format::JUMP)
+                               ? offset + 3 + jump
+                               : offset + 3 - jump;
+      write_operand(name, offset, out);
+      length = snprintf(buffer, sizeof(buffer), " -> %zu\n", target);
+      out.append(buffer, length);
+      return offset + 3;
+    }
+
+    case Operand_Format::INVOKE: {
+      uint16_t constant = read_short(chunk, offset + 1);
+      length = snprintf(buffer, sizeof(buffer), "(%d args)",
+                        chunk.get_byte(offset + 3));
+      write_operand(name, constant, out);
+      write_constant(chunk, constant, out);
+      out += " ";
+      out.append(buffer, length);
+      out += "\n";
+      return offset + 4;
+    }
+
+    case Operand_Format::CLOSURE: {
+      uint16_t constant = read_short(chunk, offset + 1);
+      write_operand(name, constant, out);
+      write_constant(chunk, constant, out);
+      out += "\n";
+
+      const Obj_Function* function =
+          as_object<Obj_Function>(chunk.get_constant(constant));
+      offset += 3;
+      for (uint32_t i = 0; i < function->upvalue_count; i++) {
+        bool is_local = chunk.get_byte(offset) != 0;
+        length = snprintf(buffer, sizeof(buffer), "%04zu    |", offset);
+        out.append(buffer, length);
+        length = snprintf(buffer, sizeof(buffer), "%21s %d\n",
+                          is_local ? "local" : "upvalue",
+                          chunk.get_byte(offset + 1));
+        out.append(buffer, length);
+        offset += 2;
+      }
+      return offset;
+    }
+  }
+
+  return offset + 1;
+}
+
+void disassemble_chunk(const Chunk& chunk, std::string_view name,
+                       std::string& out) {
+  out += "== ";
+  out += name;
+  out += " ==\n";
+
+  std::size_t offset = 0;
+  while (offset < chunk.get_size()) {
+    offset = disassemble_instruction(chunk, offset, out);
+  }
+}
+
+void disassemble_function(const Obj_Function* function, std::string& out) {
+  std::string_view name = (function->name == nullptr)
+                              ? std::string_view("<script>")
+                              : function->name->get_text();
+  disassemble_chunk(function->chunk, name, out);
+
+  for (std::size_t i = 0; i < function->chunk.get_constant_count(); i++) {
+    Value constant = function->chunk.get_constant(i);
+    if (is_object_type(constant, Object_Type::OT_FUNCTION)) {
+      out += "\n";
+      disassemble_function(as_object<Obj_Function>(constant), out);
+    }
+  }
+}
@@ -0,0 +1,43 @@
+#include "vm/object.hpp"
+
+static void write_function(const Obj_Function* function, std::string& out) {
+  if (function->name == nullptr) {
+    out += "<script>";
+    return;
+  }
+
+  out += "<fn ";
+  out += function->name->get_text();
+  out += ">";
+}
+
+void write_object(const Obj* object, std::string& out) {
+  switch (object->type) {
+    case Object_Type::OT_STRING:
+      out += static_cast<const Obj_String*>(object)->get_text();
+      break;
+    case Object_Type::OT_FUNCTION:
+      write_function(static_cast<const Obj_Function*>(object), out);
+      break;
+    case Object_Type::OT_NATIVE:
+      out += "<native fn>";
+      break;
+    case Object_Type::OT_CLOSURE:
+      write_function(static_cast<const Obj_Closure*>(object)->function, out);
+      break;
+    case Object_Type::OT_UPVALUE:
+      out += "upvalue";
+      break;
+    case Object_Type::OT_CLASS:
+      out += static_cast<const Obj_Class*>(object)->name->get_text();
+      break;
+    case Object_Type::OT_INSTANCE:
+      out += static_cast<const Obj_Instance*>(object)->klass->name->get_text();
+      out += " instance";
+      break;
+    case Object_Type::OT_BOUND_METHOD:
+      write_function(
+          static_cast<const Obj_Bound_Method*>(object)->method->function, out);
+      break;
+  }
+}
@@ -0,0 +1,51 @@
+#include "vm/value.hpp"
+
+#include <charconv>
+#include <cmath>
+
+#include "vm/object.hpp"
+
+// Integral numbers print without a fraction, e.g. 3 rather than 3.0, and other
+// numbers with the fewest digits that read back as the same double. NaN always
+// prints as nan, whatever its sign bit, which depends on how it was produced.
+static void write_number(double number, std::string& out) {
+  char buffer[32];
+  char* end;
+
+  if (std::isnan(number)) {
+    out += "nan";
+    return;
+  }
+
+  if ((std::trunc(number) == number) && (std::fabs(number) < 1e15)) {
+    if ((number == 0) && std::signbit(number)) {
+      out += "-0";
+      return;
+    }
+    end = std::to_chars(buffer, buffer + sizeof(buffer), (int64_t)number).ptr;
+  } else {
+    end = std::to_chars(buffer, buffer + sizeof(buffer), number).ptr;
+  }
+
+  out.append(buffer, end - buffer);
+}
+
+void write_value(Value value, std::string& out) {
+  switch (value.get_type()) {
+    case Value_Type::VT_NIL:
+      out += "nil";
+      break;
+    case Value_Type::VT_BOOL:
+      out += value.get_bool() ? "true" : "false";
+      break;
+    case Value_Type::VT_NUMBER:
+      write_number(value.get_number(), out);
+      break;
+    case Value_Type::VT_OBJECT:
+      write_object(value.get_object(), out);
+      break;
+    case Value_Type::VT_UNDEFINED:
+      out += "undefined";
+      break;
+  }
+}
@@ -0,0 +1,971 @@
+#include "vm/vm.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+#include "memory/arena.hpp"
+#include "parser/parser.hpp"
+#include "vm/compiler.hpp"
+#include "vm/disassembler.hpp"
+
+// Returns the time in seconds, for timing code; only differences between
+// calls are meaningful.
+static Value clock_native(int arg_count, Value* args) {
+  (void)arg_count;
+  (void)args;
+
+  return Value::number(std::chrono::duration<double>(
+                           std::chrono::steady_clock::now().time_since_epoch())
+                           .count());
+}
+
+VM::VM(std::ostream& out) : out(out), stack(new Value[STACK_MAX]) {
+  reset_stack();
+
+  this->collection_paused = true;
+  this->init_string = intern("init");
+  define_native("clock", clock_native);
+  this->collection_paused = false;
+}
+
+VM::~VM() {
+  Obj* object = this->objects;
+  while (object != nullptr) {
+    Obj* next = object->next;
+    free_object(object);
+    object = next;
+  }
+}
+
+Interpret_Result VM::interpret(const Source_File& source, Error_Reporter& e) {
+  return execute(compile(source, e), e);
+}
+
+Interpret_Result VM::interpret(const Source_File& source,
+                               std::span<const Token> tokens,
+                               const Literal_Table& literals,
+                               const Symbol_Table& symbols, Error_Reporter& e) {
+  return execute(compile(source, tokens, literals, symbols, e), e);
+}
+
+Interpret_Result VM::execute(Obj_Function* function, Error_Reporter& e) {
+  if (function == nullptr) {
+    return Interpret_Result::IR_COMPILE_ERROR;
+  }
+
+  this->reporter = &e;
+
+  // The function is kept on the stack while the closure is allocated, so a
+  // collection doesn't free it.
+  push(Value::object(function));
+  Obj_Closure* closure = new_closure(function);
+  pop();
+  push(Value::object(closure));
+
+  Interpret_Result result = Interpret_Result::IR_RUNTIME_ERROR;
+  if (call(closure, 0)) {
+    result = run();
+  }
+
+  flush_output();
+  this->reporter = nullptr;
+  return result;
+}
+
+bool VM::disassemble(const Source_File& source, Error_Reporter& e,
+                     std::string& out) {
+  Obj_Function* function = compile(source, e);
+  if (function == nullptr) {
+    return false;
+  }
+
+  disassemble_function(function, out);
+  return true;
+}
+
+void VM::set_stress_collection(bool stress) {
+  this->stress_collection = stress;
+}
+
+std::size_t VM::get_bytes_allocated() const { return this->bytes_allocated; }
+
+Obj_String* VM::intern(std::string_view text) {
+  uint64_t hash = String_Interner::hash(text);
+
+  Obj_String** interned = this->strings.search(Interned_Text{text, hash});
+  if (interned != nullptr) {
+    return *interned;
+  }
+
+  return new_string(text, hash);
+}
+
+Obj_Function* VM::new_function() { return allocate_object<Obj_Function>(); }
+
+uint32_t VM::global_slot(Obj_String* name) {
+  auto [slot, inserted] = this->global_slots.try_emplace(
+      name, (uint32_t)(this->globals.get_maximum_index() + 1));
+
+  if (inserted) {
+    this->globals.push_back(Value::undefined());
+    this->global_names.push_back(name);
+  }
+
+  return *slot;
+}
+
+Obj_Function* VM::compile(const Source_File& source, Error_Reporter& e) {
+  // The tree and the parser's tables are only needed until the bytecode is
+  // emitted, so they are freed with the arena.
+  Arena arena;
+  Monotonic_Resource resource(arena);
+
+  Parser parser(source, e, &resource);
+  return compile(source, parser, e);
+}
+
+Obj_Function* VM::compile(const Source_File& source,
+                          std::span<const Token> tokens,
+                          const Literal_Table& literals,
+                          const Symbol_Table& symbols, Error_Reporter& e) {
+  Arena arena;
+  Monotonic_Resource resource(arena);
+
+  Parser parser(source, tokens, literals, symbols, e, &resource);
+  return compile(source, parser, e);
+}
+
+Obj_Function* VM::compile(const Source_File& source, Parser& parser,
+                          Error_Reporter& e) {
+  // Errors reported before this compilation don't make it fail.
+  bool had_error = e.had_error;
+  e.had_error = false;
+
+  Ast& ast = parser.parse();
+
+  Obj_Function* function = nullptr;
+  if (!e.had_error) {
+    // The functions being compiled aren't reachable from any root yet.
+    bool paused = this->collection_paused;
+    this->collection_paused = true;
+    try {
+      function = Compiler(*this, source, ast, parser.get_literals(),
+                          parser.get_symbols(), e)
+                     .compile();
+    } catch (...) {
+      this->collection_paused = paused;
+      throw;
+    }
+    this->collection_paused = paused;
+  }
+
+  e.had_error = e.had_error || had_error;
+  return function;
+}
+
+/*******************************************************************************
+EXECUTION
+*******************************************************************************/
+inline void VM::push(Value value) {
+  *this->stack_top = value;
+  this->stack_top++;
+}
+
+inline Value VM::pop() {
+  this->stack_top--;
+  return *this->stack_top;
+}
+
+inline Value VM::peek(std::size_t distance) const {
+  return this->stack_top[-1 - (std::ptrdiff_t)distance];
+}
+
+Interpret_Result VM::run() {
+  call_frame* frame;
+  uint8_t* ip;
+  Value* slots;
+  Value* constants;
+
+  // Globals are only added by compiling, so the array doesn't move while
+  // running.
+  Value* globals = this->globals.begin();
+
+#define LOAD_FRAME()                                              \
+  do {                                                            \
+    frame = &this->frames[this->frame_count - 1];                 \
+    ip = frame->ip;                                               \
+    slots = frame->slots;                                         \
+    constants = frame->closure->function->chunk.get_constants(); \
+  } while (false)
+
+#define SAVE_FRAME() (frame->ip = ip)
+#define READ_BYTE() (*ip++)
+#define READ_SHORT() (ip += 2, (uint16_t)((ip[-2] << 8) | ip[-1]))
+#define READ_CONSTANT() (constants[READ_SHORT()])
+#define READ_STRING() (as_object<Obj_String>(READ_CONSTANT()))
+
+#define RUNTIME_ERROR(message)                 \
+  do {                                         \
+    SAVE_FRAME();                              \
+    runtime_error(message);                    \
+    return Interpret_Result::IR_RUNTIME_ERROR; \
+  } while (false)
+
+#define BINARY_OP(make, op)                                              \
+  do {                                                                   \
+    Value b = this->stack_top[-1];                                       \
+    Value a = this->stack_top[-2];                                       \
+    if (!a.is_number() || !b.is_number()) {                              \
+      RUNTIME_ERROR("Operands must be numbers.");                        \
+    }                                                                    \
+    this->stack_top--;                                                   \
+    this->stack_top[-1] = Value::make(a.get_number() op b.get_number()); \
+  } while (false)
+
+  LOAD_FRAME();
+
+  while (true) {
+    switch ((Op_Code)READ_BYTE()) {
+      case Op_Code::OP_CONSTANT:
+        push(READ_CONSTANT());
+        break;
+      case Op_Code::OP_NIL:
+        push(Value::nil());
+        break;
+      case Op_Code::OP_TRUE:
+        push(Value::boolean(true));
+        break;
+      case Op_Code::OP_FALSE:
+        push(Value::boolean(false));
+        break;
+      case Op_Code::OP_POP:
+        this->stack_top--;
+        break;
+
+      case Op_Code::OP_GET_LOCAL:
+        push(slots[READ_BYTE()]);
+        break;
+      case Op_Code::OP_SET_LOCAL:
+        slots[READ_BYTE()] = peek(0);
+        break;
+
+      case Op_Code::OP_GET_GLOBAL: {
+        uint16_t slot = READ_SHORT();
+        if (globals[slot].is_undefined()) {
+          RUNTIME_ERROR("Undefined variable '" +
+                        std::string(this->global_names[slot]->get_text()) +
+                        "'.");
+        }
+        push(globals[slot]);
+        break;
+      }
+      case Op_Code::OP_DEFINE_GLOBAL:
+        globals[READ_SHORT()] = pop();
+        break;
+      case Op_Code::OP_SET_GLOBAL: {
+        uint16_t slot = READ_SHORT();
+        if (globals[slot].is_undefined()) {
+          RUNTIME_ERROR("Undefined variable '" +
+                        std::string(this->global_names[slot]->get_text()) +
+                        "'.");
+        }
+        globals[slot] = peek(0);
+        break;
+      }
+
+      case Op_Code::OP_GET_UPVALUE:
+        push(*frame->closure->get_upvalues()[READ_BYTE()]->location);
+        break;
+      case Op_Code::OP_SET_UPVALUE:
+        *frame->closure->get_upvalues()[READ_BYTE()]->location = peek(0);
+        break;
+
+      case Op_Code::OP_GET_PROPERTY: {
+        if (!is_object_type(peek(0), Object_Type::OT_INSTANCE)) {
+          RUNTIME_ERROR("Only instances have properties.");
+        }
+
+        Obj_Instance* instance = as_object<Obj_Instance>(peek(0));
+        Obj_String* name = READ_STRING();
+
+        Value* field = instance->fields.search(name);
+        if (field != nullptr) {
+          this->stack_top[-1] = *field;
+          break;
+        }
+
+        SAVE_FRAME();
+        if (!bind_method(instance->klass, name)) {
+          return Interpret_Result::IR_RUNTIME_ERROR;
+        }
+        break;
+      }
+      case Op_Code::OP_SET_PROPERTY: {
+        if (!is_object_type(peek(1), Object_Type::OT_INSTANCE)) {
+          RUNTIME_ERROR("Only instances have fields.");
+        }
+
+        Obj_Instance* instance = as_object<Obj_Instance>(peek(1));
+        auto [field, inserted] =
+            instance->fields.try_emplace(READ_STRING(), peek(0));
+        if (!inserted) {
+          *field = peek(0);
+        }
+
+        Value value = pop();
+        this->stack_top[-1] = value;
+        break;
+      }
+      case Op_Code::OP_GET_SUPER: {
+        Obj_String* name = READ_STRING();
+        Obj_Class* superclass = as_object<Obj_Class>(pop());
+
+        SAVE_FRAME();
+        if (!bind_method(superclass, name)) {
+          return Interpret_Result::IR_RUNTIME_ERROR;
+        }
+        break;
+      }
+
+      case Op_Code::OP_EQUAL: {
+        Value b = pop();
+        this->stack_top[-1] = Value::boolean(this->stack_top[-1] == b);
+        break;
+      }
+      case Op_Code::OP_NOT_EQUAL: {
+        Value b = pop();
+        this->stack_top[-1] = Value::boolean(!(this->stack_top[-1] == b));
+        break;
+      }
+      case Op_Code::OP_GREATER:
+        BINARY_OP(boolean, >);
+        break;
+      case Op_Code::OP_GREATER_EQUAL:
+        BINARY_OP(boolean, >=);
+        break;
+      case Op_Code::OP_LESS:
+        BINARY_OP(boolean, <);
+        break;
+      case Op_Code::OP_LESS_EQUAL:
+        BINARY_OP(boolean, <=);
+        break;
+
+      case Op_Code::OP_ADD: {
+        Value b = this->stack_top[-1];
+        Value a = this->stack_top[-2];
+        if (a.is_number() && b.is_number()) {
+          this->stack_top--;
+          this->stack_top[-1] = Value::number(a.get_number() + b.get_number());
+        } else if (is_object_type(a, Object_Type::OT_STRING) &&
+                   is_object_type(b, Object_Type::OT_STRING)) {
+          concatenate();
+        } else {
+          RUNTIME_ERROR("Operands must be two numbers or two strings.");
+        }
+        break;
+      }
+      case Op_Code::OP_SUBTRACT:
+        BINARY_OP(number, -);
+        break;
+      case Op_Code::OP_MULTIPLY:
+        BINARY_OP(number, *);
+        break;
+      case Op_Code::OP_DIVIDE:
+        BINARY_OP(number, /);
+        break;
+
+      case Op_Code::OP_NOT:
+        this->stack_top[-1] = Value::boolean(this->stack_top[-1].is_falsey());
+        break;
+      case Op_Code::OP_NEGATE:
+        if (!peek(0).is_number()) {
+          RUNTIME_ERROR("Operand must be a number.");
+        }
+        this->stack_top[-1] = Value::number(-this->stack_top[-1].get_number());
+        break;
+
+      case Op_Code::OP_PRINT:
+        write_value(pop(), this->output);
+        this->output += '\n';
+        if (this->output.length() >= OUTPUT_BUFFER_SIZE) {
+          flush_output();
+        }
+        break;
+
+      case Op_Code::OP_JUMP: {
+        uint16_t offset = READ_SHORT();
+        ip += offset;
+        break;
+      }
+      case Op_Code::OP_JUMP_IF_FALSE: {
+        uint16_t offset = READ_SHORT();
+        if (peek(0).is_falsey()) {
+          ip += offset;
+        }
+        break;
+      }
+      case Op_Code::OP_LOOP: {
+        uint16_t offset = READ_SHORT();
+        ip -= offset;
+        break;
+      }
+
+      case Op_Code::OP_CALL: {
+        int arg_count = READ_BYTE();
+        SAVE_FRAME();
+        if (!call_value(peek(arg_count), arg_count)) {
+          return Interpret_Result::IR_RUNTIME_ERROR;
+        }
+        LOAD_FRAME();
+        break;
+      }
+      case Op_Code::OP_INVOKE: {
+        Obj_String* name = READ_STRING();
+        int arg_count = READ_BYTE();
+        SAVE_FRAME();
+        if (!invoke(name, arg_count)) {
+          return Interpret_Result::IR_RUNTIME_ERROR;
+        }
+        LOAD_FRAME();
+        break;
+      }
+      case Op_Code::OP_SUPER_INVOKE: {
+        Obj_String* name = READ_STRING();
+        int arg_count = READ_BYTE();
+        Obj_Class* superclass = as_object<Obj_Class>(pop());
+        SAVE_FRAME();
+        if (!invoke_from_class(superclass, name, arg_count)) {
+          return Interpret_Result::IR_RUNTIME_ERROR;
+        }
+        LOAD_FRAME();
+        break;
+      }
+
+      case Op_Code::OP_CLOSURE: {
+        Obj_Function* function = as_object<Obj_Function>(READ_CONSTANT());
+        Obj_Closure* closure = new_closure(function);
+        push(Value::object(closure));
+
+        Obj_Upvalue** upvalues = closure->get_upvalues();
+        for (uint32_t i = 0; i < function->upvalue_count; i++) {
+          uint8_t is_local = READ_BYTE();
+          uint8_t index = READ_BYTE();
+          upvalues[i] = is_local ? capture_upvalue(slots + index)
+                                 : frame->closure->get_upvalues()[index];
+        }
+        break;
+      }
+      case Op_Code::OP_CLOSE_UPVALUE:
+        close_upvalues(this->stack_top - 1);
+        this->stack_top--;
+        break;
+
+      case Op_Code::OP_RETURN: {
+        Value result = pop();
+        close_upvalues(slots);
+        this->frame_count--;
+        if (this->frame_count == 0) {
+          // The script's closure.
+          pop();
+          return Interpret_Result::IR_OK;
+        }
+
+        this->stack_top = slots;
+        push(result);
+        LOAD_FRAME();
+        break;
+      }
+
+      case Op_Code::OP_CLASS:
+        push(Value::object(new_class(READ_STRING())));
+        break;
+      case Op_Code::OP_INHERIT: {
+        if (!is_object_type(peek(1), Object_Type::OT_CLASS)) {
+          RUNTIME_ERROR("Superclass must be a class.");
+        }
+
+        // Methods are copied down into the subclass when it is declared, so
+        // calls never search up the class hierarchy.
+        Obj_Class* subclass = as_object<Obj_Class>(peek(0));
+        as_object<Obj_Class>(peek(1))->methods.for_each(
+            [subclass](Obj_String* name, const Value& method) {
+              subclass->methods.insert(name, method);
+            });
+        this->stack_top--;
+        break;
+      }
+      case Op_Code::OP_METHOD:
+        define_method(READ_STRING());
+        break;
+    }
+  }
+
+#undef LOAD_FRAME
+#undef SAVE_FRAME
+#undef READ_BYTE
+#undef READ_SHORT
+#undef READ_CONSTANT
+#undef READ_STRING
+#undef RUNTIME_ERROR
+#undef BINARY_OP
+}
+
+void VM::reset_stack() {
+  this->stack_top = this->stack.get();
+  this->frame_count = 0;
+  this->open_upvalues = nullptr;
+}
+
+void VM::runtime_error(const std::string& message) {
+  flush_output();
+
+  std::string trace;
+  for (std::size_t i = this->frame_count; i > 0; i--) {
+    const call_frame& frame = this->frames[i - 1];
+    Obj_Function* function = frame.closure->function;
+
+    // ip is past the instruction that failed.
+    std::size_t instruction = frame.ip - function->chunk.get_code() - 1;
+    trace += "[line " + std::to_string(function->chunk.get_line(instruction)) +
+             "] in ";
+    if (function->name == nullptr) {
+      trace += "script\n";
+    } else {
+      trace += std::string(function->name->get_text()) + "()\n";
+    }
+  }
+
+  if (this->reporter != nullptr) {
+    this->reporter->runtime_error(message, trace);
+  }
+
+  reset_stack();
+}
+
+void VM::flush_output() {
+  this->out.write(this->output.data(), this->output.length());
+  this->out.flush();
+  this->output.clear();
+}
+
+bool VM::call_value(Value callee, int arg_count) {
+  if (callee.is_object()) {
+    switch (callee.get_object()->type) {
+      case Object_Type::OT_BOUND_METHOD: {
+        Obj_Bound_Method* bound = as_object<Obj_Bound_Method>(callee);
+        this->stack_top[-arg_count - 1] = bound->receiver;
+        return call(bound->method, arg_count);
+      }
+      case Object_Type::OT_CLASS: {
+        Obj_Class* klass = as_object<Obj_Class>(callee);
+        this->stack_top[-arg_count - 1] = Value::object(new_instance(klass));
+
+        Value* initializer = klass->methods.search(this->init_string);
+        if (initializer != nullptr) {
+          return call(as_object<Obj_Closure>(*initializer), arg_count);
+        }
+
+        if (arg_count != 0) {
+          runtime_error("Expected 0 arguments but got " +
+                        std::to_string(arg_count) + ".");
+          return false;
+        }
+        return true;
+      }
+      case Object_Type::OT_CLOSURE:
+        return call(as_object<Obj_Closure>(callee), arg_count);
+      case Object_Type::OT_NATIVE: {
+        Native_Function native = as_object<Obj_Native>(callee)->function;
+        Value result = native(arg_count, this->stack_top - arg_count);
+        this->stack_top -= arg_count + 1;
+        push(result);
+        return true;
+      }
+      default:
+        break;
+    }
+  }
+
+  runtime_error("Can only call functions and classes.");
+  return false;
+}
+
+bool VM::call(Obj_Closure* closure, int arg_count) {
+  Obj_Function* function = closure->function;
+  if (arg_count != function->arity) {
+    runtime_error("Expected " + std::to_string(function->arity) +
+                  " arguments but got " + std::to_string(arg_count) + ".");
+    return false;
+  }
+
+  // The compiler knows how high the function can grow the stack, so the
+  // whole frame is checked here instead of on every push.
+  std::size_t first_slot =
+      (this->stack_top - this->stack.get()) - arg_count - 1;
+  if ((this->frame_count == FRAMES_MAX) ||
+      (first_slot + function->max_stack > STACK_MAX)) {
+    runtime_error("Stack overflow.");
+    return false;
+  }
+
+  call_frame& frame = this->frames[this->frame_count++];
+  frame.closure = closure;
+  frame.ip = function->chunk.get_code();
+  frame.slots = this->stack.get() + first_slot;
+  return true;
+}
+
+bool VM::invoke(Obj_String* name, int arg_count) {
+  Value receiver = peek(arg_count);
+  if (!is_object_type(receiver, Object_Type::OT_INSTANCE)) {
+    runtime_error("Only instances have methods.");
+    return false;
+  }
+
+  // A field holding a function is called like any other value.
+  Obj_Instance* instance = as_object<Obj_Instance>(receiver);
+  Value* field = instance->fields.search(name);
+  if (field != nullptr) {
+    Value callee = *field;
+    this->stack_top[-arg_count - 1] = callee;
+    return call_value(callee, arg_count);
+  }
+
+  return invoke_from_class(instance->klass, name, arg_count);
+}
+
+bool VM::invoke_from_class(Obj_Class* klass, Obj_String* name,
+                           int arg_count) {
+  Value* method = klass->methods.search(name);
+  if (method == nullptr) {
+    runtime_error("Undefined property '" + std::string(name->get_text()) +
+                  "'.");
+    return false;
+  }
+
+  return call(as_object<Obj_Closure>(*method), arg_count);
+}
+
+bool VM::bind_method(Obj_Class* klass, Obj_String* name) {
+  Value* method = klass->methods.search(name);
+  if (method == nullptr) {
+    runtime_error("Undefined property '" + std::string(name->get_text()) +
+                  "'.");
+    return false;
+  }
+
+  Obj_Bound_Method* bound =
+      new_bound_method(peek(0), as_object<Obj_Closure>(*method));
+  this->stack_top[-1] = Value::object(bound);
+  return true;
+}
+
+Obj_Upvalue* VM::capture_upvalue(Value* local) {
+  Obj_Upvalue* previous = nullptr;
+  Obj_Upvalue* upvalue = this->open_upvalues;
+  while ((upvalue != nullptr) && (upvalue->location > local)) {
+    previous = upvalue;
+    upvalue = upvalue->next_open;
+  }
+
+  if ((upvalue != nullptr) && (upvalue->location == local)) {
+    return upvalue;
+  }
+
+  Obj_Upvalue* created = new_upvalue(local);
+  created->next_open = upvalue;
+  if (previous == nullptr) {
+    this->open_upvalues = created;
+  } else {
+    previous->next_open = created;
+  }
+
+  return created;
+}
+
+void VM::close_upvalues(Value* last) {
+  while ((this->open_upvalues != nullptr) &&
+         (this->open_upvalues->location >= last)) {
+    Obj_Upvalue* upvalue = this->open_upvalues;
+    upvalue->closed = *upvalue->location;
+    upvalue->location = &upvalue->closed;
+    this->open_upvalues = upvalue->next_open;
+  }
+}
+
+void VM::define_method(Obj_String* name) {
+  Value method = peek(0);
+  Obj_Class* klass = as_object<Obj_Class>(peek(1));
+
+  // A method overrides the one copied down from the superclass.
+  auto [existing, inserted] = klass->methods.try_emplace(name, method);
+  if (!inserted) {
+    *existing = method;
+  }
+
+  pop();
+}
+
+void VM::concatenate() {
+  // The operands stay on the stack until the result is allocated, so a
+  // collection doesn't free them.
+  std::string_view b = as_object<Obj_String>(peek(0))->get_text();
+  std::string_view a = as_object<Obj_String>(peek(1))->get_text();
+
+  std::string text;
+  text.reserve(a.length() + b.length());
+  text += a;
+  text += b;
+
+  Obj_String* result = intern(text);
+  this->stack_top -= 2;
+  push(Value::object(result));
+}
+
+void VM::define_native(std::string_view name, Native_Function function) {
+  Obj_Native* native = allocate_object<Obj_Native>();
+  native->function = function;
+
+  uint32_t slot = global_slot(intern(name));
+  this->globals[slot] = Value::object(native);
+}
+
+/*******************************************************************************
+ALLOCATION AND COLLECTION
+*******************************************************************************/
+Obj_String* VM::new_string(std::string_view text, uint64_t hash) {
+  Obj_String* string = allocate_object<Obj_String>(text.length());
+  string->length = (uint32_t)text.length();
+  string->hash = hash;
+  // An empty text's data() may be null, which memcpy must not be given.
+  if (!text.empty()) {
+    std::memcpy(string + 1, text.data(), text.length());
+  }
+
+  this->strings.insert(Interned_Text{string->get_text(), hash}, string);
+  return string;
+}
+
+Obj_Closure* VM::new_closure(Obj_Function* function) {
+  Obj_Closure* closure = allocate_object<Obj_Closure>(
+      function->upvalue_count * sizeof(Obj_Upvalue*));
+  closure->function = function;
+  std::fill_n(closure->get_upvalues(), function->upvalue_count, nullptr);
+  return closure;
+}
+
+Obj_Upvalue* VM::new_upvalue(Value* slot) {
+  Obj_Upvalue* upvalue = allocate_object<Obj_Upvalue>();
+  upvalue->location = slot;
+  return upvalue;
+}
+
+Obj_Class* VM::new_class(Obj_String* name) {
+  Obj_Class* klass = allocate_object<Obj_Class>();
+  klass->name = name;
+  return klass;
+}
+
+Obj_Instance* VM::new_instance(Obj_Class* klass) {
+  Obj_Instance* instance = allocate_object<Obj_Instance>();
+  instance->klass = klass;
+  return instance;
+}
+
+Obj_Bound_Method* VM::new_bound_method(Value receiver, Obj_Closure* method) {
+  Obj_Bound_Method* bound = allocate_object<Obj_Bound_Method>();
+  bound->receiver = receiver;
+  bound->method = method;
+  return bound;
+}
+
+std::size_t VM::object_size(const Obj* object) {
+  switch (object->type) {
+    case Object_Type::OT_STRING:
+      return sizeof(Obj_String) +
+             static_cast<const Obj_String*>(object)->length;
+    case Object_Type::OT_FUNCTION:
+      return sizeof(Obj_Function);
+    case Object_Type::OT_NATIVE:
+      return sizeof(Obj_Native);
+    case Object_Type::OT_CLOSURE:
+      return sizeof(Obj_Closure) +
+             static_cast<const Obj_Closure*>(object)->function->upvalue_count *
+                 sizeof(Obj_Upvalue*);
+    case Object_Type::OT_UPVALUE:
+      return sizeof(Obj_Upvalue);
+    case Object_Type::OT_CLASS:
+      return sizeof(Obj_Class);
+    case Object_Type::OT_INSTANCE:
+      return sizeof(Obj_Instance);
+    case Object_Type::OT_BOUND_METHOD:
+      return sizeof(Obj_Bound_Method);
+  }
+
+  return sizeof(Obj);
+}
+
+void VM::free_object(Obj* object) {
+  this->bytes_allocated -= object_size(object);
+
+  switch (object->type) {
+    case Object_Type::OT_STRING:
+      static_cast<Obj_String*>(object)->~Obj_String();
+      break;
+    case Object_Type::OT_FUNCTION:
+      static_cast<Obj_Function*>(object)->~Obj_Function();
+      break;
+    case Object_Type::OT_NATIVE:
+      static_cast<Obj_Native*>(object)->~Obj_Native();
+      break;
+    case Object_Type::OT_CLOSURE:
+      static_cast<Obj_Closure*>(object)->~Obj_Closure();
+      break;
+    case Object_Type::OT_UPVALUE:
+      static_cast<Obj_Upvalue*>(object)->~Obj_Upvalue();
+      break;
+    case Object_Type::OT_CLASS:
+      static_cast<Obj_Class*>(object)->~Obj_Class();
+      break;
+    case Object_Type::OT_INSTANCE:
+      static_cast<Obj_Instance*>(object)->~Obj_Instance();
+      break;
+    case Object_Type::OT_BOUND_METHOD:
+      static_cast<Obj_Bound_Method*>(object)->~Obj_Bound_Method();
+      break;
+  }
+
+  ::operator delete(object);
+}
+
+void VM::collect_garbage() {
+  mark_roots();
+  trace_references();
+  sweep();
+
+  this->next_collection =
+      std::max(this->bytes_allocated * HEAP_GROW_FACTOR, FIRST_COLLECTION);
+}
+
+void VM::mark_roots() {
+  for (Value* slot = this->stack.get(); slot < this->stack_top; slot++) {
+    mark_value(*slot);
+  }
+
+  for (std::size_t i = 0; i < this->frame_count; i++) {
+    mark_object(this->frames[i].closure);
+  }
+
+  for (Obj_Upvalue* upvalue = this->open_upvalues; upvalue != nullptr;
+       upvalue = upvalue->next_open) {
+    mark_object(upvalue);
+  }
+
+  for (Value& global : this->globals) {
+    mark_value(global);
+  }
+
+  for (Obj_String* name : this->global_names) {
+    mark_object(name);
+  }
+
+  mark_object(this->init_string);
+}
+
+void VM::mark_value(Value value) {
+  if (value.is_object()) {
+    mark_object(value.get_object());
+  }
+}
+
+void VM::mark_object(Obj* object) {
+  if ((object == nullptr) || object->marked) {
+    return;
+  }
+
+  object->marked = true;
+  this->gray_stack.push_back(object);
+}
+
+void VM::trace_references() {
+  int last;
+  while ((last = this->gray_stack.get_maximum_index()) >= 0) {
+    Obj* object = this->gray_stack[last];
+    this->gray_stack.remove(last);
+    blacken_object(object);
+  }
+}
+
+void VM::blacken_object(Obj* object) {
+  auto mark_entry = [this](Obj_String* name, const Value& value) {
+    mark_object(name);
+    mark_value(value);
+  };
+
+  switch (object->type) {
+    case Object_Type::OT_STRING:
+    case Object_Type::OT_NATIVE:
+      break;
+    case Object_Type::OT_FUNCTION: {
+      Obj_Function* function = static_cast<Obj_Function*>(object);
+      mark_object(function->name);
+      for (std::size_t i = 0; i < function->chunk.get_constant_count(); i++) {
+        mark_value(function->chunk.get_constant(i));
+      }
+      break;
+    }
+    case Object_Type::OT_CLOSURE: {
+      Obj_Closure* closure = static_cast<Obj_Closure*>(object);
+      mark_object(closure->function);
+      Obj_Upvalue** upvalues = closure->get_upvalues();
+      for (uint32_t i = 0; i < closure->function->upvalue_count; i++) {
+        mark_object(upvalues[i]);
+      }
+      break;
+    }
+    case Object_Type::OT_UPVALUE:
+      mark_value(static_cast<Obj_Upvalue*>(object)->closed);
+      break;
+    case Object_Type::OT_CLASS: {
+      Obj_Class* klass = static_cast<Obj_Class*>(object);
+      mark_object(klass->name);
+      klass->methods.for_each(mark_entry);
+      break;
+    }
+    case Object_Type::OT_INSTANCE: {
+      Obj_Instance* instance = static_cast<Obj_Instance*>(object);
+      mark_object(instance->klass);
+      instance->fields.for_each(mark_entry);
+      break;
+    }
+    case Object_Type::OT_BOUND_METHOD: {
+      Obj_Bound_Method* bound = static_cast<Obj_Bound_Method*>(object);
+      mark_value(bound->receiver);
+      mark_object(bound->method);
+      break;
+    }
+  }
+}
+
+void VM::sweep() {
+  Obj** link = &this->objects;
+  while (*link != nullptr) {
+    Obj* object = *link;
+    if (object->marked) {
+      object->marked = false;
+      link = &object->next;
+      continue;
+    }
+
+    *link = object->next;
+
+    // The table of interned strings doesn't keep strings alive.
+    if (object->type == Object_Type::OT_STRING) {
+      Obj_String* string = static_cast<Obj_String*>(object);
+      this->strings.remove(Interned_Text{string->get_text(), string->hash});
+    }
+
+    free_object(object);
+  }
+}
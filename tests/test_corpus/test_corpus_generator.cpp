@@ -0,0 +1,117 @@
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#include "corpus/corpus_generator.hpp"
+#include "error_reporter/error_reporter.hpp"
+#include "gtest/gtest.h"
+#include "scanner/scanner.hpp"
+#include "source_file/source_file.hpp"
+
+TEST(CorpusGeneratorSuite, SeedDeterminesCorpus) {
+  std::string first;
+  std::string second;
+  std::string other;
+  Corpus_Generator(7).generate(first, 1 << 16);
+  Corpus_Generator(7).generate(second, 1 << 16);
+  Corpus_Generator(8).generate(other, 1 << 16);
+
+  EXPECT_GE(first.size(), 1u << 16);
+  EXPECT_EQ(first, second);
+  EXPECT_NE(first, other);
+}
+
+TEST(CorpusGeneratorSuite, PiecesMakeTheSameCorpus) {
+  Corpus_Generator pieces(3);
+  std::string joined;
+  for (int i = 0; i < 100; i++) {
+    pieces.generate(joined, 500);
+  }
+
+  std::string whole;
+  Corpus_Generator(3).generate(whole, joined.size());
+  EXPECT_EQ(whole, joined);
+}
+
+TEST(CorpusGeneratorSuite, WritesTheGeneratedCorpus) {
+  char path[] = "/tmp/lox_corpus_XXXXXX";
+  int fd = mkstemp(path);
+  ASSERT_GE(fd, 0);
+
+  // Larger than one write block.
+  const std::size_t size = 3 << 20;
+  Corpus_Generator(11).write(fd, size);
+  close(fd);
+
+  std::string expected;
+  Corpus_Generator(11).generate(expected, size);
+  Source_File written = Source_File::open(path);
+  unlink(path);
+  EXPECT_EQ(written.get_contents(), expected);
+}
+
+TEST(CorpusGeneratorSuite, ProgramsScanWithoutErrors) {
+  for (uint64_t seed = 0; seed < 8; seed++) {
+    std::string text;
+    Corpus_Generator(seed).generate(text, 1 << 16);
+    Source_File source(std::move(text));
+
+    Error_Reporter e;
+    Scanner s(source, e);
+    Token_Array& tokens = s.scan_tokens();
+    EXPECT_FALSE(e.had_error) << seed;
+    EXPECT_GT(tokens.get_maximum_index(), 1000) << seed;
+  }
+}
+
+TEST(CorpusGeneratorSuite, MixLeavesOutKinds) {
+  Corpus_Generator::Mix mix;
+  mix.comments = 0;
+  mix.strings = 0;
+  mix.multi_line_strings = 0;
+  mix.max_depth = 2;
+
+  std::string text;
+  Corpus_Generator(5, mix).generate(text, 1 << 16);
+  EXPECT_EQ(text.find('"'), std::string::npos);
+  EXPECT_EQ(text.find("//"), std::string::npos);
+
+  // Methods nest one level deeper than the class around them.
+  int depth = 0;
+  int deepest = 0;
+  for (char c : text) {
+    depth += (c == '{') - (c == '}');
+    deepest = std::max(deepest, depth);
+  }
+  EXPECT_EQ(depth, 0);
+  EXPECT_LE(deepest, 3);
+
+  Corpus_Generator::Mix empty = mix;
+  empty.identifiers = empty.numbers = empty.literals = 0;
+  EXPECT_THROW(Corpus_Generator(5, empty), std::invalid_argument);
+}
+
+TEST(CorpusGeneratorSuite, AdversarialShapes) {
+  Error_Reporter e;
+
+  Source_File long_string(Corpus_Generator::long_string(1 << 20));
+  Scanner s(long_string, e);
+  Token_Array& tokens = s.scan_tokens();
+  ASSERT_EQ(tokens.get_maximum_index(), 5);
+  EXPECT_EQ(tokens[3].get_type(), Token_Type::TT_STRING);
+  EXPECT_EQ(tokens[3].get_lexeme(long_string.get_contents()).size(),
+            (1u << 20) + 2);
+
+  Source_File one_char(Corpus_Generator::one_char_tokens(100000));
+  Scanner o(one_char, e);
+  EXPECT_EQ(o.scan_tokens().get_maximum_index(), 100000);
+
+  Source_File nested(Corpus_Generator::deep_nesting(1000));
+  Scanner n(nested, e);
+  EXPECT_EQ(n.scan_tokens().get_maximum_index(), 4 * 1000 + 3);
+
+  EXPECT_FALSE(e.had_error);
+}
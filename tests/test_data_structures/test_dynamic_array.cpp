@@ -1,7 +1,25 @@
 #include <cstdlib>
+#include <memory_resource>
 
 #include "data_structures/dynamic_array.hpp"
 #include "gtest/gtest.h"
+#include "memory/arena.hpp"
+
+// Counts the live instances of itself to check which slots are constructed.
+struct Instance_Counter {
+  static inline int live = 0;
+
+  int value;
+
+  Instance_Counter(int value = 0) : value(value) { live++; }
+  Instance_Counter(const Instance_Counter& src) : value(src.value) { live++; }
+  Instance_Counter(Instance_Counter&& src) noexcept : value(src.value) {
+    live++;
+  }
+  Instance_Counter& operator=(const Instance_Counter&) = default;
+  Instance_Counter& operator=(Instance_Counter&&) noexcept = default;
+  ~Instance_Counter() { live--; }
+};
 
 // Tests the initial size of the Dynamic Array.
 TEST(DynamicArraySuite, InitialSize) {
@@ -103,3 +121,155 @@ TEST(DynamicArraySuite, RemoveData) {
 
   delete da;
 }
+
+// Tests appending to the end of the dynamic array.
+TEST(DynamicArraySuite, PushBackData) {
+  Dynamic_Array<std::string>* da = new Dynamic_Array<std::string>(1);
+
+  std::string copied = "copied";
+  da->push_back(copied);
+  da->push_back(std::string("moved"));
+  std::string& emplaced = da->emplace_back(3, 'x');
+
+  ASSERT_EQ(da->get_maximum_index(), 2);
+  ASSERT_EQ((*da)[0], "copied");
+  ASSERT_EQ((*da)[1], "moved");
+  ASSERT_EQ((*da)[2], "xxx");
+  ASSERT_EQ(&emplaced, &((*da)[2]));
+
+  // Inserting an element of the array into itself must not observe the shift.
+  da->insert((*da)[2], 0);
+  ASSERT_EQ((*da)[0], "xxx");
+  ASSERT_EQ((*da)[1], "copied");
+  ASSERT_EQ((*da)[3], "xxx");
+
+  delete da;
+}
+
+// Tests that reserving grows the dynamic array only once.
+TEST(DynamicArraySuite, Reserve) {
+  const std::size_t RESERVED_SIZE = 100;
+
+  Dynamic_Array<int>* da = new Dynamic_Array<int>();
+
+  da->reserve(RESERVED_SIZE);
+  ASSERT_EQ(da->get_size(), RESERVED_SIZE);
+
+  for (std::size_t i = 0; i < RESERVED_SIZE; i++) {
+    da->push_back(i);
+  }
+  ASSERT_EQ(da->get_size(), RESERVED_SIZE);
+
+  // Reserving less than the current size is a no-op.
+  da->reserve(1);
+  ASSERT_EQ(da->get_size(), RESERVED_SIZE);
+
+  // Iterating visits every element that contains data.
+  std::size_t sum = 0;
+  for (int element : *da) {
+    sum += element;
+  }
+  ASSERT_EQ(sum, (RESERVED_SIZE * (RESERVED_SIZE - 1)) / 2);
+
+  delete da;
+}
+
+// Tests appending elements to be filled in place.
+TEST(DynamicArraySuite, AppendForOverwrite) {
+  Dynamic_Array<int> da;
+  da.push_back(-1);
+
+  int* appended = da.append_for_overwrite(50);
+  ASSERT_EQ(da.get_maximum_index(), 50);
+  ASSERT_EQ(appended, da.begin() + 1);
+  for (int i = 0; i < 50; i++) {
+    appended[i] = i;
+  }
+  ASSERT_EQ(da[0], -1);
+  ASSERT_EQ(da[50], 49);
+
+  // Types with constructors are default-constructed.
+  Instance_Counter::live = 0;
+  {
+    Dynamic_Array<Instance_Counter> counters;
+    counters.append_for_overwrite(10);
+    ASSERT_EQ(Instance_Counter::live, 10);
+    ASSERT_EQ(counters[9].value, 0);
+  }
+  ASSERT_EQ(Instance_Counter::live, 0);
+
+  // Small appends grow the array geometrically rather than one append at a
+  // time.
+  Dynamic_Array<int> grown;
+  int reallocations = 0;
+  for (int i = 0; i < 10000; i++) {
+    int* before = grown.begin();
+    grown.append_for_overwrite(3);
+    if (grown.begin() != before) {
+      reallocations++;
+    }
+  }
+  ASSERT_EQ(grown.get_maximum_index(), 29999);
+  ASSERT_LT(reallocations, 30);
+}
+
+// Tests that only the elements that contain data are ever constructed.
+TEST(DynamicArraySuite, ConstructsOnlyLiveElements) {
+  Instance_Counter::live = 0;
+
+  {
+    Dynamic_Array<Instance_Counter> da(64);
+    ASSERT_EQ(Instance_Counter::live, 0);
+
+    for (int i = 0; i < 100; i++) {
+      da.emplace_back(i);
+    }
+    ASSERT_EQ(Instance_Counter::live, 100);
+
+    da.insert(Instance_Counter(-1), 50);
+    da.remove(0);
+    da.remove(10);
+    ASSERT_EQ(Instance_Counter::live, 99);
+    ASSERT_EQ(da[48].value, -1);
+
+    // Copies are deep; both arrays own their own elements.
+    Dynamic_Array<Instance_Counter> copy(da);
+    ASSERT_EQ(Instance_Counter::live, 198);
+    copy.replace(Instance_Counter(7), 0);
+    ASSERT_EQ(da[0].value, 1);
+  }
+
+  ASSERT_EQ(Instance_Counter::live, 0);
+}
+
+TEST(DynamicArraySuite, AllocatesFromMemoryResource) {
+  Arena arena;
+  Monotonic_Resource resource(arena);
+  {
+    lox_pmr::Dynamic_Array<Instance_Counter> da(&resource);
+    for (int i = 0; i < 100; i++) {
+      da.push_back(Instance_Counter(i));
+    }
+    ASSERT_GE(arena.get_bytes_used(), 100 * sizeof(Instance_Counter));
+    ASSERT_EQ(da.get_allocator().resource(), &resource);
+
+    // Copies use the default resource; moves keep the memory.
+    lox_pmr::Dynamic_Array<Instance_Counter> copy(da);
+    ASSERT_EQ(copy.get_allocator().resource(),
+              std::pmr::get_default_resource());
+    lox_pmr::Dynamic_Array<Instance_Counter> moved(std::move(da));
+    ASSERT_EQ(moved.get_allocator().resource(), &resource);
+    ASSERT_EQ(moved[99].value, 99);
+
+    // Moving into an array on another resource moves the elements instead.
+    copy = std::move(moved);
+    ASSERT_EQ(copy.get_allocator().resource(),
+              std::pmr::get_default_resource());
+    ASSERT_EQ(copy.get_maximum_index(), 99);
+    ASSERT_EQ(copy[42].value, 42);
+    ASSERT_EQ(moved.get_maximum_index(), -1);
+    ASSERT_EQ(Instance_Counter::live, 100);
+  }
+
+  ASSERT_EQ(Instance_Counter::live, 0);
+}
@@ -1,7 +1,12 @@
+#include <algorithm>
 #include <cstdlib>
+#include <memory_resource>
+#include <string>
+#include <vector>
 
 #include "data_structures/hash_table.hpp"
 #include "gtest/gtest.h"
+#include "memory/arena.hpp"
 
 TEST(HashTableSuite, InsertData) {
   const std::size_t NUM_OF_ELEMENTS_TO_INSERT = 11;
@@ -23,7 +28,6 @@ TEST(HashTableSuite, InsertData) {
   for (std::size_t i = 0; i < NUM_OF_ELEMENTS_TO_INSERT; i++) {
     int* ip = ht->search(inserted_keys[i]);
     EXPECT_EQ(*ip, inserted_values[i]);
-    delete ip;
   }
 
   delete ht;
@@ -44,11 +48,9 @@ TEST(HashTableSuite, RemoveData) {
 
   int* ip = ht->search("Bob");
   EXPECT_EQ(*ip, 2);
-  delete ip;
 
   ip = ht->search("David");
   EXPECT_EQ(*ip, 4);
-  delete ip;
 
   ht->remove("Bob");
   ht->remove("David");
@@ -61,3 +63,187 @@ TEST(HashTableSuite, RemoveData) {
 
   delete ht;
 }
+
+TEST(HashTableSuite, GrowthAndReuse) {
+  const int NUM_OF_ELEMENTS_TO_INSERT = 10000;
+
+  Hash_Table<int, int>* ht = new Hash_Table<int, int>;
+
+  for (int i = 0; i < NUM_OF_ELEMENTS_TO_INSERT; i++) {
+    ht->insert(i, i * 2);
+  }
+  ASSERT_EQ(ht->get_size(), (std::size_t)NUM_OF_ELEMENTS_TO_INSERT);
+
+  // Inserting an existing key leaves its value untouched.
+  ht->insert(5, -1);
+  int* ip = ht->search(5);
+  EXPECT_EQ(*ip, 10);
+
+  // Remove every even key, then make sure the odd keys are still found.
+  for (int i = 0; i < NUM_OF_ELEMENTS_TO_INSERT; i += 2) {
+    ht->remove(i);
+  }
+  ASSERT_EQ(ht->get_size(), (std::size_t)(NUM_OF_ELEMENTS_TO_INSERT / 2));
+
+  for (int i = 0; i < NUM_OF_ELEMENTS_TO_INSERT; i++) {
+    ip = ht->search(i);
+    if ((i % 2) == 0) {
+      EXPECT_EQ(ip, nullptr);
+    } else {
+      ASSERT_NE(ip, nullptr);
+      EXPECT_EQ(*ip, i * 2);
+    }
+  }
+
+  /* Churning through insertions and removals reuses deleted slots instead of
+  growing the table without bound. */
+  std::size_t capacity = ht->get_capacity();
+  for (int round = 0; round < 20; round++) {
+    for (int i = 0; i < NUM_OF_ELEMENTS_TO_INSERT; i += 2) {
+      ht->insert(NUM_OF_ELEMENTS_TO_INSERT + i, round);
+    }
+    for (int i = 0; i < NUM_OF_ELEMENTS_TO_INSERT; i += 2) {
+      ht->remove(NUM_OF_ELEMENTS_TO_INSERT + i);
+    }
+  }
+  EXPECT_EQ(ht->get_capacity(), capacity);
+
+  delete ht;
+}
+
+TEST(HashTableSuite, CopyAndReplace) {
+  Hash_Table<std::string, std::string> ht;
+
+  ht.insert("Alex", "one");
+  ht.insert("Bob", "two");
+
+  Hash_Table<std::string, std::string> copy(ht);
+  copy.replace("Alex", "uno");
+
+  std::string* sp = ht.search("Alex");
+  EXPECT_EQ(*sp, "one");
+
+  sp = copy.search("Alex");
+  EXPECT_EQ(*sp, "uno");
+
+  sp = copy.search("Bob");
+  EXPECT_EQ(*sp, "two");
+}
+
+TEST(HashTableSuite, BorrowedLookups) {
+  Hash_Table<std::string, int> ht;
+
+  // try_emplace only inserts keys that don't exist yet.
+  std::pair<int*, bool> result = ht.try_emplace("Alex", 1);
+  EXPECT_TRUE(result.second);
+  EXPECT_EQ(*(result.first), 1);
+
+  result = ht.try_emplace("Alex", 2);
+  EXPECT_FALSE(result.second);
+  EXPECT_EQ(*(result.first), 1);
+
+  // Values are returned by reference into the table, so they can be updated
+  // in place.
+  *(ht.search("Alex")) = 3;
+  EXPECT_EQ(ht.find("Alex"), 3);
+  ht.find("Alex")++;
+  EXPECT_EQ(*(ht.search("Alex")), 4);
+
+  // Keys can be looked up by views without building a std::string.
+  std::string source = "var Alex = 1;";
+  std::string_view view(source.data() + 4, 4);
+  EXPECT_TRUE(ht.contains(view));
+  EXPECT_FALSE(ht.contains(std::string_view(source.data(), 3)));
+
+  const Hash_Table<std::string, int>& const_ht = ht;
+  EXPECT_EQ(const_ht.find(view), 4);
+  EXPECT_EQ(const_ht.search("Bob"), nullptr);
+  EXPECT_THROW(const_ht.find("Bob"), std::out_of_range);
+}
+
+TEST(HashTableSuite, IncrementalRehash) {
+  const int NUM_OF_ELEMENTS_TO_INSERT = 3000;
+
+  Hash_Table<int, int> ht;
+  const Hash_Table<int, int>& const_ht = ht;
+  bool saw_rehash = false;
+
+  /* Every key inserted so far must stay visible while entries are being moved
+  out of the draining table. */
+  for (int i = 0; i < NUM_OF_ELEMENTS_TO_INSERT; i++) {
+    ht.insert(i, -i);
+    saw_rehash = saw_rehash || ht.is_rehashing();
+
+    if (ht.is_rehashing()) {
+      for (int j = 0; j <= i; j++) {
+        const int* ip = const_ht.search(j);
+        ASSERT_NE(ip, nullptr);
+        ASSERT_EQ(*ip, -j);
+      }
+      ASSERT_EQ(const_ht.search(i + 1), nullptr);
+    }
+  }
+  EXPECT_TRUE(saw_rehash);
+
+  // Removing keys that may still be in the draining table.
+  for (int i = 0; i < NUM_OF_ELEMENTS_TO_INSERT; i += 3) {
+    ht.remove(i);
+  }
+  for (int i = 0; i < NUM_OF_ELEMENTS_TO_INSERT; i++) {
+    EXPECT_EQ(ht.contains(i), (i % 3) != 0);
+  }
+  EXPECT_EQ(ht.get_size(), (std::size_t)(NUM_OF_ELEMENTS_TO_INSERT * 2 / 3));
+
+  // Copies are fully rehashed and independent.
+  Hash_Table<int, int> copy(ht);
+  EXPECT_FALSE(copy.is_rehashing());
+  EXPECT_EQ(copy.get_size(), ht.get_size());
+  ht.remove(1);
+  EXPECT_TRUE(copy.contains(1));
+}
+
+TEST(HashTableSuite, VisitsEveryEntry) {
+  Hash_Table<int, int> ht;
+  int sum = 0;
+  ht.for_each([&sum](const int&, const int&) { sum++; });
+  EXPECT_EQ(sum, 0);
+
+  /* Visiting while rehashing still sees each entry exactly once, whichever
+  table it is in. */
+  std::vector<int> seen(1000, 0);
+  for (int i = 0; i < 1000; i++) {
+    ht.insert(i, 2 * i);
+    if (ht.is_rehashing()) {
+      std::fill(seen.begin(), seen.end(), 0);
+      ht.for_each([&seen](const int& key, const int& value) {
+        EXPECT_EQ(value, 2 * key);
+        seen[key]++;
+      });
+      for (int j = 0; j < 1000; j++) {
+        ASSERT_EQ(seen[j], (j <= i) ? 1 : 0);
+      }
+    }
+  }
+}
+
+TEST(HashTableSuite, AllocatesFromMemoryResource) {
+  Arena arena;
+  Monotonic_Resource resource(arena);
+  lox_pmr::Hash_Table<std::string, int> ht(&resource);
+  for (int i = 0; i < 1000; i++) {
+    ht.insert(std::to_string(i), i);
+  }
+  ASSERT_GE(arena.get_bytes_used(), 1000 * sizeof(std::string));
+  ASSERT_EQ(ht.get_allocator().resource(), &resource);
+
+  // Moving into a table on another resource moves the entries instead.
+  lox_pmr::Hash_Table<std::string, int> other;
+  other = std::move(ht);
+  ASSERT_EQ(other.get_allocator().resource(),
+            std::pmr::get_default_resource());
+  ASSERT_EQ(other.get_size(), 1000u);
+  ASSERT_EQ(ht.get_size(), 0u);
+  for (int i = 0; i < 1000; i++) {
+    ASSERT_EQ(other.find(std::to_string(i)), i);
+  }
+}
@@ -1,7 +1,10 @@
 #include <cstdlib>
+#include <memory_resource>
+#include <string>
 
 #include "data_structures/linked_list.hpp"
 #include "gtest/gtest.h"
+#include "memory/arena.hpp"
 
 TEST(LinkedListSuite, InsertData) {
   const std::size_t NUM_OF_ELEMENTS_TO_INSERT = 11;
@@ -57,3 +60,113 @@ TEST(LinkedListSuite, RemoveData) {
 
   delete ll;
 }
+
+TEST(LinkedListSuite, AllocatesFromMemoryResource) {
+  Arena arena;
+  Monotonic_Resource resource(arena);
+  lox_pmr::Linked_List<std::string> ll(&resource);
+  for (int i = 0; i < 10; i++) {
+    ll.insert(std::to_string(i));
+  }
+  ASSERT_GE(arena.get_bytes_used(), 10 * sizeof(std::string));
+
+  lox_pmr::Linked_List<std::string> copy(ll);
+  ASSERT_EQ(copy.get_size(), 10u);
+  ASSERT_EQ(copy[9], "9");
+
+  // The nodes can't change resources, so their values are moved over.
+  copy.remove();
+  copy = std::move(ll);
+  ASSERT_EQ(copy.get_size(), 10u);
+  ASSERT_EQ(copy[9], "9");
+  ASSERT_EQ(ll.get_size(), 0u);
+}
+
+TEST(LinkedListSuite, IteratesBothWays) {
+  Linked_List<int> ll;
+  for (int i = 0; i < 100; i++) {
+    ll.insert(i);
+  }
+
+  int expected = 0;
+  for (int value : ll) {
+    ASSERT_EQ(value, expected++);
+  }
+  ASSERT_EQ(expected, 100);
+
+  auto it = ll.end();
+  for (int i = 99; i >= 0; i--) {
+    ASSERT_EQ(*--it, i);
+  }
+  ASSERT_EQ(it, ll.begin());
+
+  // Indexing from either end.
+  ASSERT_EQ(ll[0], 0);
+  ASSERT_EQ(ll[30], 30);
+  ASSERT_EQ(ll[70], 70);
+  ASSERT_EQ(ll[99], 99);
+  ASSERT_THROW(ll[100], std::out_of_range);
+}
+
+TEST(LinkedListSuite, EraseAndInsertAtIterators) {
+  Linked_List<int> ll;
+  for (int i = 0; i < 10; i++) {
+    ll.insert(i);
+  }
+
+  // Erase the odd values while iterating.
+  for (auto it = ll.begin(); it != ll.end();) {
+    if ((*it % 2) == 1) {
+      it = ll.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  ASSERT_EQ(ll.get_size(), 5u);
+  ASSERT_EQ(ll[4], 8);
+
+  auto inserted = ll.insert(ll.begin(), -1);
+  ASSERT_EQ(*inserted, -1);
+  ll.insert(ll.end(), 10);
+  ASSERT_EQ(ll[0], -1);
+  ASSERT_EQ(ll[6], 10);
+
+  // Erased nodes are reused.
+  ll.clear();
+  for (int i = 0; i < 10; i++) {
+    ll.insert(i);
+  }
+  ASSERT_EQ(ll.get_size(), 10u);
+}
+
+TEST(LinkedListSuite, Splice) {
+  Linked_List<std::string> a;
+  Linked_List<std::string> b;
+  a.insert("a0");
+  a.insert("a1");
+  b.insert("b0");
+  b.insert("b1");
+  b.remove(0);  // Leaves an unused node in b's pool.
+
+  // The nodes of b move into a, between a0 and a1.
+  a.splice(++a.begin(), b);
+  ASSERT_EQ(b.get_size(), 0u);
+  ASSERT_EQ(a.get_size(), 3u);
+  ASSERT_EQ(a[1], "b1");
+  ASSERT_EQ(*--a.end(), "a1");
+
+  // Within a list a single node is relinked.
+  a.splice(a.begin(), a, --a.end());
+  ASSERT_EQ(a[0], "a1");
+  ASSERT_EQ(a[2], "b1");
+
+  // From another list a single value is moved.
+  b.insert("c0");
+  a.splice(a.end(), b, b.begin());
+  ASSERT_EQ(a[3], "c0");
+  ASSERT_EQ(b.get_size(), 0u);
+
+  // b keeps working after handing over its nodes.
+  b.insert("d0");
+  ASSERT_EQ(b[0], "d0");
+}
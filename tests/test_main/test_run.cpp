@@ -0,0 +1,114 @@
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "error_reporter/error_reporter.hpp"
+#include "gtest/gtest.h"
+#include "main_functions.hpp"
+#include "source_file/source_file.hpp"
+#include "vm/vm.hpp"
+
+namespace {
+
+struct run_output {
+  std::string out;
+  std::string errors;
+};
+
+// Runs text, named name, with options and returns what it printed to stdout and
+// stderr.
+run_output run_text(const std::string& text, Error_Reporter& e,
+                    const Run_Options& options,
+                    const std::string& name = "") {
+  VM vm;
+  testing::internal::CaptureStdout();
+  testing::internal::CaptureStderr();
+  run(Source_File(text, name), e, vm, options);
+  run_output output;
+  output.out = testing::internal::GetCapturedStdout();
+  output.errors = testing::internal::GetCapturedStderr();
+  return output;
+}
+
+std::string temporary_path(const std::string& name) {
+  return (std::filesystem::temp_directory_path() /
+          ("jlox_in_cpp_" + std::to_string(getpid()) + "_" + name))
+      .string();
+}
+
+std::string read_file(const std::string& path) {
+  std::ifstream file(path, std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file),
+                     std::istreambuf_iterator<char>());
+}
+
+}  // namespace
+
+TEST(RunSuite, DumpsTheTree) {
+  Run_Options options;
+  options.dump_ast = true;
+
+  Error_Reporter e;
+  run_output output = run_text("print 1 + 2;", e, options);
+  EXPECT_EQ(output.out, "(print (+ 1 2))\n");
+  EXPECT_EQ(output.errors, "");
+  EXPECT_FALSE(e.had_error);
+}
+
+TEST(RunSuite, DumpsNoTreeWithSyntaxErrors) {
+  Run_Options options;
+  options.dump_ast = true;
+
+  Error_Reporter e;
+  run_output output = run_text("print 1;\nprint (2;\nprint 3;", e, options);
+  EXPECT_EQ(output.out, "");
+  EXPECT_EQ(output.errors,
+            "[line 2] Error at ';': Expect ')' after expression.\n");
+  EXPECT_TRUE(e.had_error);
+}
+
+TEST(RunSuite, RunsFromTheTokenCache) {
+  Run_Options options;
+  options.token_cache = true;
+  std::string name = temporary_path("run.lox");
+  std::string cache_path = name + ".lxtc";
+  std::string text = "var s = \"hello\"; print s; print 1 + 2;";
+
+  // The first run scans the source and writes the cache.
+  Error_Reporter e;
+  run_output output = run_text(text, e, options, name);
+  EXPECT_EQ(output.out, "hello\n3\n");
+  EXPECT_EQ(output.errors, "");
+  EXPECT_FALSE(e.had_error);
+
+  // The cache holds the string's text, so changing it there shows that the
+  // second run compiles from the cache rather than scanning again.
+  std::string cache = read_file(cache_path);
+  std::size_t hello = cache.rfind("hello");
+  ASSERT_NE(hello, std::string::npos);
+  cache[hello] = 'j';
+  std::ofstream(cache_path, std::ios::binary | std::ios::trunc) << cache;
+
+  output = run_text(text, e, options, name);
+  EXPECT_EQ(output.out, "jello\n3\n");
+  EXPECT_EQ(output.errors, "");
+  EXPECT_FALSE(e.had_error);
+
+  std::filesystem::remove(cache_path);
+}
+
+TEST(RunSuite, CachesNoTokensWithErrors) {
+  Run_Options options;
+  options.token_cache = true;
+  std::string name = temporary_path("errors.lox");
+
+  Error_Reporter e;
+  run_output output = run_text("print 1;\nprint \"open;", e, options, name);
+  EXPECT_EQ(output.out, "");
+  EXPECT_EQ(output.errors, "[line 2] Error: Unterminated string.\n");
+  EXPECT_TRUE(e.had_error);
+  EXPECT_FALSE(std::filesystem::exists(name + ".lxtc"));
+}
@@ -0,0 +1,83 @@
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "memory/arena.hpp"
+
+TEST(ArenaSuite, AllocationsAreAlignedAndDisjoint) {
+  Arena arena(64);
+  std::vector<char*> allocations;
+  for (std::size_t i = 1; i <= 200; i++) {
+    std::size_t alignment = std::size_t(1) << (i % 7);
+    char* memory = static_cast<char*>(arena.allocate(i, alignment));
+    EXPECT_EQ((uintptr_t)memory % alignment, 0u);
+    std::memset(memory, (int)i, i);
+    allocations.push_back(memory);
+  }
+
+  // Nothing was overwritten by a later allocation.
+  for (std::size_t i = 1; i <= 200; i++) {
+    EXPECT_EQ(allocations[i - 1][0], (char)i);
+    EXPECT_EQ(allocations[i - 1][i - 1], (char)i);
+  }
+  EXPECT_EQ(arena.get_bytes_used(), 200u * 201 / 2);
+}
+
+TEST(ArenaSuite, LargeAllocationsKeepTheCurrentBlock) {
+  Arena arena(128);
+  char* small = static_cast<char*>(arena.allocate(8, 8));
+  char* large = static_cast<char*>(arena.allocate(1 << 16, 64));
+  char* next = static_cast<char*>(arena.allocate(8, 8));
+
+  EXPECT_EQ((uintptr_t)large % 64, 0u);
+  EXPECT_EQ(next, small + 8);
+}
+
+TEST(ArenaSuite, CreateRunsDestructorsOnReset) {
+  static int destroyed = 0;
+  struct Counted {
+    int order;
+    ~Counted() {
+      EXPECT_EQ(order, destroyed);
+      destroyed++;
+    }
+  };
+
+  Arena arena;
+  for (int i = 2; i >= 0; i--) {
+    arena.create<Counted>(i);
+  }
+  std::string* text = arena.create<std::string>(100, 'x');
+  EXPECT_EQ(*text, std::string(100, 'x'));
+
+  arena.reset();
+  EXPECT_EQ(destroyed, 3);
+  EXPECT_EQ(arena.get_bytes_used(), 0u);
+
+  // The kept block is reused.
+  std::size_t reserved = arena.get_bytes_reserved();
+  arena.allocate(16);
+  EXPECT_EQ(arena.get_bytes_reserved(), reserved);
+}
+
+TEST(ArenaSuite, MonotonicResourceServesPmrContainers) {
+  Arena arena;
+  Monotonic_Resource resource(arena);
+  std::pmr::vector<int> numbers(&resource);
+  for (int i = 0; i < 1000; i++) {
+    numbers.push_back(i);
+  }
+
+  EXPECT_EQ(numbers[999], 999);
+  EXPECT_GE(arena.get_bytes_used(), 1000 * sizeof(int));
+
+  Monotonic_Resource same(arena);
+  Arena other_arena;
+  Monotonic_Resource other(other_arena);
+  EXPECT_TRUE(resource.is_equal(same));
+  EXPECT_FALSE(resource.is_equal(other));
+  EXPECT_FALSE(resource.is_equal(*std::pmr::new_delete_resource()));
+}
@@ -0,0 +1,236 @@
+#include <span>
+#include <string>
+
+#include "corpus/corpus_generator.hpp"
+#include "error_reporter/error_reporter.hpp"
+#include "gtest/gtest.h"
+#include "memory/arena.hpp"
+#include "parser/ast.hpp"
+#include "parser/ast_printer.hpp"
+#include "parser/parser.hpp"
+#include "scanner/scanner.hpp"
+#include "source_file/source_file.hpp"
+
+// Parses text and returns its syntax tree printed.
+static std::string parse(const std::string& text, Error_Reporter& e) {
+  Parser parser(Source_File(text), e);
+  Ast& ast = parser.parse();
+  return Ast_Printer(ast, parser.get_literals(), parser.get_symbols())
+      .print(ast.get_root());
+}
+
+// Parses text, which must have no errors.
+static std::string parse(const std::string& text) {
+  Error_Reporter e;
+  std::string printed = parse(text, e);
+  EXPECT_FALSE(e.had_error) << text;
+  return printed;
+}
+
+// Parses text and returns the errors reported.
+static std::string parse_errors(const std::string& text) {
+  Error_Reporter e;
+  testing::internal::CaptureStderr();
+  parse(text, e);
+  std::string errors = testing::internal::GetCapturedStderr();
+  EXPECT_TRUE(e.had_error) << text;
+  return errors;
+}
+
+TEST(AstSuite, StoresNodesAndLists) {
+  Ast ast;
+  EXPECT_EQ(ast.get_root(), Ast::NO_NODE);
+
+  Node_Id one = ast.add(Node_Kind::NK_NUMBER, 4, 0);
+  Node_Id two = ast.add(Node_Kind::NK_NUMBER, 8, 1);
+  Node_Id sum = ast.add(Node_Kind::NK_BINARY, 6, one, two, 0,
+                        Token_Type::TT_PLUS);
+  EXPECT_EQ(one, 0u);
+  EXPECT_EQ(sum, 2u);
+  EXPECT_EQ(ast.get(sum).op, Token_Type::TT_PLUS);
+  EXPECT_EQ(ast.get(sum).offset, 6u);
+  EXPECT_EQ(ast.get(sum).b, two);
+
+  uint32_t items[] = {one, two, sum};
+  uint32_t empty = ast.add_list(nullptr, 0);
+  uint32_t list = ast.add_list(items, 3);
+  EXPECT_EQ(ast.get_list(empty).size(), 0u);
+  ASSERT_EQ(ast.get_list(list).size(), 3u);
+  EXPECT_EQ(ast.get_list(list)[2], sum);
+
+  ast.set_root(sum);
+  ast.clear();
+  EXPECT_EQ(ast.get_size(), 0u);
+  EXPECT_EQ(ast.get_root(), Ast::NO_NODE);
+}
+
+TEST(ParserSuite, ParsesExpressionsByPrecedence) {
+  EXPECT_EQ(parse("1 + 2 * 3 - 4 / 5;"),
+            "(; (- (+ 1 (* 2 3)) (/ 4 5)))\n");
+  EXPECT_EQ(parse("!-a == b < c or d and e;"),
+            "(; (or (== (! (- a)) (< b c)) (and d e)))\n");
+  EXPECT_EQ(parse("a - b - c;"), "(; (- (- a b) c))\n");
+  EXPECT_EQ(parse("a or b or c;"), "(; (or (or a b) c))\n");
+  EXPECT_EQ(parse("a = b = c;"), "(; (= a (= b c)))\n");
+  EXPECT_EQ(parse("(1 + 2) * 3.5;"), "(; (* (group (+ 1 2)) 3.5))\n");
+  EXPECT_EQ(parse("a.b(c, d).e = f();"),
+            "(; (set (call (get a b) c d) e (call f)))\n");
+  EXPECT_EQ(parse("f(1)(2).g;"), "(; (get (call (call f 1) 2) g))\n");
+  EXPECT_EQ(parse("print \"a\" + nil != true >= false;"),
+            "(print (!= (+ \"a\" nil) (>= true false)))\n");
+}
+
+TEST(ParserSuite, ParsesStatements) {
+  EXPECT_EQ(parse("var a; var b = 1;"), "(var a)\n(var b 1)\n");
+  EXPECT_EQ(parse("{ print a; { } }"), "(block (print a) (block))\n");
+  EXPECT_EQ(parse("if (a) print 1; else if (b) print 2;"),
+            "(if a (print 1) (if b (print 2)))\n");
+
+  // The else belongs to the nearest if.
+  EXPECT_EQ(parse("if (a) if (b) print 1; else print 2;"),
+            "(if a (if b (print 1) (print 2)))\n");
+  EXPECT_EQ(parse("while (a < 3) a = a + 1;"),
+            "(while (< a 3) (; (= a (+ a 1))))\n");
+
+  // for loops are desugared into while loops.
+  EXPECT_EQ(parse("for (var i = 0; i < 3; i = i + 1) print i;"),
+            "(block (var i 0) (while (< i 3) (block (print i) "
+            "(; (= i (+ i 1))))))\n");
+  EXPECT_EQ(parse("for (;;) print 1;"), "(while true (print 1))\n");
+
+  EXPECT_EQ(parse("fun f(a, b) { return a + b; } fun g() { return; }"),
+            "(fun f (a b) (return (+ a b)))\n(fun g () (return))\n");
+  EXPECT_EQ(parse("class A < B { init(x) { this.x = x; } m() { "
+                  "return super.m(); } } class C {}"),
+            "(class A < B (fun init (x) (; (set this x x))) "
+            "(fun m () (return (call (super m)))))\n(class C)\n");
+}
+
+TEST(ParserSuite, ReportsSyntaxErrors) {
+  EXPECT_EQ(parse_errors("print ;"),
+            "[line 1] Error at ';': Expect expression.\n");
+  EXPECT_EQ(parse_errors("a + b = c;"),
+            "[line 1] Error at '=': Invalid assignment target.\n");
+  EXPECT_EQ(parse_errors("fun (a) {}"),
+            "[line 1] Error at '(': Expect function name.\n");
+  EXPECT_EQ(parse_errors("class A { m( }"),
+            "[line 1] Error at '}': Expect parameter name.\n");
+  EXPECT_EQ(parse_errors("{\nvar x = 1;\n"),
+            "[line 3] Error at end: Expect '}' after block.\n");
+
+  std::string arguments = "f(0";
+  for (int i = 1; i <= 255; i++) {
+    arguments += ", " + std::to_string(i);
+  }
+  EXPECT_EQ(parse_errors(arguments + ");"),
+            "[line 1] Error at '255': Can't have more than 255 arguments.\n");
+}
+
+TEST(ParserSuite, RecoversAtTheNextStatement) {
+  // Every statement with an error is reported and left out; the others are
+  // kept.
+  Error_Reporter e;
+  testing::internal::CaptureStderr();
+  std::string printed = parse(
+      "var = 1;\nprint 1;\nprint (2;\nfun f() { print ); print 3; }\n"
+      "print 4;",
+      e);
+  std::string errors = testing::internal::GetCapturedStderr();
+
+  EXPECT_TRUE(e.had_error);
+  EXPECT_EQ(printed, "(print 1)\n(fun f () (print 3))\n(print 4)\n");
+  EXPECT_EQ(errors,
+            "[line 1] Error at '=': Expect variable name.\n"
+            "[line 3] Error at ';': Expect ')' after expression.\n"
+            "[line 4] Error at ')': Expect expression.\n");
+}
+
+TEST(ParserSuite, LimitsNesting) {
+  // Nesting up to the limit parses; past it, an error is reported instead of
+  // overflowing the stack.
+  EXPECT_EQ(parse(Corpus_Generator::deep_nesting(1000)).substr(0, 14),
+            "(block (block ");
+
+  std::string deep = std::string(Parser::MAX_DEPTH + 1, '(') + "1" +
+                     std::string(Parser::MAX_DEPTH + 1, ')') + ";";
+  EXPECT_NE(parse_errors(deep).find("Too much nesting."), std::string::npos);
+}
+
+TEST(ParserSuite, LimitsFlatChains) {
+  // A chain of operators is parsed in a loop but builds a tree as deep as the
+  // chain is long, so it counts against the same limit.
+  auto chain = [](const std::string& first, const std::string& link,
+                  std::size_t length) {
+    std::string text = "print " + first;
+    for (std::size_t i = 0; i < length; i++) {
+      text += link;
+    }
+    return text + ";";
+  };
+
+  EXPECT_EQ(parse(chain("1", " + 1", 1000)).substr(0, 20),
+            "(print (+ (+ (+ (+ (");
+  EXPECT_EQ(parse(chain("f", "()", 1000)).substr(0, 24),
+            "(print (call (call (call");
+
+  for (const char* link : {" + 1", "()", ".a"}) {
+    std::string errors = parse_errors(chain("x", link, 100000));
+    EXPECT_NE(errors.find("Too much nesting."), std::string::npos) << link;
+  }
+}
+
+TEST(ParserSuite, ParsesGeneratedCorpora) {
+  // Generated programs are syntactically valid, so they parse without errors.
+  for (uint64_t seed = 1; seed <= 4; seed++) {
+    std::string text;
+    Corpus_Generator(seed).generate(text, 1 << 18);
+
+    Error_Reporter e;
+    Parser parser(Source_File(text), e);
+    Ast& ast = parser.parse();
+    EXPECT_FALSE(e.had_error) << seed;
+
+    const Ast_Node& root = ast.get(ast.get_root());
+    EXPECT_EQ(root.kind, Node_Kind::NK_PROGRAM);
+    EXPECT_GT(ast.get_list(root.a).size(), 100u);
+
+    // Printing visits every node of the tree.
+    std::string printed =
+        Ast_Printer(ast, parser.get_literals(), parser.get_symbols())
+            .print(ast.get_root());
+    EXPECT_GT(printed.size(), text.size() / 4);
+  }
+}
+
+TEST(ParserSuite, AllocatesFromArena) {
+  Arena arena;
+  Monotonic_Resource resource(arena);
+  Error_Reporter e;
+
+  std::string text;
+  Corpus_Generator(7).generate(text, 1 << 16);
+  Parser parser(Source_File(text), e, &resource);
+  Ast& ast = parser.parse();
+
+  EXPECT_FALSE(e.had_error);
+  EXPECT_GE(arena.get_bytes_used(), ast.get_size() * sizeof(Ast_Node));
+}
+
+TEST(ParserSuite, ParsesScannedTokens) {
+  std::string text;
+  Corpus_Generator(3).generate(text, 1 << 16);
+  Source_File source(text);
+
+  Error_Reporter e;
+  Scanner s(source, e);
+  Token_Array& tokens = s.scan_tokens();
+  Parser parser(source, std::span<const Token>(tokens.begin(), tokens.end()),
+                s.get_literals(), s.get_symbols(), e);
+  Ast& ast = parser.parse();
+  EXPECT_FALSE(e.had_error);
+
+  // The tree is the same as when the parser scans the source itself.
+  EXPECT_EQ(Ast_Printer(ast, parser.get_literals(), parser.get_symbols())
+                .print(ast.get_root()),
+            parse(text));
+}
@@ -0,0 +1,148 @@
+#include <stdint.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "corpus/corpus_generator.hpp"
+#include "error_reporter/error_reporter.hpp"
+#include "gtest/gtest.h"
+#include "scanner/byte_scan.hpp"
+#include "scanner/scanner.hpp"
+#include "source_file/source_file.hpp"
+
+// The kernels the CPU running the tests supports, other than the scalar ones.
+static std::vector<const lox_byte_scan::Kernels*> vector_kernels() {
+  std::vector<const lox_byte_scan::Kernels*> kernels;
+  if (lox_byte_scan::sse42() != nullptr) {
+    kernels.push_back(lox_byte_scan::sse42());
+  }
+  if (lox_byte_scan::avx2() != nullptr) {
+    kernels.push_back(lox_byte_scan::avx2());
+  }
+  return kernels;
+}
+
+// Random text made mostly of the bytes the kernels stop at or skip over.
+static std::string random_text(std::mt19937& rng, std::size_t length) {
+  const char alphabet[] = "  \t\r\n\n\"\"aZz_09/.;(\x80\xff";
+  std::uniform_int_distribution<std::size_t> pick(0, sizeof(alphabet) - 2);
+  std::uniform_int_distribution<int> run(0, 40);
+
+  std::string text;
+  while (text.size() < length) {
+    // Long runs of one byte exercise whole blocks.
+    text.append(run(rng), alphabet[pick(rng)]);
+  }
+  text.resize(length);
+  return text;
+}
+
+TEST(ByteScanSuite, KernelsMatchScalar) {
+  const lox_byte_scan::Kernels& scalar = lox_byte_scan::scalar();
+  std::mt19937 rng(42);
+
+  for (const lox_byte_scan::Kernels* kernels : vector_kernels()) {
+    for (int trial = 0; trial < 200; trial++) {
+      std::string text = random_text(rng, 160);
+
+      // Every start offset and length, so that every block alignment and
+      // tail length is covered.
+      for (std::size_t start = 0; start < 40; start++) {
+        const char* p = text.data() + start;
+        std::size_t length = text.size() - start - (trial % 37);
+
+        uint64_t expected_newlines = 0;
+        uint64_t newlines = 0;
+        EXPECT_EQ(kernels->skip_whitespace(p, length, newlines),
+                  scalar.skip_whitespace(p, length, expected_newlines))
+            << kernels->name;
+        EXPECT_EQ(newlines, expected_newlines) << kernels->name;
+
+        EXPECT_EQ(kernels->find_newline(p, length),
+                  scalar.find_newline(p, length))
+            << kernels->name;
+
+        expected_newlines = 0;
+        newlines = 0;
+        EXPECT_EQ(kernels->find_quote(p, length, newlines),
+                  scalar.find_quote(p, length, expected_newlines))
+            << kernels->name;
+        EXPECT_EQ(newlines, expected_newlines) << kernels->name;
+
+        EXPECT_EQ(kernels->skip_identifier(p, length),
+                  scalar.skip_identifier(p, length))
+            << kernels->name;
+      }
+    }
+  }
+}
+
+TEST(ByteScanSuite, NoBytesPastTheEnd) {
+  // The text ends right before bytes that would change every result.
+  std::string text(64, ' ');
+  text += "x\n\"";
+  for (const lox_byte_scan::Kernels* kernels : vector_kernels()) {
+    uint64_t newlines = 0;
+    EXPECT_EQ(kernels->skip_whitespace(text.data(), 64, newlines), 64u);
+    EXPECT_EQ(kernels->find_newline(text.data(), 64), 64u);
+    EXPECT_EQ(kernels->find_quote(text.data(), 64, newlines), 64u);
+    EXPECT_EQ(newlines, 0u);
+  }
+}
+
+// Scans source with the given kernels and returns a description of the tokens
+// and errors.
+static std::string scan(const Source_File& source,
+                        const lox_byte_scan::Kernels& kernels) {
+  Error_Reporter e;
+  testing::internal::CaptureStderr();
+  Scanner s(source, e, kernels);
+  Token_Array& tokens = s.scan_tokens();
+  std::string result = testing::internal::GetCapturedStderr();
+
+  for (const Token& token : tokens) {
+    result += token.to_string(source.get_contents());
+    result += " line: " + std::to_string(source.get_line(token.get_offset()));
+    if (token.get_type() == Token_Type::TT_NUMBER) {
+      double value = s.get_literals().get_number(token.get_literal());
+      result += " value: " + std::to_string(value);
+    }
+    result += "\n";
+  }
+  return result;
+}
+
+TEST(ByteScanSuite, ScannerMatchesScalar) {
+  std::string text;
+  for (int i = 0; i < 50; i++) {
+    text += "// A comment that is long enough to span a few blocks, " +
+            std::to_string(i) + "\n";
+    text += "var identifier_number_" + std::to_string(i) +
+            " = \"a string\nspanning\n\nlines\"   +\t\t" + std::to_string(i) +
+            ".5;\r\n";
+    text += "    \n\n  fun f(a, b) { return a >= b and !nil; } @ #\n";
+  }
+  text += "\"unterminated\n string";
+
+  Source_File source(std::move(text));
+  std::string expected = scan(source, lox_byte_scan::scalar());
+  for (const lox_byte_scan::Kernels* kernels : vector_kernels()) {
+    EXPECT_EQ(scan(source, *kernels), expected) << kernels->name;
+  }
+}
+
+TEST(ByteScanSuite, ScannerMatchesScalarOnGeneratedCorpus) {
+  Corpus_Generator::Mix mix;
+  mix.comments = 6;
+  mix.multi_line_strings = 4;
+
+  std::string text;
+  Corpus_Generator(23, mix).generate(text, 1 << 16);
+  Source_File source(std::move(text));
+
+  std::string expected = scan(source, lox_byte_scan::scalar());
+  for (const lox_byte_scan::Kernels* kernels : vector_kernels()) {
+    EXPECT_EQ(scan(source, *kernels), expected) << kernels->name;
+  }
+}
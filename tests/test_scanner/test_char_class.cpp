@@ -0,0 +1,31 @@
+#include "gtest/gtest.h"
+#include "scanner/char_class.hpp"
+
+using lox_char_class::Char_Class;
+
+// Classification is a constant expression.
+static_assert(lox_char_class::info('>').with_equal ==
+              Token_Type::TT_GREATER_EQUAL);
+static_assert(lox_char_class::is_alpha_numeric('_'));
+
+TEST(CharClassSuite, ClassifiesEveryByte) {
+  for (int i = 0; i < 256; i++) {
+    char c = (char)i;
+    bool digit = ((c >= '0') && (c <= '9'));
+    bool alpha = (((c >= 'a') && (c <= 'z')) || ((c >= 'A') && (c <= 'Z')) ||
+                  (c == '_'));
+
+    EXPECT_EQ(lox_char_class::is_digit(c), digit) << i;
+    EXPECT_EQ(lox_char_class::is_alpha_numeric(c), digit || alpha) << i;
+    EXPECT_EQ(lox_char_class::info(c).char_class == Char_Class::ALPHA, alpha)
+        << i;
+  }
+
+  EXPECT_EQ(lox_char_class::info('\n').char_class, Char_Class::WHITESPACE);
+  EXPECT_EQ(lox_char_class::info('"').char_class, Char_Class::QUOTE);
+  EXPECT_EQ(lox_char_class::info('@').char_class, Char_Class::INVALID);
+  EXPECT_EQ(lox_char_class::info('\x80').char_class, Char_Class::INVALID);
+  EXPECT_EQ(lox_char_class::info(';').single, Token_Type::TT_SEMICOLON);
+  EXPECT_EQ(lox_char_class::info('!').single, Token_Type::TT_BANG);
+  EXPECT_EQ(lox_char_class::info('!').with_equal, Token_Type::TT_BANG_EQUAL);
+}
@@ -0,0 +1,34 @@
+#include <string>
+
+#include "gtest/gtest.h"
+#include "scanner/keywords.hpp"
+
+// Keyword classification is a constant expression.
+static_assert(keyword_or_identifier("while") == Token_Type::TT_WHILE);
+static_assert(keyword_or_identifier("whale") == Token_Type::TT_IDENTIFIER);
+
+TEST(KeywordsSuite, RecognizesEveryKeyword) {
+#define TOKEN(name)
+#define KEYWORD(name, spelling) \
+  EXPECT_EQ(keyword_or_identifier(spelling), Token_Type::name);
+  LOX_TOKEN_TYPES(TOKEN, KEYWORD)
+#undef KEYWORD
+#undef TOKEN
+}
+
+TEST(KeywordsSuite, RejectsNonKeywords) {
+  const char* identifiers[] = {"a",     "an",   "andy",   "And",  "classy",
+                               "els",   "fals", "fn",     "fort", "i",
+                               "nill",  "o",    "printf", "ret",  "superb",
+                               "these", "tru",  "vars",   "whil", "_while"};
+
+  for (const char* identifier : identifiers) {
+    EXPECT_EQ(keyword_or_identifier(identifier), Token_Type::TT_IDENTIFIER)
+        << identifier;
+  }
+
+  // Lexemes are views into the source, so they aren't null-terminated.
+  std::string source = "fortune";
+  EXPECT_EQ(keyword_or_identifier(std::string_view(source.data(), 3)),
+            Token_Type::TT_FOR);
+}
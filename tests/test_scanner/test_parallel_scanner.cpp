@@ -0,0 +1,107 @@
+#include <string>
+
+#include "corpus/corpus_generator.hpp"
+#include "error_reporter/error_reporter.hpp"
+#include "gtest/gtest.h"
+#include "scanner/parallel_scanner.hpp"
+#include "scanner/scanner.hpp"
+#include "source_file/source_file.hpp"
+
+// Lines that put chunk boundaries inside strings, comments that contain quotes
+// and strings that contain "//".
+static std::string tricky_source() {
+  std::string text;
+  for (int i = 0; i < 40; i++) {
+    text += "var s" + std::to_string(i) + " = \"line one\n";
+    text += "line two // not a comment\n";
+    text += "\n";
+    text += "line four\"; // a comment with a \" quote\n";
+    text += "print s" + std::to_string(i) + " + " + std::to_string(i) +
+            ".5 >= 3; # @\n";
+    text += "// \"\n";
+    text += "x = \"a\" + \"//\"; y = \"b\" // \"c\n";
+  }
+  text += "print \"unterminated\n\n";
+  return text;
+}
+
+TEST(ParallelScannerSuite, MatchesScanner) {
+  Source_File source(tricky_source());
+  std::string_view contents = source.get_contents();
+
+  Error_Reporter expected_errors;
+  testing::internal::CaptureStderr();
+  Scanner s(source, expected_errors);
+  Token_Array& expected = s.scan_tokens();
+  std::string expected_output = testing::internal::GetCapturedStderr();
+  ASSERT_TRUE(expected_errors.had_error);
+
+  for (std::size_t chunks = 1; chunks <= 64; chunks++) {
+    Error_Reporter errors;
+    testing::internal::CaptureStderr();
+    Parallel_Scanner p(source, errors, chunks);
+    Token_Array& tokens = p.scan_tokens();
+    EXPECT_EQ(testing::internal::GetCapturedStderr(), expected_output)
+        << chunks;
+    EXPECT_TRUE(errors.had_error);
+
+    ASSERT_EQ(tokens.get_maximum_index(), expected.get_maximum_index())
+        << chunks;
+    for (int i = 0; i <= tokens.get_maximum_index(); i++) {
+      EXPECT_EQ(tokens[i].get_type(), expected[i].get_type()) << chunks << i;
+      EXPECT_EQ(tokens[i].get_lexeme(contents),
+                expected[i].get_lexeme(contents))
+          << chunks << i;
+      if (tokens[i].get_type() == Token_Type::TT_NUMBER) {
+        EXPECT_EQ(p.get_literals().get_number(tokens[i].get_literal()),
+                  s.get_literals().get_number(expected[i].get_literal()))
+            << chunks << i;
+      } else {
+        EXPECT_EQ(tokens[i].get_literal(), expected[i].get_literal())
+            << chunks << i;
+      }
+    }
+  }
+}
+
+TEST(ParallelScannerSuite, MatchesScannerOnGeneratedCorpus) {
+  std::string text;
+  Corpus_Generator(19).generate(text, 1 << 18);
+  Source_File source(std::move(text));
+  std::string_view contents = source.get_contents();
+
+  Error_Reporter e;
+  Scanner s(source, e);
+  Token_Array& expected = s.scan_tokens();
+
+  for (std::size_t chunks : {2, 7, 32}) {
+    Parallel_Scanner p(source, e, chunks);
+    Token_Array& tokens = p.scan_tokens();
+
+    ASSERT_EQ(tokens.get_maximum_index(), expected.get_maximum_index())
+        << chunks;
+    for (int i = 0; i <= tokens.get_maximum_index(); i++) {
+      ASSERT_EQ(tokens[i].get_type(), expected[i].get_type()) << chunks << i;
+      ASSERT_EQ(tokens[i].get_lexeme(contents),
+                expected[i].get_lexeme(contents))
+          << chunks << i;
+      if (tokens[i].get_type() != Token_Type::TT_NUMBER) {
+        ASSERT_EQ(tokens[i].get_literal(), expected[i].get_literal())
+            << chunks << i;
+      }
+    }
+    EXPECT_EQ(p.get_symbols().get_size(), s.get_symbols().get_size());
+  }
+  EXPECT_FALSE(e.had_error);
+}
+
+TEST(ParallelScannerSuite, ScansEmptySource) {
+  Error_Reporter e;
+  Source_File source(std::string(""));
+  Parallel_Scanner p(source, e, 4);
+  Token_Array& tokens = p.scan_tokens();
+
+  ASSERT_EQ(tokens.get_maximum_index(), 0);
+  EXPECT_EQ(tokens[0].get_type(), Token_Type::TT_EOF);
+  EXPECT_FALSE(e.had_error);
+}
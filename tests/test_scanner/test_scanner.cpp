@@ -0,0 +1,273 @@
+#include <stdlib.h>
+
+#include <bit>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "error_reporter/error_reporter.hpp"
+#include "gtest/gtest.h"
+#include "memory/arena.hpp"
+#include "scanner/scanner.hpp"
+#include "source_file/source_file.hpp"
+
+TEST(ScannerSuite, ScansTokens) {
+  Error_Reporter e;
+  Source_File source("var answer = (40 + 2.5) >= \"forty\";\n// comment\nnil");
+  Scanner s(source, e);
+  Token_Array& tokens = s.scan_tokens();
+
+  const Token_Type expected_types[] = {
+      Token_Type::TT_VAR,         Token_Type::TT_IDENTIFIER,
+      Token_Type::TT_EQUAL,       Token_Type::TT_LEFT_PAREN,
+      Token_Type::TT_NUMBER,      Token_Type::TT_PLUS,
+      Token_Type::TT_NUMBER,      Token_Type::TT_RIGHT_PAREN,
+      Token_Type::TT_GREATER_EQUAL,
+      Token_Type::TT_STRING,      Token_Type::TT_SEMICOLON,
+      Token_Type::TT_NIL,         Token_Type::TT_EOF};
+  const int expected_count = sizeof(expected_types) / sizeof(Token_Type);
+
+  ASSERT_EQ(tokens.get_maximum_index() + 1, expected_count);
+  for (int i = 0; i < expected_count; i++) {
+    EXPECT_EQ(tokens[i].get_type(), expected_types[i]) << i;
+  }
+
+  std::string_view contents = source.get_contents();
+  const Literal_Table& literals = s.get_literals();
+  EXPECT_EQ(tokens[1].get_lexeme(contents), "answer");
+  EXPECT_EQ(literals.get_number(tokens[4].get_literal()), 40.0);
+  EXPECT_EQ(literals.get_number(tokens[6].get_literal()), 2.5);
+  EXPECT_EQ(tokens[9].get_lexeme(contents), "\"forty\"");
+  EXPECT_EQ(source.get_line(tokens[0].get_offset()), 1u);
+  EXPECT_EQ(source.get_line(tokens[11].get_offset()), 3u);
+  EXPECT_EQ(source.get_line(tokens[12].get_offset()), 3u);
+  EXPECT_FALSE(e.had_error);
+}
+
+TEST(ScannerSuite, LexemesReferToTheSourceBuffer) {
+  Error_Reporter e;
+  std::unique_ptr<Scanner> s;
+  Token_Array* tokens;
+  std::string_view contents;
+
+  {
+    // The scanner keeps its own handle to the buffer, so the lexemes outlive
+    // the Source_File they were scanned from.
+    Source_File source(std::string("print identifier_longer_than_sso;"));
+    contents = source.get_contents();
+    s = std::make_unique<Scanner>(source, e);
+    tokens = &(s->scan_tokens());
+  }
+
+  for (const Token& token : *tokens) {
+    std::string_view lexeme = token.get_lexeme(contents);
+    if (!lexeme.empty()) {
+      EXPECT_GE(lexeme.data(), contents.data());
+      EXPECT_LE(lexeme.data() + lexeme.size(),
+                contents.data() + contents.size());
+    }
+  }
+  EXPECT_EQ((*tokens)[1].get_lexeme(contents), "identifier_longer_than_sso");
+}
+
+TEST(ScannerSuite, LinesOfOffsets) {
+  Source_File source(std::string("a\n\nbc\n"));
+
+  EXPECT_EQ(source.get_line(0), 1u);
+  EXPECT_EQ(source.get_line(1), 1u);
+  EXPECT_EQ(source.get_line(2), 2u);
+  EXPECT_EQ(source.get_line(3), 3u);
+  EXPECT_EQ(source.get_line(5), 3u);
+  EXPECT_EQ(source.get_line(6), 4u);
+}
+
+TEST(ScannerSuite, MaximalMunch) {
+  Error_Reporter e;
+  Source_File source(std::string("!=!===<=<>=>/ /=//!=\n="));
+  Scanner s(source, e);
+  Token_Array& tokens = s.scan_tokens();
+
+  const Token_Type expected_types[] = {
+      Token_Type::TT_BANG_EQUAL,  Token_Type::TT_BANG_EQUAL,
+      Token_Type::TT_EQUAL_EQUAL, Token_Type::TT_LESS_EQUAL,
+      Token_Type::TT_LESS,        Token_Type::TT_GREATER_EQUAL,
+      Token_Type::TT_GREATER,     Token_Type::TT_SLASH,
+      Token_Type::TT_SLASH,       Token_Type::TT_EQUAL,
+      Token_Type::TT_EQUAL,       Token_Type::TT_EOF};
+  const int expected_count = sizeof(expected_types) / sizeof(Token_Type);
+
+  ASSERT_EQ(tokens.get_maximum_index() + 1, expected_count);
+  for (int i = 0; i < expected_count; i++) {
+    EXPECT_EQ(tokens[i].get_type(), expected_types[i]) << i;
+  }
+}
+
+TEST(ScannerSuite, NextTokenMatchesScanTokens) {
+  Error_Reporter e;
+  Source_File source(std::string("fun f(a) { return a * 2.5 <= 10; }"));
+  Scanner all(source, e);
+  Token_Array& tokens = all.scan_tokens();
+
+  Scanner pulled(source, e);
+  int i = 0;
+  for (const Token& token : pulled) {
+    ASSERT_LE(i, tokens.get_maximum_index());
+    EXPECT_EQ(token.get_type(), tokens[i].get_type()) << i;
+    EXPECT_EQ(token.get_offset(), tokens[i].get_offset()) << i;
+    i++;
+  }
+  EXPECT_EQ(i, tokens.get_maximum_index() + 1);
+
+  // The scanner has nothing left after TT_EOF.
+  Token token;
+  EXPECT_FALSE(pulled.next_token(token));
+}
+
+TEST(ScannerSuite, ChunkedInputResumesMidToken) {
+  const std::string text =
+      "var orchid = 12.75; // a comment\n"
+      "print \"multi\nline\" != orchid / 3;\n"
+      "if (x >= 1) { y = 22; }";
+
+  Error_Reporter e;
+  Source_File source(text);
+  Scanner whole(source, e);
+  Token_Array& expected = whole.scan_tokens();
+
+  // Every piece size splits some token, down to one byte at a time.
+  for (std::size_t piece = 1; piece <= text.length(); piece++) {
+    Scanner s(e);
+    int i = 0;
+    auto check = [&]() {
+      for (const Token& token : s) {
+        ASSERT_LE(i, expected.get_maximum_index()) << piece;
+        EXPECT_EQ(token.get_type(), expected[i].get_type()) << piece << i;
+        EXPECT_EQ(token.get_lexeme(s.get_text()),
+                  expected[i].get_lexeme(text))
+            << piece << i;
+        if (token.get_type() == Token_Type::TT_NUMBER) {
+          EXPECT_EQ(s.get_literals().get_number(token.get_literal()),
+                    whole.get_literals().get_number(expected[i].get_literal()))
+              << piece << i;
+        } else {
+          EXPECT_EQ(token.get_literal(), expected[i].get_literal())
+              << piece << i;
+        }
+        i++;
+      }
+    };
+
+    for (std::size_t offset = 0; offset < text.length(); offset += piece) {
+      s.feed(std::string_view(text).substr(offset, piece));
+      check();
+    }
+    s.finish();
+    check();
+
+    EXPECT_EQ(i, expected.get_maximum_index() + 1) << piece;
+    EXPECT_EQ(s.get_symbols().get_size(), whole.get_symbols().get_size())
+        << piece;
+  }
+  EXPECT_FALSE(e.had_error);
+}
+
+TEST(ScannerSuite, InternsNamesAndStrings) {
+  Error_Reporter e;
+  Source_File source("var a = b + a; print \"a\" + \"\" + b + \"a b\";");
+  Scanner s(source, e);
+  Token_Array& tokens = s.scan_tokens();
+  const String_Interner& symbols = s.get_symbols();
+
+  // Identifiers and strings with the same text share a symbol.
+  ASSERT_EQ(tokens.get_maximum_index(), 16);
+  EXPECT_EQ(tokens[1].get_literal(), tokens[5].get_literal());
+  EXPECT_EQ(tokens[3].get_literal(), tokens[12].get_literal());
+  EXPECT_EQ(tokens[8].get_literal(), tokens[1].get_literal());
+  EXPECT_EQ(symbols.get_size(), 4u);
+  EXPECT_EQ(symbols.get_string(tokens[1].get_literal()), "a");
+  EXPECT_EQ(symbols.get_string(tokens[3].get_literal()), "b");
+  EXPECT_EQ(symbols.get_string(tokens[10].get_literal()), "");
+  EXPECT_EQ(symbols.get_string(tokens[14].get_literal()), "a b");
+  EXPECT_FALSE(e.had_error);
+}
+
+TEST(ScannerSuite, ScansIntoAnArena) {
+  Arena arena;
+  Monotonic_Resource resource(arena);
+  Error_Reporter e;
+  Source_File source("var x = 1.5 + 2;");
+  Scanner s(source, e, lox_byte_scan::best(), &resource);
+  Token_Array& tokens = s.scan_tokens();
+
+  ASSERT_EQ(tokens.get_maximum_index(), 7);
+  EXPECT_EQ(tokens.get_allocator().resource(), &resource);
+  EXPECT_EQ(s.get_literals().get_number(tokens[5].get_literal()), 2.0);
+  EXPECT_GE(arena.get_bytes_used(), 8 * sizeof(Token));
+}
+
+// Compares the numbers the scanner parses, bit for bit, with strtod, which
+// rounds correctly; the literals cover the integer fast path, the cut-off at
+// 2^53, halfway cases and lexemes too long for either.
+TEST(ScannerSuite, NumbersRoundCorrectly) {
+  std::vector<std::string> lexemes = {
+      "0",
+      "7",
+      "9007199254740991",
+      "9007199254740992",
+      "9007199254740993",
+      "9007199254740995",
+      "18446744073709551615",
+      "18446744073709551616",
+      "123456789012345678901234567890",
+      "0.1",
+      "0.30000000000000004",
+      "2.5",
+      "1.00000000000000011102230246251565404236316680908203125",
+      "1.00000000000000011102230246251565404236316680908203124",
+      "4503599627370496.5",
+      "4503599627370497.5",
+      "000000000000000000000000000012.5"};
+
+  std::mt19937_64 rng(21);
+  for (int i = 0; i < 2000; i++) {
+    std::string lexeme = std::to_string(rng() >> (rng() % 64));
+    if (i % 2 == 0) {
+      lexeme += "." + std::to_string(rng());
+    }
+    lexemes.push_back(lexeme);
+  }
+
+  std::string text;
+  for (const std::string& lexeme : lexemes) {
+    text += lexeme + " ";
+  }
+
+  Error_Reporter e;
+  Source_File source(std::move(text));
+  Scanner s(source, e);
+  Token_Array& tokens = s.scan_tokens();
+  ASSERT_EQ(tokens.get_maximum_index(), (int)lexemes.size());
+
+  for (std::size_t i = 0; i < lexemes.size(); i++) {
+    double value = s.get_literals().get_number(tokens[i].get_literal());
+    double expected = strtod(lexemes[i].c_str(), nullptr);
+    EXPECT_EQ(std::bit_cast<uint64_t>(value), std::bit_cast<uint64_t>(expected))
+        << lexemes[i];
+  }
+}
+
+TEST(ScannerSuite, NumbersOutOfRange) {
+  Error_Reporter e;
+  Source_File source(std::string(400, '9') + " 0." + std::string(400, '0') +
+                     "1");
+  Scanner s(source, e);
+  Token_Array& tokens = s.scan_tokens();
+
+  ASSERT_EQ(tokens.get_maximum_index(), 2);
+  EXPECT_TRUE(std::isinf(s.get_literals().get_number(tokens[0].get_literal())));
+  EXPECT_EQ(s.get_literals().get_number(tokens[1].get_literal()), 0.0);
+  EXPECT_FALSE(e.had_error);
+}
@@ -0,0 +1,69 @@
+#include <span>
+#include <stdexcept>
+#include <string>
+
+#include "error_reporter/error_reporter.hpp"
+#include "gtest/gtest.h"
+#include "scanner/scanner.hpp"
+#include "scanner/token_stream.hpp"
+#include "source_file/source_file.hpp"
+
+TEST(TokenStreamSuite, PeeksWithoutConsuming) {
+  Error_Reporter e;
+  Source_File source(std::string("a = b + c;"));
+  Scanner s(source, e);
+  Token_Stream<4> stream(s);
+
+  EXPECT_EQ(stream.peek(3).get_type(), Token_Type::TT_PLUS);
+  EXPECT_EQ(stream.peek(0).get_type(), Token_Type::TT_IDENTIFIER);
+  EXPECT_THROW(stream.peek(4), std::out_of_range);
+
+  EXPECT_TRUE(stream.match(Token_Type::TT_IDENTIFIER));
+  EXPECT_FALSE(stream.match(Token_Type::TT_PLUS));
+  EXPECT_TRUE(stream.check(Token_Type::TT_EQUAL));
+
+  // The ring wraps around as tokens are consumed.
+  const Token_Type rest[] = {Token_Type::TT_EQUAL, Token_Type::TT_IDENTIFIER,
+                             Token_Type::TT_PLUS, Token_Type::TT_IDENTIFIER,
+                             Token_Type::TT_SEMICOLON};
+  for (Token_Type type : rest) {
+    EXPECT_EQ(stream.peek(0).get_type(), type);
+    EXPECT_EQ(stream.advance().get_type(), type);
+  }
+  EXPECT_EQ(stream.advance().get_type(), Token_Type::TT_EOF);
+}
+
+TEST(TokenStreamSuite, RepeatsEndOfFile) {
+  Error_Reporter e;
+  Source_File source(std::string("x"));
+  Scanner s(source, e);
+  Token_Stream<2> stream(s);
+
+  EXPECT_EQ(stream.advance().get_type(), Token_Type::TT_IDENTIFIER);
+  for (int i = 0; i < 3; i++) {
+    Token eof = stream.advance();
+    EXPECT_EQ(eof.get_type(), Token_Type::TT_EOF);
+    EXPECT_EQ(eof.get_offset(), 1u);
+  }
+  EXPECT_EQ(stream.peek(1).get_type(), Token_Type::TT_EOF);
+}
+
+TEST(TokenStreamSuite, ReadsTokensFromAnArray) {
+  Error_Reporter e;
+  Source_File source(std::string("a + b"));
+  Scanner s(source, e);
+  Token_Array& tokens = s.scan_tokens();
+  Token_Stream<2> stream(std::span<const Token>(tokens.begin(), tokens.end()));
+
+  EXPECT_EQ(stream.peek(1).get_type(), Token_Type::TT_PLUS);
+  EXPECT_EQ(stream.advance().get_type(), Token_Type::TT_IDENTIFIER);
+  EXPECT_EQ(stream.advance().get_type(), Token_Type::TT_PLUS);
+  EXPECT_EQ(stream.advance().get_type(), Token_Type::TT_IDENTIFIER);
+
+  // The array's end of file token repeats once the array runs out.
+  for (int i = 0; i < 3; i++) {
+    Token eof = stream.advance();
+    EXPECT_EQ(eof.get_type(), Token_Type::TT_EOF);
+    EXPECT_EQ(eof.get_offset(), 5u);
+  }
+}
@@ -0,0 +1,82 @@
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#include "gtest/gtest.h"
+#include "source_file/source_file.hpp"
+
+// Writes contents to a new file in the temporary directory and returns its
+// path.
+static std::string write_temporary_file(const std::string& name,
+                                        const std::string& contents) {
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() /
+      ("jlox_in_cpp_" + std::to_string(getpid()) + "_" + name);
+  std::ofstream file(path, std::ios::binary);
+  file << contents;
+  return path.string();
+}
+
+TEST(SourceFileSuite, OpensRegularFiles) {
+  std::string contents = "print \"mapped\";\n";
+  std::string path = write_temporary_file("regular.lox", contents);
+
+  {
+    Source_File copy("");
+    {
+      Source_File source = Source_File::open(path);
+      EXPECT_EQ(source.get_name(), path);
+      copy = source;
+    }
+    // The mapping lives as long as any copy of the Source_File.
+    EXPECT_EQ(copy.get_contents(), contents);
+    EXPECT_EQ(copy.get_line(15), 1u);
+  }
+
+  std::filesystem::remove(path);
+}
+
+TEST(SourceFileSuite, OpensEmptyFiles) {
+  std::string path = write_temporary_file("empty.lox", "");
+  EXPECT_EQ(Source_File::open(path).get_contents(), "");
+  std::filesystem::remove(path);
+}
+
+TEST(SourceFileSuite, ReadsPipes) {
+  int fds[2];
+  ASSERT_EQ(pipe(fds), 0);
+
+  // More than the initial read buffer, so that the buffer has to grow.
+  std::string contents;
+  for (int i = 0; contents.size() < 200000; i++) {
+    contents += "var x" + std::to_string(i) + " = " + std::to_string(i) + ";\n";
+  }
+
+  std::thread writer([&]() {
+    std::size_t written = 0;
+    while (written < contents.size()) {
+      ssize_t count =
+          write(fds[1], contents.data() + written, contents.size() - written);
+      ASSERT_GT(count, 0);
+      written += (std::size_t)count;
+    }
+    close(fds[1]);
+  });
+
+  // Opening the pipe through /proc gives the same kind of file as stdin
+  // redirected from a pipe.
+  Source_File source =
+      Source_File::open("/proc/self/fd/" + std::to_string(fds[0]));
+  writer.join();
+  close(fds[0]);
+
+  EXPECT_EQ(source.get_contents(), contents);
+}
+
+TEST(SourceFileSuite, ReportsMissingFiles) {
+  EXPECT_THROW(Source_File::open("/nonexistent/file.lox"), std::system_error);
+}
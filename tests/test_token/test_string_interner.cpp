@@ -0,0 +1,80 @@
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "memory/arena.hpp"
+#include "token/string_interner.hpp"
+
+TEST(StringInternerSuite, InternsEachTextOnce) {
+  String_Interner symbols;
+  EXPECT_EQ(symbols.intern("count"), 0u);
+  EXPECT_EQ(symbols.intern("total"), 1u);
+  EXPECT_EQ(symbols.intern(std::string("count")), 0u);
+  EXPECT_EQ(symbols.intern(""), 2u);
+  EXPECT_EQ(symbols.intern(""), 2u);
+  EXPECT_EQ(symbols.get_size(), 3u);
+
+  EXPECT_EQ(symbols.get_string(1), "total");
+  EXPECT_EQ(symbols.get_string(2), "");
+  EXPECT_EQ(symbols.get_hash(0), String_Interner::hash("count"));
+  EXPECT_EQ(symbols.intern("total", String_Interner::hash("total")), 1u);
+
+  symbols.clear();
+  EXPECT_EQ(symbols.get_size(), 0u);
+  EXPECT_EQ(symbols.intern("total"), 0u);
+}
+
+TEST(StringInternerSuite, StoresOneCopyThatStaysPut) {
+  String_Interner symbols;
+  std::vector<std::string> texts;
+  std::vector<std::string_view> views;
+
+  // More than a block of texts, and one larger than a block.
+  for (int i = 0; i < 5000; i++) {
+    texts.push_back("name_" + std::to_string(i));
+  }
+  texts.push_back(std::string(100000, 'x'));
+  for (const std::string& text : texts) {
+    symbols.intern(text);
+  }
+  for (std::size_t i = 0; i < texts.size(); i++) {
+    views.push_back(symbols.get_string((uint32_t)i));
+    EXPECT_NE(views[i].data(), texts[i].data());
+  }
+
+  // Interning again returns the stored copy rather than making another.
+  for (const std::string& text : texts) {
+    std::string_view stored = symbols.get_string(symbols.intern(text));
+    EXPECT_EQ(stored.data(), views[symbols.intern(text)].data());
+  }
+
+  String_Interner copy(symbols);
+  String_Interner moved(std::move(symbols));
+  for (std::size_t i = 0; i < texts.size(); i++) {
+    EXPECT_EQ(moved.get_string((uint32_t)i).data(), views[i].data());
+    EXPECT_EQ(copy.get_string((uint32_t)i), texts[i]);
+    EXPECT_NE(copy.get_string((uint32_t)i).data(), views[i].data());
+    EXPECT_EQ(copy.intern(texts[i]), i);
+  }
+}
+
+TEST(StringInternerSuite, AllocatesFromMemoryResource) {
+  Arena arena;
+  Monotonic_Resource resource(arena);
+  String_Interner symbols(&resource);
+  for (int i = 0; i < 1000; i++) {
+    symbols.intern("symbol_" + std::to_string(i));
+  }
+  EXPECT_GE(arena.get_bytes_used(), 1000 * (sizeof(Interned_Text) + 8));
+
+  // Moving into an interner on another resource interns the texts again.
+  String_Interner other;
+  other = std::move(symbols);
+  EXPECT_EQ(other.get_size(), 1000u);
+  EXPECT_EQ(symbols.get_size(), 0u);
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_EQ(other.get_string(i), "symbol_" + std::to_string(i));
+  }
+}
@@ -0,0 +1,213 @@
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+#include "error_reporter/error_reporter.hpp"
+#include "gtest/gtest.h"
+#include "parser/ast_printer.hpp"
+#include "parser/parser.hpp"
+#include "scanner/scanner.hpp"
+#include "source_file/source_file.hpp"
+#include "token/token_cache.hpp"
+
+// Returns a path in the temporary directory for this process.
+static std::string temporary_path(const std::string& name) {
+  return (std::filesystem::temp_directory_path() /
+          ("jlox_in_cpp_" + std::to_string(getpid()) + "_" + name))
+      .string();
+}
+
+// Scans source and stores its tokens in the cache file at path.
+static void store(const std::string& path, const Source_File& source) {
+  Error_Reporter e;
+  Scanner s(source, e);
+  Token_Cache::store(path, source, s.scan_tokens(), s.get_literals(),
+                     s.get_symbols());
+}
+
+TEST(TokenCacheSuite, LoadsStoredTokens) {
+  Source_File source("var x = 1.5 + 2;\nprint \"cached\" + x;\n", "a.lox");
+  std::string path = temporary_path("stored.lxtc");
+  store(path, source);
+
+  Error_Reporter e;
+  Scanner s(source, e);
+  Token_Array& expected = s.scan_tokens();
+
+  Token_Cache cache;
+  ASSERT_TRUE(cache.load(path, source));
+  ASSERT_EQ(cache.end() - cache.begin(), expected.get_maximum_index() + 1);
+
+  int i = 0;
+  for (const Token& token : cache) {
+    EXPECT_EQ(token.get_type(), expected[i].get_type());
+    EXPECT_EQ(token.get_offset(), expected[i].get_offset());
+    EXPECT_EQ(token.get_length(), expected[i].get_length());
+    if (token.get_type() == Token_Type::TT_NUMBER) {
+      EXPECT_EQ(cache.get_literals().get_number(token.get_literal()),
+                s.get_literals().get_number(expected[i].get_literal()));
+    } else if ((token.get_type() == Token_Type::TT_IDENTIFIER) ||
+               (token.get_type() == Token_Type::TT_STRING)) {
+      EXPECT_EQ(cache.get_symbols().get_string(token.get_literal()),
+                s.get_symbols().get_string(expected[i].get_literal()));
+      EXPECT_EQ(cache.get_symbols().get_hash(token.get_literal()),
+                s.get_symbols().get_hash(expected[i].get_literal()));
+    }
+    i++;
+  }
+  EXPECT_EQ(cache.get_symbols().get_size(), s.get_symbols().get_size());
+
+  std::filesystem::remove(path);
+}
+
+TEST(TokenCacheSuite, ServesAsTheSymbolTable) {
+  // The cache numbers symbols as the scanner did, so a tree parsed from the
+  // source prints the same with either's symbols.
+  Source_File source("var name = \"text\"; print name + \"\" + other;");
+  std::string path = temporary_path("symbols.lxtc");
+  store(path, source);
+
+  Token_Cache cache;
+  ASSERT_TRUE(cache.load(path, source));
+
+  Error_Reporter e;
+  Parser parser(source, e);
+  Ast& ast = parser.parse();
+  const Symbol_Table& scanned = parser.get_symbols();
+  const Symbol_Table& cached = cache.get_symbols();
+  EXPECT_EQ(cached.get_size(), scanned.get_size());
+  EXPECT_EQ(Ast_Printer(ast, parser.get_literals(), cached)
+                .print(ast.get_root()),
+            Ast_Printer(ast, parser.get_literals(), scanned)
+                .print(ast.get_root()));
+
+  std::filesystem::remove(path);
+}
+
+TEST(TokenCacheSuite, StoresManyBlocksOfTokens) {
+  // More tokens than one block of records, with one left over.
+  std::string text;
+  for (int i = 0; i < 300; i++) {
+    text += "x = " + std::to_string(i) + ";\n";
+  }
+  Source_File source(text);
+  std::string path = temporary_path("blocks.lxtc");
+  store(path, source);
+
+  Error_Reporter e;
+  Scanner s(source, e);
+  Token_Array& expected = s.scan_tokens();
+
+  Token_Cache cache;
+  ASSERT_TRUE(cache.load(path, source));
+  ASSERT_EQ(cache.end() - cache.begin(), expected.get_maximum_index() + 1);
+  for (int i = 0; i <= expected.get_maximum_index(); i++) {
+    EXPECT_EQ(cache.begin()[i].get_offset(), expected[i].get_offset()) << i;
+  }
+
+  std::filesystem::remove(path);
+}
+
+TEST(TokenCacheSuite, ReportsWriteFailures) {
+  std::string path = temporary_path("missing_directory") + "/a.lxtc";
+  try {
+    store(path, Source_File("print 1;"));
+    ADD_FAILURE() << "The cache was written.";
+  } catch (const std::system_error& error) {
+    EXPECT_EQ(error.code(), std::make_error_code(std::errc::io_error));
+  }
+}
+
+TEST(TokenCacheSuite, MissesWhenTheSourceChanges) {
+  std::string path = temporary_path("stale.lxtc");
+  store(path, Source_File("print 1;"));
+
+  Token_Cache cache;
+  EXPECT_FALSE(cache.load(path, Source_File("print 2;")));
+  EXPECT_FALSE(cache.load(path, Source_File("print 1; ")));
+  EXPECT_TRUE(cache.load(path, Source_File("print 1;")));
+
+  std::filesystem::remove(path);
+}
+
+// Overwrites the little-endian uint32 or byte at offset in the file at path.
+static void patch(const std::string& path, std::size_t offset, uint32_t value,
+                  std::size_t size = 4) {
+  std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+  file.seekp(offset);
+  for (std::size_t i = 0; i < size; i++) {
+    file.put((char)(value >> (8 * i)));
+  }
+}
+
+TEST(TokenCacheSuite, MissesOnDamagedFiles) {
+  Source_File source("var answer = 42;");
+  std::string path = temporary_path("damaged.lxtc");
+  store(path, source);
+
+  Token_Cache cache;
+  EXPECT_FALSE(cache.load(temporary_path("missing.lxtc"), source));
+
+  // Cut off the last number.
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+  EXPECT_FALSE(cache.load(path, source));
+
+  std::ofstream(path, std::ios::binary) << "LXTC";
+  EXPECT_FALSE(cache.load(path, source));
+
+  // The tokens are var, answer, =, 42, ; and EOF; a token record is 16 bytes
+  // after the 64-byte header, with the type at 0, the offset at 4 and the
+  // literal at 12. The number 42 follows the tokens, then the record of the
+  // one symbol, answer, with its text's offset at 8.
+  const std::size_t NAME = 64 + 16;
+  const std::size_t NUMBER = 64 + (3 * 16);
+  const std::size_t SYMBOL = 64 + (6 * 16) + 8;
+  store(path, source);
+  ASSERT_TRUE(cache.load(path, source));
+
+  patch(path, NUMBER + 4, 1000);
+  EXPECT_FALSE(cache.load(path, source));
+  store(path, source);
+
+  patch(path, 64, 200, 1);
+  EXPECT_FALSE(cache.load(path, source));
+  store(path, source);
+
+  patch(path, NUMBER + 12, 0x80000000);
+  EXPECT_FALSE(cache.load(path, source));
+  patch(path, NUMBER + 12, 1);
+  EXPECT_FALSE(cache.load(path, source));
+  patch(path, NUMBER + 12, 0);
+  EXPECT_TRUE(cache.load(path, source));
+
+  patch(path, NAME + 12, 1);
+  EXPECT_FALSE(cache.load(path, source));
+  patch(path, NAME + 12, 0);
+  patch(path, SYMBOL + 8, 1);
+  EXPECT_FALSE(cache.load(path, source));
+  patch(path, SYMBOL + 8, 0);
+  EXPECT_TRUE(cache.load(path, source));
+  EXPECT_EQ(cache.get_symbols().get_string(0), "answer");
+
+  // Hashes from a build that hashes symbols differently can't be used.
+  patch(path, 12, 0);
+  EXPECT_FALSE(cache.load(path, source));
+
+  std::filesystem::remove(path);
+}
+
+TEST(TokenCacheSuite, PathsDependOnTheDirectory) {
+  Source_File source("print 1;", "script.lox");
+  EXPECT_EQ(Token_Cache::path_for(source, ""), "script.lox.lxtc");
+
+  std::string path = Token_Cache::path_for(source, "cache");
+  EXPECT_EQ(path.size(), 6u + 16 + 5);
+  EXPECT_TRUE(path.starts_with("cache/"));
+  EXPECT_EQ(Token_Cache::content_hash("print 1;"),
+            Token_Cache::content_hash(std::string("print 1;")));
+  EXPECT_NE(Token_Cache::content_hash("print 1;"),
+            Token_Cache::content_hash("print 2;"));
+}
@@ -0,0 +1,78 @@
+#include <stdio.h>
+
+#include <bit>
+#include <cstring>
+#include <string>
+
+#include "error_reporter/error_reporter.hpp"
+#include "gtest/gtest.h"
+#include "scanner/scanner.hpp"
+#include "source_file/source_file.hpp"
+#include "token/token_dump.hpp"
+
+// Dumps the tokens of text in the given format and returns the output.
+static std::string dump(const std::string& text, Token_Dump::Format format) {
+  FILE* file = tmpfile();
+  Error_Reporter e;
+  Source_File source(text);
+  Scanner s(source, e);
+  {
+    Token_Dump dump(fileno(file), format);
+    for (const Token& token : s) {
+      dump.write(token, source.get_contents(), s.get_literals());
+    }
+  }
+
+  std::string output(ftell(file), '\0');
+  rewind(file);
+  EXPECT_EQ(fread(output.data(), 1, output.size(), file), output.size());
+  fclose(file);
+  return output;
+}
+
+static uint32_t read_u32(const std::string& bytes, std::size_t offset) {
+  uint32_t value = 0;
+  for (int i = 0; i < 4; i++) {
+    value |= (uint32_t)(unsigned char)bytes[offset + i] << (8 * i);
+  }
+  return value;
+}
+
+TEST(TokenDumpSuite, TextMatchesToString) {
+  // The long string doesn't fit in the buffer.
+  std::string text = "var x = 1.5; print \"" + std::string(100000, 's') + "\";";
+
+  Error_Reporter e;
+  Source_File source(text);
+  Scanner s(source, e);
+  std::string expected;
+  for (const Token& token : s.scan_tokens()) {
+    expected += token.to_string(source.get_contents()) + "\n";
+  }
+
+  EXPECT_EQ(dump(text, Token_Dump::Format::TEXT), expected);
+}
+
+TEST(TokenDumpSuite, WritesBinaryRecords) {
+  std::string output = dump("x 2.5", Token_Dump::Format::BINARY);
+
+  ASSERT_EQ(output.size(), 5u + (9 + 1) + (9 + 3 + 8) + 9);
+  EXPECT_EQ(output.substr(0, 5), std::string("LXTK\x01", 5));
+
+  EXPECT_EQ(output[5], (char)Token_Type::TT_IDENTIFIER);
+  EXPECT_EQ(read_u32(output, 6), 0u);
+  EXPECT_EQ(read_u32(output, 10), 1u);
+  EXPECT_EQ(output[14], 'x');
+
+  EXPECT_EQ(output[15], (char)Token_Type::TT_NUMBER);
+  EXPECT_EQ(read_u32(output, 16), 2u);
+  EXPECT_EQ(read_u32(output, 20), 3u);
+  EXPECT_EQ(output.substr(24, 3), "2.5");
+  uint64_t bits = (uint64_t)read_u32(output, 27) |
+                  ((uint64_t)read_u32(output, 31) << 32);
+  EXPECT_EQ(std::bit_cast<double>(bits), 2.5);
+
+  EXPECT_EQ(output[35], (char)Token_Type::TT_EOF);
+  EXPECT_EQ(read_u32(output, 36), 5u);
+  EXPECT_EQ(read_u32(output, 40), 0u);
+}
@@ -0,0 +1,100 @@
+#include <string>
+
+#include "error_reporter/error_reporter.hpp"
+#include "gtest/gtest.h"
+#include "source_file/source_file.hpp"
+#include "vm/chunk.hpp"
+#include "vm/disassembler.hpp"
+#include "vm/vm.hpp"
+
+TEST(ChunkSuite, RunLengthEncodesLines) {
+  Chunk chunk;
+  EXPECT_EQ(chunk.get_size(), 0u);
+
+  // Lines 1, 1, 1, 3, 3, 7, 1.
+  uint32_t lines[] = {1, 1, 1, 3, 3, 7, 1};
+  for (uint32_t line : lines) {
+    chunk.write((uint8_t)Op_Code::OP_NIL, line);
+  }
+
+  ASSERT_EQ(chunk.get_size(), 7u);
+  for (std::size_t offset = 0; offset < 7; offset++) {
+    EXPECT_EQ(chunk.get_line(offset), lines[offset]) << offset;
+  }
+
+  chunk.patch(6, (uint8_t)Op_Code::OP_RETURN);
+  EXPECT_EQ(chunk.get_byte(6), (uint8_t)Op_Code::OP_RETURN);
+  EXPECT_EQ(chunk.get_line(6), 1u);
+}
+
+TEST(ChunkSuite, StoresConstants) {
+  Chunk chunk;
+  EXPECT_EQ(chunk.add_constant(Value::number(1.5)), 0u);
+  EXPECT_EQ(chunk.add_constant(Value::boolean(true)), 1u);
+
+  ASSERT_EQ(chunk.get_constant_count(), 2u);
+  EXPECT_EQ(chunk.get_constant(0).get_number(), 1.5);
+  EXPECT_TRUE(chunk.get_constants()[1] == Value::boolean(true));
+}
+
+TEST(ChunkSuite, NamesOpCodes) {
+  EXPECT_EQ(op_code_to_str(Op_Code::OP_CONSTANT), "OP_CONSTANT");
+  EXPECT_EQ(op_code_to_str(Op_Code::OP_METHOD), "OP_METHOD");
+  EXPECT_EQ(op_code_format(Op_Code::OP_LOOP), Operand_Format::LOOP);
+  EXPECT_EQ(op_code_stack_effect(Op_Code::OP_ADD), -1);
+}
+
+TEST(DisassemblerSuite, PrintsInstructions) {
+  VM vm;
+  Error_Reporter e;
+  std::string out;
+  ASSERT_TRUE(vm.disassemble(
+      Source_File("var a = 1;\nif (a > 2)\n  print a;\n"
+                  "fun f(x) { fun g() { return x; } return g; }\n"),
+      e, out));
+
+  EXPECT_EQ(out,
+            "== <script> ==\n"
+            "0000    1 OP_CONSTANT         0 '1'\n"
+            "0003    | OP_DEFINE_GLOBAL    1\n"
+            "0006    2 OP_GET_GLOBAL       1\n"
+            "0009    | OP_CONSTANT         1 '2'\n"
+            "0012    | OP_GREATER\n"
+            "0013    | OP_JUMP_IF_FALSE   13 -> 24\n"
+            "0016    | OP_POP\n"
+            "0017    3 OP_GET_GLOBAL       1\n"
+            "0020    | OP_PRINT\n"
+            "0021    2 OP_JUMP            21 -> 25\n"
+            "0024    | OP_POP\n"
+            "0025    4 OP_CLOSURE          2 '<fn f>'\n"
+            "0028    | OP_DEFINE_GLOBAL    2\n"
+            "0031    5 OP_NIL\n"
+            "0032    | OP_RETURN\n"
+            "\n"
+            "== f ==\n"
+            "0000    4 OP_CLOSURE          0 '<fn g>'\n"
+            "0003    |                local 1\n"
+            "0005    | OP_GET_LOCAL        2\n"
+            "0007    | OP_RETURN\n"
+            "0008    | OP_NIL\n"
+            "0009    | OP_RETURN\n"
+            "\n"
+            "== g ==\n"
+            "0000    4 OP_GET_UPVALUE      0\n"
+            "0002    | OP_RETURN\n"
+            "0003    | OP_NIL\n"
+            "0004    | OP_RETURN\n");
+}
+
+TEST(DisassemblerSuite, ReportsCompileErrors) {
+  VM vm;
+  Error_Reporter e;
+  std::string out;
+
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(vm.disassemble(Source_File("print this;"), e, out));
+  EXPECT_EQ(testing::internal::GetCapturedStderr(),
+            "[line 1] Error at 'this': Can't use 'this' outside of a class.\n");
+  EXPECT_TRUE(e.had_error);
+  EXPECT_EQ(out, "");
+}
@@ -0,0 +1,127 @@
+#include <cmath>
+#include <limits>
+#include <string>
+
+#include "gtest/gtest.h"
+#include "token/literal_table.hpp"
+#include "vm/object.hpp"
+#include "vm/value.hpp"
+
+TEST(ValueSuite, RoundTripsEveryType) {
+  EXPECT_EQ(Value().get_type(), Value_Type::VT_NIL);
+  EXPECT_TRUE(Value::nil().is_nil());
+  EXPECT_TRUE(Value::undefined().is_undefined());
+  EXPECT_EQ(Value::undefined().get_type(), Value_Type::VT_UNDEFINED);
+
+  for (bool b : {false, true}) {
+    Value v = Value::boolean(b);
+    EXPECT_EQ(v.get_type(), Value_Type::VT_BOOL);
+    EXPECT_TRUE(v.is_bool());
+    EXPECT_FALSE(v.is_number());
+    EXPECT_EQ(v.get_bool(), b);
+  }
+
+  double numbers[] = {0.0,
+                      -0.0,
+                      1.5,
+                      -1e308,
+                      std::numeric_limits<double>::denorm_min(),
+                      std::numeric_limits<double>::infinity(),
+                      -std::numeric_limits<double>::infinity()};
+  for (double d : numbers) {
+    Value v = Value::number(d);
+    EXPECT_EQ(v.get_type(), Value_Type::VT_NUMBER) << d;
+    EXPECT_FALSE(v.is_nil() || v.is_bool() || v.is_object());
+    EXPECT_EQ(v.get_number(), d);
+    EXPECT_EQ(std::signbit(v.get_number()), std::signbit(d));
+  }
+
+  // NaN, as 0/0 produces it, is still a number.
+  double zero = 0;
+  Value nan = Value::number(zero / zero);
+  EXPECT_TRUE(nan.is_number());
+  EXPECT_TRUE(std::isnan(nan.get_number()));
+
+  Obj object{};
+  Value v = Value::object(&object);
+  EXPECT_EQ(v.get_type(), Value_Type::VT_OBJECT);
+  EXPECT_TRUE(v.is_object());
+  EXPECT_FALSE(v.is_number());
+  EXPECT_EQ(v.get_object(), &object);
+}
+
+TEST(ValueSuite, ComparesLikeLox) {
+  EXPECT_TRUE(Value::nil() == Value::nil());
+  EXPECT_TRUE(Value::boolean(true) == Value::boolean(true));
+  EXPECT_FALSE(Value::boolean(true) == Value::boolean(false));
+  EXPECT_TRUE(Value::number(2) == Value::number(2));
+  EXPECT_TRUE(Value::number(0.0) == Value::number(-0.0));
+
+  double zero = 0;
+  Value nan = Value::number(zero / zero);
+  EXPECT_FALSE(nan == nan);
+
+  // Values of different types are never equal.
+  EXPECT_FALSE(Value::nil() == Value::boolean(false));
+  EXPECT_FALSE(Value::number(0) == Value::boolean(false));
+  EXPECT_FALSE(Value::number(0) == Value::nil());
+
+  Obj a{};
+  Obj b{};
+  EXPECT_TRUE(Value::object(&a) == Value::object(&a));
+  EXPECT_FALSE(Value::object(&a) == Value::object(&b));
+}
+
+TEST(ValueSuite, IsFalseyOnlyForNilAndFalse) {
+  EXPECT_TRUE(Value::nil().is_falsey());
+  EXPECT_TRUE(Value::boolean(false).is_falsey());
+  EXPECT_FALSE(Value::boolean(true).is_falsey());
+  EXPECT_FALSE(Value::number(0).is_falsey());
+
+  Obj object{};
+  EXPECT_FALSE(Value::object(&object).is_falsey());
+}
+
+TEST(ValueSuite, FitsInEightBytesUnlessTagged) {
+#if defined(LOX_TAGGED_VALUES)
+  EXPECT_EQ(sizeof(Value), 16u);
+#else
+  EXPECT_EQ(sizeof(Value), 8u);
+#endif
+}
+
+TEST(ValueSuite, PrintsNumbers) {
+  auto print = [](Value value) {
+    std::string out;
+    write_value(value, out);
+    return out;
+  };
+
+  EXPECT_EQ(print(Value::number(3)), "3");
+  EXPECT_EQ(print(Value::number(-0.0)), "-0");
+  EXPECT_EQ(print(Value::number(0.1)), "0.1");
+  EXPECT_EQ(print(Value::number(1e300)), "1e+300");
+  EXPECT_EQ(print(Value::number(-std::numeric_limits<double>::infinity())),
+            "-inf");
+
+  // NaN prints the same whichever sign it has.
+  double nan = std::numeric_limits<double>::quiet_NaN();
+  EXPECT_EQ(print(Value::number(nan)), "nan");
+  EXPECT_EQ(print(Value::number(-nan)), "nan");
+  EXPECT_EQ(print(Value::nil()), "nil");
+}
+
+TEST(ValueSuite, LiteralTableHoldsValues) {
+  Literal_Table literals;
+  EXPECT_EQ(literals.add_number(1.5), 0u);
+  EXPECT_EQ(literals.add_number(-0.0), 1u);
+  ASSERT_EQ(literals.get_size(), 2u);
+
+  EXPECT_TRUE(literals.get(0) == Value::number(1.5));
+  EXPECT_TRUE(literals.get(1).is_number());
+  EXPECT_TRUE(std::signbit(literals.get_number(1)));
+
+  std::string out;
+  write_value(literals.get(0), out);
+  EXPECT_EQ(out, "1.5");
+}
@@ -0,0 +1,300 @@
+#include <span>
+#include <sstream>
+#include <string>
+
+#include "error_reporter/error_reporter.hpp"
+#include "gtest/gtest.h"
+#include "scanner/scanner.hpp"
+#include "source_file/source_file.hpp"
+#include "vm/vm.hpp"
+
+// Runs text on vm, which must succeed, and returns what it printed.
+static std::string run(VM& vm, std::ostringstream& out,
+                       const std::string& text) {
+  Error_Reporter e;
+  out.str("");
+  EXPECT_EQ(vm.interpret(Source_File(text), e), Interpret_Result::IR_OK)
+      << text;
+  return out.str();
+}
+
+static std::string run(const std::string& text) {
+  std::ostringstream out;
+  VM vm(out);
+  return run(vm, out, text);
+}
+
+// Runs text, which must fail with result, and returns the errors reported.
+static std::string run_errors(const std::string& text,
+                              Interpret_Result result) {
+  std::ostringstream out;
+  VM vm(out);
+  Error_Reporter e;
+
+  testing::internal::CaptureStderr();
+  EXPECT_EQ(vm.interpret(Source_File(text), e), result) << text;
+  return testing::internal::GetCapturedStderr();
+}
+
+TEST(VmSuite, EvaluatesExpressions) {
+  EXPECT_EQ(run("print 1 + 2 * 3 - 4 / 8;"), "6.5\n");
+  EXPECT_EQ(run("print -(1 + 2);"), "-3\n");
+  EXPECT_EQ(run("print 1 / 3;"), "0.3333333333333333\n");
+  EXPECT_EQ(run("print 0 / 0; print -(0 / 0);"), "nan\nnan\n");
+  EXPECT_EQ(run("print \"ab\" + \"cd\";"), "abcd\n");
+  EXPECT_EQ(run("print \"\" + \"\"; print \"\" == \"\";"), "\ntrue\n");
+  EXPECT_EQ(run("print 1 < 2; print 2 <= 1; print 3 > 3; print 3 >= 3;"),
+            "true\nfalse\nfalse\ntrue\n");
+  EXPECT_EQ(run("print 1 == 1; print \"a\" + \"b\" == \"ab\"; print nil != "
+                "false;"),
+            "true\ntrue\ntrue\n");
+  EXPECT_EQ(run("print !nil; print !0; print nil or \"x\"; print 1 and 2;"),
+            "true\nfalse\nx\n2\n");
+  EXPECT_EQ(run("print false and 1; print 1 or 2;"), "false\n1\n");
+}
+
+TEST(VmSuite, ScopesVariables) {
+  EXPECT_EQ(run("var a = 1; { var a = 2; { var a = 3; print a; } print a; } "
+                "print a;"),
+            "3\n2\n1\n");
+  EXPECT_EQ(run("var a; print a; a = 4; print a; print a = 5;"),
+            "nil\n4\n5\n");
+  EXPECT_EQ(run("for (var i = 0; i < 3; i = i + 1) print i;"), "0\n1\n2\n");
+  EXPECT_EQ(run("var i = 0; while (i < 2) { print i; i = i + 1; }"),
+            "0\n1\n");
+  EXPECT_EQ(run("if (nil) print 1; else print 2; if (0) print 3;"), "2\n3\n");
+}
+
+TEST(VmSuite, CallsFunctionsAndClosures) {
+  EXPECT_EQ(run("fun fib(n) { if (n < 2) return n; "
+                "return fib(n - 2) + fib(n - 1); } print fib(20);"),
+            "6765\n");
+  EXPECT_EQ(run("fun f() {} print f(); print f; print clock;"),
+            "nil\n<fn f>\n<native fn>\n");
+
+  // Closures share the variables they capture, which outlive their scope.
+  EXPECT_EQ(run("var get; var set;"
+                "{ var x = 1; fun g() { return x; } fun s(v) { x = v; }"
+                "  get = g; set = s; }"
+                "set(7); print get();"),
+            "7\n");
+  EXPECT_EQ(run("fun counter() { var n = 0; fun inc() { n = n + 1; return n; }"
+                " return inc; }"
+                "var a = counter(); var b = counter(); a(); a();"
+                "print a(); print b();"),
+            "3\n1\n");
+
+  // Variables with the same name in sibling scopes are captured separately.
+  EXPECT_EQ(run("{ var f1; var f2;"
+                "  { var j = 1; fun f() { return j; } f1 = f; }"
+                "  { var j = 2; fun f() { return j; } f2 = f; }"
+                "  print f1() + f2(); }"),
+            "3\n");
+}
+
+TEST(VmSuite, RunsClasses) {
+  EXPECT_EQ(run("class A { init(n) { this.n = n; } get() { return this.n; } }"
+                "var a = A(3); print a.get(); print a.n; print A; print a;"),
+            "3\n3\nA\nA instance\n");
+
+  // Methods are bound to their receiver.
+  EXPECT_EQ(run("class A { init() { this.x = 1; } m() { return this.x; } }"
+                "var m = A().m; print m();"),
+            "1\n");
+
+  // Fields shadow methods, and fields holding functions can be called.
+  EXPECT_EQ(run("fun f() { return 2; } class A { m() { return 1; } }"
+                "var a = A(); a.m = f; print a.m();"),
+            "2\n");
+
+  EXPECT_EQ(run("class A { m() { return \"A\"; } n() { return \"n\"; } }"
+                "class B < A { m() { return \"B\" + super.m(); } }"
+                "class C < B { m() { var s = super.m; return \"C\" + s(); } }"
+                "print C().m(); print C().n();"),
+            "CBA\nn\n");
+
+  // An initializer returns its instance, even when called again.
+  EXPECT_EQ(run("class A { init() { this.x = 1; return; } }"
+                "var a = A(); print a.init() == a;"),
+            "true\n");
+}
+
+TEST(VmSuite, KeepsGlobalsAcrossRuns) {
+  std::ostringstream out;
+  VM vm(out);
+  EXPECT_EQ(run(vm, out, "var a = 1; fun f() { return a + b; }"), "");
+  EXPECT_EQ(run(vm, out, "var b = 2; print f();"), "3\n");
+}
+
+TEST(VmSuite, RunsScannedTokens) {
+  std::ostringstream out;
+  VM vm(out);
+  Error_Reporter e;
+  Source_File source(std::string(
+      "var greeting = \"hi\"; fun f(n) { return n * 2; } "
+      "print greeting; print f(21);"));
+  Scanner s(source, e);
+  Token_Array& tokens = s.scan_tokens();
+
+  EXPECT_EQ(vm.interpret(source,
+                         std::span<const Token>(tokens.begin(), tokens.end()),
+                         s.get_literals(), s.get_symbols(), e),
+            Interpret_Result::IR_OK);
+  EXPECT_EQ(out.str(), "hi\n42\n");
+
+  // Globals declared from tokens are kept like any other.
+  EXPECT_EQ(run(vm, out, "print greeting;"), "hi\n");
+}
+
+TEST(VmSuite, ReportsCompileErrors) {
+  EXPECT_EQ(run_errors("return 1;", Interpret_Result::IR_COMPILE_ERROR),
+            "[line 1] Error at 'return': Can't return from top-level "
+            "code.\n");
+  EXPECT_EQ(run_errors("class A { init() { return 1; } }",
+                       Interpret_Result::IR_COMPILE_ERROR),
+            "[line 1] Error at 'return': Can't return a value from an "
+            "initializer.\n");
+  EXPECT_EQ(run_errors("{ var a = 1;\nvar a = 2; }",
+                       Interpret_Result::IR_COMPILE_ERROR),
+            "[line 2] Error at 'a': Already a variable with this name in this "
+            "scope.\n");
+  EXPECT_EQ(run_errors("{ var a = a; }", Interpret_Result::IR_COMPILE_ERROR),
+            "[line 1] Error at 'a': Can't read local variable in its own "
+            "initializer.\n");
+  EXPECT_EQ(run_errors("class A < A {}", Interpret_Result::IR_COMPILE_ERROR),
+            "[line 1] Error at 'A': A class can't inherit from itself.\n");
+  EXPECT_EQ(run_errors("class A { m() { super.m(); } }",
+                       Interpret_Result::IR_COMPILE_ERROR),
+            "[line 1] Error at 'super': Can't use 'super' in a class with no "
+            "superclass.\n");
+  EXPECT_EQ(run_errors("print super.x;", Interpret_Result::IR_COMPILE_ERROR),
+            "[line 1] Error at 'super': Can't use 'super' outside of a "
+            "class.\n");
+
+  // Syntax errors are reported by the parser and nothing is compiled.
+  EXPECT_EQ(run_errors("print 1", Interpret_Result::IR_COMPILE_ERROR),
+            "[line 1] Error at end: Expect ';' after value.\n");
+
+  std::string locals = "fun f() {";
+  for (int i = 0; i < 256; i++) {
+    locals += " var v" + std::to_string(i) + ";";
+  }
+  EXPECT_EQ(run_errors(locals + " }", Interpret_Result::IR_COMPILE_ERROR),
+            "[line 1] Error at 'v255': Too many local variables in "
+            "function.\n");
+}
+
+TEST(VmSuite, CompilesLongChains) {
+  // Chains are as deep as they are long; up to the parser's nesting limit
+  // they compile and run, and past it they are a compile error rather than a
+  // stack overflow in the compiler.
+  std::string sum = "print 0";
+  std::string calls = "fun f() { return f; } print f";
+  for (int i = 0; i < 4000; i++) {
+    sum += " + 1";
+    calls += "()";
+  }
+  EXPECT_EQ(run(sum + ";"), "4000\n");
+  EXPECT_EQ(run(calls + ";"), "<fn f>\n");
+
+  std::string flat = "print 0";
+  for (int i = 0; i < 200000; i++) {
+    flat += " + 1";
+  }
+  std::string errors =
+      run_errors(flat + ";", Interpret_Result::IR_COMPILE_ERROR);
+  EXPECT_NE(errors.find("Too much nesting."), std::string::npos);
+}
+
+TEST(VmSuite, ReportsRuntimeErrors) {
+  EXPECT_EQ(run_errors("fun f() { g(); }\nfun g() {\n  return 1 + nil;\n}\n"
+                       "f();",
+                       Interpret_Result::IR_RUNTIME_ERROR),
+            "Operands must be two numbers or two strings.\n"
+            "[line 3] in g()\n[line 1] in f()\n[line 5] in script\n");
+  EXPECT_EQ(run_errors("print -\"a\";", Interpret_Result::IR_RUNTIME_ERROR),
+            "Operand must be a number.\n[line 1] in script\n");
+  EXPECT_EQ(run_errors("print x;", Interpret_Result::IR_RUNTIME_ERROR),
+            "Undefined variable 'x'.\n[line 1] in script\n");
+  EXPECT_EQ(run_errors("x = 1;", Interpret_Result::IR_RUNTIME_ERROR),
+            "Undefined variable 'x'.\n[line 1] in script\n");
+  EXPECT_EQ(run_errors("fun f(a) {} f();", Interpret_Result::IR_RUNTIME_ERROR),
+            "Expected 1 arguments but got 0.\n[line 1] in script\n");
+  EXPECT_EQ(run_errors("class A {} A(1);", Interpret_Result::IR_RUNTIME_ERROR),
+            "Expected 0 arguments but got 1.\n[line 1] in script\n");
+  EXPECT_EQ(run_errors("\"a\"();", Interpret_Result::IR_RUNTIME_ERROR),
+            "Can only call functions and classes.\n[line 1] in script\n");
+  EXPECT_EQ(run_errors("class A {} print A().x;",
+                       Interpret_Result::IR_RUNTIME_ERROR),
+            "Undefined property 'x'.\n[line 1] in script\n");
+  EXPECT_EQ(run_errors("var a = 1; a.x = 2;",
+                       Interpret_Result::IR_RUNTIME_ERROR),
+            "Only instances have fields.\n[line 1] in script\n");
+  EXPECT_EQ(run_errors("var A = 1; class B < A {}",
+                       Interpret_Result::IR_RUNTIME_ERROR),
+            "Superclass must be a class.\n[line 1] in script\n");
+}
+
+TEST(VmSuite, LimitsTheStack) {
+  std::string errors = run_errors("fun f() { f(); } f();",
+                                  Interpret_Result::IR_RUNTIME_ERROR);
+  EXPECT_EQ(errors.substr(0, 16), "Stack overflow.\n");
+
+  // A frame that needs more of the stack than is left is refused before it
+  // runs, however few frames there are.
+  std::string arguments = "0";
+  for (int i = 1; i < 200; i++) {
+    arguments += ", " + std::to_string(i);
+  }
+  std::string nested = "nil";
+  for (int i = 0; i < 400; i++) {
+    nested = "g(" + arguments + ", " + nested + ")";
+  }
+  std::string program = "fun g(" + std::string("a0");
+  for (int i = 1; i <= 200; i++) {
+    program += ", a" + std::to_string(i);
+  }
+  program += ") { return nil; } fun f() { return " + nested + "; } f();";
+
+  errors = run_errors(program, Interpret_Result::IR_RUNTIME_ERROR);
+  EXPECT_EQ(errors.substr(0, 16), "Stack overflow.\n");
+
+  // The VM can run again after an error.
+  std::ostringstream out;
+  VM vm(out);
+  Error_Reporter e;
+  testing::internal::CaptureStderr();
+  EXPECT_EQ(vm.interpret(Source_File("fun f() { f(); } f();"), e),
+            Interpret_Result::IR_RUNTIME_ERROR);
+  testing::internal::GetCapturedStderr();
+  EXPECT_TRUE(e.had_runtime_error);
+  EXPECT_EQ(run(vm, out, "print 1;"), "1\n");
+}
+
+TEST(VmSuite, CollectsGarbage) {
+  // With a collection before every allocation, anything the VM fails to keep
+  // reachable is freed while still in use, which the sanitizers catch.
+  std::ostringstream out;
+  VM vm(out);
+  vm.set_stress_collection(true);
+  EXPECT_EQ(run(vm, out,
+                "class Object {}"
+                "class A < Object { init(n) { this.n = n; }"
+                "  add(o) { return A(this.n + o.n); } }"
+                "fun make(s) { var t = s + \"!\"; fun f() { return t + s; }"
+                "  return f; }"
+                "var total = A(0);"
+                "for (var i = 0; i < 50; i = i + 1) {"
+                "  total = total.add(A(i)); var f = make(\"x\"); f(); }"
+                "print total.n; print make(\"a\")();"),
+            "1225\na!a\n");
+  vm.set_stress_collection(false);
+
+  // Garbage is freed as the program runs, so the heap stays small.
+  EXPECT_EQ(run(vm, out,
+                "var s = \"\"; for (var i = 0; i < 20000; i = i + 1) {"
+                "  s = \"abcdefghijklmnopqrstuvwxyz\" + s;"
+                "  if (i - (i / 100) * 100 == 0) s = \"\"; }"),
+            "");
+  EXPECT_LT(vm.get_bytes_allocated(), (std::size_t)(4 << 20));
+}
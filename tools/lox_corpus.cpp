@@ -0,0 +1,185 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "corpus/corpus_generator.hpp"
+
+/*******************************************************************************
+Writes a synthetic Lox corpus made by Corpus_Generator to a file or to standard
+output, e.g.
+
+  lox_corpus --seed=7 --size=2G big.lox
+  lox_corpus --mix=comments=0,strings=10,max_depth=12 --size=64M
+  lox_corpus --shape=long-string --size=100M huge_string.lox
+
+--size is the approximate number of bytes of a program, the length of the
+string of long-string, the number of tokens of one-char-tokens and the depth of
+deep-nesting. Sizes take a K, M or G suffix for powers of 1024.
+*******************************************************************************/
+
+static constexpr std::string_view USAGE =
+    "Usage: lox_corpus [--seed=N] [--size=N[K|M|G]] "
+    "[--shape=program|long-string|one-char-tokens|deep-nesting] "
+    "[--mix=name=weight,...] [filename]";
+
+// Parses a number with an optional K, M or G suffix; throws
+// std::invalid_argument if text isn't one.
+static uint64_t parse_size(std::string_view text) {
+  uint64_t value = 0;
+  auto [end, error] =
+      std::from_chars(text.data(), text.data() + text.size(), value);
+  if ((error != std::errc()) || (end == text.data())) {
+    throw std::invalid_argument("Not a number: " + std::string(text));
+  }
+
+  std::string_view suffix(end, text.data() + text.size() - end);
+  if (suffix == "K") {
+    value <<= 10;
+  } else if (suffix == "M") {
+    value <<= 20;
+  } else if (suffix == "G") {
+    value <<= 30;
+  } else if (!suffix.empty()) {
+    throw std::invalid_argument("Not a size: " + std::string(text));
+  }
+  return value;
+}
+
+// Applies a comma-separated list of name=value pairs to mix.
+static void parse_mix(std::string_view text, Corpus_Generator::Mix& mix) {
+  while (!text.empty()) {
+    std::string_view pair = text.substr(0, text.find(','));
+    text.remove_prefix(std::min(text.size(), pair.size() + 1));
+
+    std::size_t equals = pair.find('=');
+    if (equals == std::string_view::npos) {
+      throw std::invalid_argument("Expected name=value: " + std::string(pair));
+    }
+    std::string_view name = pair.substr(0, equals);
+    uint32_t value = parse_size(pair.substr(equals + 1));
+
+    if (name == "declarations") {
+      mix.declarations = value;
+    } else if (name == "prints") {
+      mix.prints = value;
+    } else if (name == "expressions") {
+      mix.expressions = value;
+    } else if (name == "control_flow") {
+      mix.control_flow = value;
+    } else if (name == "functions") {
+      mix.functions = value;
+    } else if (name == "comments") {
+      mix.comments = value;
+    } else if (name == "identifiers") {
+      mix.identifiers = value;
+    } else if (name == "numbers") {
+      mix.numbers = value;
+    } else if (name == "strings") {
+      mix.strings = value;
+    } else if (name == "multi_line_strings") {
+      mix.multi_line_strings = value;
+    } else if (name == "literals") {
+      mix.literals = value;
+    } else if (name == "max_operands") {
+      mix.max_operands = value;
+    } else if (name == "max_depth") {
+      mix.max_depth = value;
+    } else {
+      throw std::invalid_argument("Unknown mix entry: " + std::string(name));
+    }
+  }
+}
+
+static void write_all(int fd, std::string_view text) {
+  while (!text.empty()) {
+    ssize_t written = ::write(fd, text.data(), text.size());
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::system_error(errno, std::generic_category(),
+                              "Could not write corpus");
+    }
+    text.remove_prefix(written);
+  }
+}
+
+int main(int argc, char** argv) {
+  uint64_t seed = 1;
+  uint64_t size = 1 << 20;
+  std::string_view shape = "program";
+  Corpus_Generator::Mix mix;
+
+  int first_argument = 1;
+  try {
+    while ((first_argument < argc) &&
+           (std::string_view(argv[first_argument]).starts_with("--"))) {
+      std::string_view option(argv[first_argument]);
+      if (option.starts_with("--seed=")) {
+        seed = parse_size(option.substr(7));
+      } else if (option.starts_with("--size=")) {
+        size = parse_size(option.substr(7));
+      } else if (option.starts_with("--shape=")) {
+        shape = option.substr(8);
+      } else if (option.starts_with("--mix=")) {
+        parse_mix(option.substr(6), mix);
+      } else {
+        throw std::invalid_argument("Unknown option " + std::string(option));
+      }
+      first_argument++;
+    }
+  } catch (const std::invalid_argument& error) {
+    std::cerr << error.what() << std::endl << USAGE << std::endl;
+    return 64;
+  }
+
+  if (argc - first_argument > 1) {
+    std::cerr << USAGE << std::endl;
+    return 64;
+  }
+
+  int fd = STDOUT_FILENO;
+  if (argc - first_argument == 1) {
+    fd = ::open(argv[first_argument], O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+      std::cerr << "Could not open " << argv[first_argument] << std::endl;
+      return 73;
+    }
+  }
+
+  try {
+    if (shape == "program") {
+      Corpus_Generator(seed, mix).write(fd, size);
+    } else if (shape == "long-string") {
+      write_all(fd, Corpus_Generator::long_string(size));
+    } else if (shape == "one-char-tokens") {
+      write_all(fd, Corpus_Generator::one_char_tokens(size));
+    } else if (shape == "deep-nesting") {
+      write_all(fd, Corpus_Generator::deep_nesting(size));
+    } else {
+      std::cerr << "Unknown shape " << shape << std::endl << USAGE << std::endl;
+      return 64;
+    }
+  } catch (const std::invalid_argument& error) {
+    std::cerr << error.what() << std::endl;
+    return 64;
+  } catch (const std::system_error& error) {
+    std::cerr << error.what() << std::endl;
+    return 74;
+  }
+
+  if ((fd != STDOUT_FILENO) && (::close(fd) != 0)) {
+    std::cerr << "Could not write " << argv[first_argument] << std::endl;
+    return 74;
+  }
+
+  return 0;
+}